@@ -0,0 +1,49 @@
+#shader vertex
+#version 330 core
+layout( location = 0 ) in vec4 position;
+layout( location = 1 ) in vec2 texCoord;
+layout( location = 2 ) in uint texIndex;
+
+out vec2 v_TexCoord;
+flat out int v_TexIndex;
+
+uniform mat4 u_MVP;
+
+void main()
+{
+	gl_Position = u_MVP * position;
+	v_TexCoord = texCoord;
+	v_TexIndex = int( texIndex );
+}
+
+#shader fragment
+#version 330 core
+#ifdef BINDLESS
+#extension GL_ARB_bindless_texture : require
+#endif
+
+layout( location = 0 ) out vec4 color;
+
+in vec2 v_TexCoord;
+flat in int v_TexIndex;
+
+#ifdef BINDLESS
+// Two 64-bit handles per element, see TextureTable.
+layout( std140 ) uniform TextureHandles
+{
+	uvec4 u_Handles[MAX_TEXTURES / 2];
+};
+#else
+uniform sampler2DArray u_Textures;
+#endif
+
+void main()
+{
+#ifdef BINDLESS
+	uvec4 pair = u_Handles[v_TexIndex / 2];
+	sampler2D textureSampler = sampler2D( ( v_TexIndex % 2 ) == 0 ? pair.xy : pair.zw );
+	color = texture( textureSampler, v_TexCoord );
+#else
+	color = texture( u_Textures, vec3( v_TexCoord, float( v_TexIndex ) ) );
+#endif
+}
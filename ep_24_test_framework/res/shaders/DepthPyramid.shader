@@ -0,0 +1,29 @@
+#shader compute
+#version 430 core
+
+// One level of the depth pyramid (see DepthPyramid.h): every output texel keeps the
+// farthest depth of the input texels it covers. Odd input sizes make some texels
+// cover three input rows or columns instead of two.
+layout( local_size_x = 8, local_size_y = 8 ) in;
+
+layout( r32f, binding = 0 ) uniform writeonly image2D u_Output;
+uniform sampler2D u_Input;
+uniform int u_InputLevel;
+
+void main()
+{
+	ivec2 outputSize = imageSize( u_Output );
+	ivec2 texel = ivec2( gl_GlobalInvocationID.xy );
+	if ( any( greaterThanEqual( texel, outputSize ) ) )
+		return;
+
+	ivec2 inputSize = textureSize( u_Input, u_InputLevel );
+	ivec2 first = ( texel * inputSize ) / outputSize;
+	ivec2 last = min( ( ( texel + 1 ) * inputSize + outputSize - 1 ) / outputSize, inputSize );
+
+	float depth = 0.0;
+	for ( int y = first.y; y < last.y; y++ )
+		for ( int x = first.x; x < last.x; x++ )
+			depth = max( depth, texelFetch( u_Input, ivec2( x, y ), u_InputLevel ).r );
+	imageStore( u_Output, texel, vec4( depth ) );
+}
@@ -0,0 +1,52 @@
+#shader compute
+#version 430 core
+
+// Instance frustum culling (see InstanceCuller.h), one invocation per instance.
+layout( local_size_x = 64 ) in;
+
+struct DrawCommand
+{
+	uint Count;
+	uint InstanceCount;
+	uint FirstIndex;
+	int BaseVertex;
+	uint BaseInstance;
+};
+
+layout( std430, binding = 0 ) readonly buffer Bounds { vec4 spheres[]; };
+layout( std430, binding = 1 ) writeonly buffer Visible { uint visible[]; };
+layout( std430, binding = 2 ) buffer Command { DrawCommand command; };
+
+uniform vec4 u_FrustumPlanes[6];
+uniform int u_InstanceCount;
+
+// Survivors are counted in shared memory first, so the command sees one atomic per workgroup.
+shared uint s_Count;
+shared uint s_First;
+
+bool IsInFrustum( vec4 sphere )
+{
+	for ( int i = 0; i < 6; i++ )
+		if ( dot( u_FrustumPlanes[i].xyz, sphere.xyz ) + u_FrustumPlanes[i].w < -sphere.w )
+			return false;
+	return true;
+}
+
+void main()
+{
+	if ( gl_LocalInvocationIndex == 0u )
+		s_Count = 0u;
+	barrier();
+
+	uint instance = gl_GlobalInvocationID.x;
+	bool inside = instance < uint( u_InstanceCount ) && IsInFrustum( spheres[instance] );
+	uint slot = inside ? atomicAdd( s_Count, 1u ) : 0u;
+	barrier();
+
+	if ( gl_LocalInvocationIndex == 0u )
+		s_First = atomicAdd( command.InstanceCount, s_Count );
+	barrier();
+
+	if ( inside )
+		visible[s_First + slot] = instance;
+}
@@ -0,0 +1,38 @@
+#shader vertex
+#version 330 core
+layout( location = 0 ) in vec4 position;
+layout( location = 1 ) in vec2 texCoord;
+layout( location = 2 ) in vec4 color;
+layout( location = 3 ) in vec3 normal;
+
+out vec2 v_TexCoord;
+out vec4 v_Color;
+out vec3 v_Normal;
+
+uniform mat4 u_MVP;
+
+void main()
+{
+	gl_Position = u_MVP * position;
+	v_TexCoord = texCoord;
+	v_Color = color;
+	v_Normal = normal;
+}
+
+#shader fragment
+#version 330 core
+
+layout( location = 0 ) out vec4 color;
+
+in vec2 v_TexCoord;
+in vec4 v_Color;
+in vec3 v_Normal;
+
+uniform sampler2D u_Texture;
+uniform vec3 u_LightDirection;
+
+void main()
+{
+	float diffuse = max( dot( normalize( v_Normal ), u_LightDirection ), 0.0 );
+	color = texture( u_Texture, v_TexCoord ) * v_Color * ( 0.3 + 0.7 * diffuse );
+}
@@ -0,0 +1,38 @@
+#shader vertex
+#version 330 core
+layout( location = 0 ) in vec4 position;
+layout( location = 1 ) in vec2 texCoord;
+layout( location = 2 ) in vec4 normal;
+
+out vec2 v_TexCoord;
+out vec3 v_Normal;
+
+uniform mat4 u_MVP;
+uniform mat4 u_Model;
+// Positions are normalized to the mesh bounds, see Mesh::GetPositionScale.
+uniform vec3 u_PositionScale;
+uniform vec3 u_PositionOffset;
+
+void main()
+{
+	gl_Position = u_MVP * vec4( position.xyz * u_PositionScale + u_PositionOffset, 1.0 );
+	v_TexCoord = texCoord;
+	v_Normal = mat3( u_Model ) * normal.xyz;
+}
+
+#shader fragment
+#version 330 core
+
+layout( location = 0 ) out vec4 color;
+
+in vec2 v_TexCoord;
+in vec3 v_Normal;
+
+uniform sampler2D u_Texture;
+uniform vec3 u_LightDirection;
+
+void main()
+{
+	float diffuse = max( dot( normalize( v_Normal ), u_LightDirection ), 0.0 );
+	color = vec4( texture( u_Texture, v_TexCoord ).rgb * ( 0.25 + 0.75 * diffuse ), 1.0 );
+}
@@ -0,0 +1,148 @@
+#shader compute
+#version 430 core
+
+// Meshlet culling (see MeshletCuller.h). One workgroup per meshlet and instance:
+// the first invocation decides, all of them copy the indices of a visible meshlet.
+layout( local_size_x = 64 ) in;
+
+// Same layouts as Meshlet and DrawElementsIndirectCommand on the CPU.
+struct Meshlet
+{
+	vec4 Sphere; // xyz center, w radius.
+	vec4 Cone; // xyz axis, w cutoff.
+	uint FirstIndex;
+	uint IndexCount;
+	uint VertexCount;
+	uint Padding;
+};
+
+struct DrawCommand
+{
+	uint Count;
+	uint InstanceCount;
+	uint FirstIndex;
+	int BaseVertex;
+	uint BaseInstance;
+};
+
+layout( std430, binding = 0 ) readonly buffer Meshlets { Meshlet meshlets[]; };
+layout( std430, binding = 1 ) readonly buffer SourceIndices { uint sourceIndices[]; };
+layout( std430, binding = 2 ) writeonly buffer Indices { uint indices[]; };
+layout( std430, binding = 3 ) buffer Commands { DrawCommand commands[]; };
+layout( std430, binding = 4 ) buffer Visibility { uint visibility[]; };
+layout( std430, binding = 5 ) readonly buffer Models { mat4 models[]; };
+
+uniform mat4 u_ViewProjection;
+uniform vec4 u_FrustumPlanes[6];
+uniform vec3 u_CameraPosition;
+uniform int u_Phase;
+uniform int u_InstanceCount;
+uniform bool u_ShortIndices;
+uniform bool u_ConeCulling;
+uniform bool u_OcclusionCulling;
+uniform sampler2D u_DepthPyramid;
+
+shared uint s_Offset;
+
+uint ReadIndex( uint i )
+{
+	if ( !u_ShortIndices )
+		return sourceIndices[i];
+	return ( sourceIndices[i >> 1] >> ( ( i & 1u ) * 16u ) ) & 0xFFFFu;
+}
+
+bool IsInFrustum( vec3 center, float radius )
+{
+	for ( int i = 0; i < 6; i++ )
+		if ( dot( u_FrustumPlanes[i].xyz, center ) + u_FrustumPlanes[i].w < -radius )
+			return false;
+	return true;
+}
+
+// False when every triangle faces away from the camera, see Meshlet in MeshOptimizer.h.
+bool IsFacingCamera( vec3 center, float radius, vec3 axis, float cutoff )
+{
+	vec3 direction = center - u_CameraPosition;
+	return dot( direction, axis ) < cutoff * length( direction ) + radius;
+}
+
+// False when the screen rectangle of the sphere's box is farther than the depth pyramid.
+bool IsUnoccluded( vec3 center, float radius )
+{
+	vec3 boxMin = vec3( 1.0 ), boxMax = vec3( -1.0 );
+	for ( int i = 0; i < 8; i++ )
+	{
+		vec3 corner = center + radius * vec3( ( i & 1 ) != 0 ? 1.0 : -1.0, ( i & 2 ) != 0 ? 1.0 : -1.0, ( i & 4 ) != 0 ? 1.0 : -1.0 );
+		vec4 clip = u_ViewProjection * vec4( corner, 1.0 );
+		// Crossing the near plane, the projection is meaningless.
+		if ( clip.w <= 0.0 )
+			return true;
+		vec3 ndc = clip.xyz / clip.w;
+		boxMin = i == 0 ? ndc : min( boxMin, ndc );
+		boxMax = i == 0 ? ndc : max( boxMax, ndc );
+	}
+
+	vec2 uvMin = clamp( boxMin.xy * 0.5 + 0.5, 0.0, 1.0 );
+	vec2 uvMax = clamp( boxMax.xy * 0.5 + 0.5, 0.0, 1.0 );
+	float nearest = boxMin.z * 0.5 + 0.5;
+
+	// The level where the rectangle spans at most two texels each way.
+	ivec2 size = textureSize( u_DepthPyramid, 0 );
+	vec2 extent = ( uvMax - uvMin ) * vec2( size );
+	int levels = textureQueryLevels( u_DepthPyramid );
+	int level = clamp( int( ceil( log2( max( max( extent.x, extent.y ), 1.0 ) ) ) ), 0, levels - 1 );
+
+	ivec2 levelSize = textureSize( u_DepthPyramid, level );
+	ivec2 texelMin = min( ivec2( uvMin * vec2( levelSize ) ), levelSize - 1 );
+	ivec2 texelMax = min( ivec2( uvMax * vec2( levelSize ) ), levelSize - 1 );
+	float farthest = max( max( texelFetch( u_DepthPyramid, texelMin, level ).r, texelFetch( u_DepthPyramid, ivec2( texelMax.x, texelMin.y ), level ).r ),
+						  max( texelFetch( u_DepthPyramid, ivec2( texelMin.x, texelMax.y ), level ).r, texelFetch( u_DepthPyramid, texelMax, level ).r ) );
+	return nearest <= farthest;
+}
+
+void main()
+{
+	uint meshletIndex = gl_WorkGroupID.x;
+	uint instance = gl_WorkGroupID.y;
+	Meshlet meshlet = meshlets[meshletIndex];
+	uint command = uint( u_Phase ) * uint( u_InstanceCount ) + instance;
+
+	if ( gl_LocalInvocationIndex == 0u )
+	{
+		mat4 model = models[instance];
+		vec3 center = ( model * vec4( meshlet.Sphere.xyz, 1.0 ) ).xyz;
+		float scale = max( max( length( model[0].xyz ), length( model[1].xyz ) ), length( model[2].xyz ) );
+		float radius = meshlet.Sphere.w * scale;
+
+		bool visible = IsInFrustum( center, radius );
+		// A zero axis (cutoff 1) means the meshlet faces every way.
+		if ( visible && u_ConeCulling && meshlet.Cone.w < 1.0 )
+			visible = IsFacingCamera( center, radius, normalize( mat3( model ) * meshlet.Cone.xyz ), meshlet.Cone.w );
+
+		uint slot = instance * uint( meshlets.length() ) + meshletIndex;
+		if ( u_OcclusionCulling )
+		{
+			bool wasVisible = visibility[slot] != 0u;
+			if ( u_Phase == 0 )
+			{
+				visible = visible && wasVisible;
+			}
+			else
+			{
+				visible = visible && IsUnoccluded( center, radius );
+				visibility[slot] = visible ? 1u : 0u;
+				// Already drawn by phase 0.
+				visible = visible && !wasVisible;
+			}
+		}
+
+		s_Offset = visible ? atomicAdd( commands[command].Count, meshlet.IndexCount ) : 0xFFFFFFFFu;
+	}
+	barrier();
+
+	if ( s_Offset == 0xFFFFFFFFu )
+		return;
+	uint first = commands[command].FirstIndex + s_Offset;
+	for ( uint i = gl_LocalInvocationIndex; i < meshlet.IndexCount; i += gl_WorkGroupSize.x )
+		indices[first + i] = ReadIndex( meshlet.FirstIndex + i );
+}
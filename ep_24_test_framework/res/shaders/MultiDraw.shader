@@ -0,0 +1,42 @@
+#shader vertex
+#version 430 core
+#ifdef DRAW_PARAMETERS
+#extension GL_ARB_shader_draw_parameters : require
+#define DRAW_ID gl_DrawIDARB
+#endif
+
+layout( location = 0 ) in vec4 position;
+layout( location = 1 ) in vec2 texCoord;
+#ifndef DRAW_PARAMETERS
+// Instanced 0..N-1, every command's BaseInstance is its index in the multi-draw.
+layout( location = 2 ) in uint drawID;
+#define DRAW_ID drawID
+#endif
+
+out vec2 v_TexCoord;
+
+// One matrix per command of the multi-draw.
+layout( std430, binding = 0 ) readonly buffer DrawData
+{
+	mat4 mvps[];
+};
+
+void main()
+{
+	gl_Position = mvps[DRAW_ID] * position;
+	v_TexCoord = texCoord;
+}
+
+#shader fragment
+#version 430 core
+
+layout( location = 0 ) out vec4 color;
+
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Texture;
+
+void main()
+{
+	color = texture( u_Texture, v_TexCoord );
+}
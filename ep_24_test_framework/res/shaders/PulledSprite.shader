@@ -0,0 +1,49 @@
+#shader vertex
+#version 430 core
+
+// Same layout as SpriteRecord on the CPU.
+struct Sprite
+{
+	vec2 Position;
+	vec2 Size;
+	uint TexCoordsMin;
+	uint TexCoordsMax;
+	uint Color;
+	float Layer;
+};
+
+layout( std430, binding = 0 ) readonly buffer Sprites { Sprite sprites[]; };
+
+out vec2 v_TexCoord;
+out vec4 v_Color;
+
+uniform mat4 u_MVP;
+
+// Two triangles per sprite, corners counter-clockwise from the lower left.
+const int CORNERS[6] = int[6]( 0, 1, 2, 2, 3, 0 );
+
+void main()
+{
+	Sprite sprite = sprites[gl_VertexID / 6];
+	int corner = CORNERS[gl_VertexID % 6];
+	vec2 offset = vec2( corner == 1 || corner == 2 ? 1.0 : 0.0, corner >= 2 ? 1.0 : 0.0 );
+
+	gl_Position = u_MVP * vec4( sprite.Position + offset * sprite.Size, sprite.Layer, 1.0 );
+	v_TexCoord = mix( unpackUnorm2x16( sprite.TexCoordsMin ), unpackUnorm2x16( sprite.TexCoordsMax ), offset );
+	v_Color = unpackUnorm4x8( sprite.Color );
+}
+
+#shader fragment
+#version 430 core
+
+layout( location = 0 ) out vec4 color;
+
+in vec2 v_TexCoord;
+in vec4 v_Color;
+
+uniform sampler2D u_Texture;
+
+void main()
+{
+	color = texture( u_Texture, v_TexCoord ) * v_Color;
+}
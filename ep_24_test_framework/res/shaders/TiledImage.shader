@@ -0,0 +1,59 @@
+#shader vertex
+#version 330 core
+layout( location = 0 ) in vec4 position;
+layout( location = 1 ) in vec2 texCoord;
+
+out vec2 v_TexCoord;
+
+uniform mat4 u_MVP;
+
+void main()
+{
+	gl_Position = u_MVP * position;
+	v_TexCoord = texCoord;
+}
+
+#shader fragment
+#version 330 core
+
+layout( location = 0 ) out vec4 color;
+
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Atlas;
+uniform usampler2D u_PageTable;
+uniform vec2 u_ImageSize;
+uniform float u_TileSize;
+uniform float u_TileBorder;
+uniform float u_SlotStride;
+uniform vec2 u_AtlasSize;
+uniform int u_LevelCount;
+uniform int u_LevelOffset[32];
+
+vec2 LevelSize( int level )
+{
+	return max( vec2( 1.0 ), floor( u_ImageSize / exp2( float( level ) ) ) );
+}
+
+void main()
+{
+	vec2 texel = v_TexCoord * u_ImageSize;
+	float lod = log2( max( length( dFdx( texel ) ), length( dFdy( texel ) ) ) );
+	int level = clamp( int( floor( lod ) ), 0, u_LevelCount - 1 );
+
+	vec2 pixel = min( v_TexCoord * LevelSize( level ), LevelSize( level ) - 0.5 );
+	ivec2 tile = ivec2( pixel / u_TileSize );
+	uvec4 entry = texelFetch( u_PageTable, ivec2( tile.x, u_LevelOffset[level] + tile.y ), 0 );
+	if ( entry.a == 0u )
+	{
+		color = vec4( 0.5, 0.5, 0.5, 1.0 );
+		return;
+	}
+
+	// The entry points at a coarser ancestor while the requested tile streams in.
+	int resident = int( entry.b );
+	pixel = min( v_TexCoord * LevelSize( resident ), LevelSize( resident ) - 0.5 );
+	vec2 inTile = pixel - floor( pixel / u_TileSize ) * u_TileSize;
+	vec2 atlasPixel = vec2( entry.rg ) * u_SlotStride + u_TileBorder + inTile;
+	color = textureLod( u_Atlas, atlasPixel / u_AtlasSize, 0.0 );
+}
@@ -0,0 +1,42 @@
+#shader vertex
+#version 330 core
+layout( location = 0 ) in vec4 position;
+layout( location = 1 ) in vec2 texCoord;
+
+out vec2 v_TexCoord;
+
+uniform mat4 u_MVP;
+
+void main()
+{
+	gl_Position = u_MVP * position;
+	v_TexCoord = texCoord;
+}
+
+#shader fragment
+#version 330 core
+
+// Tile x, tile y, level and a valid flag for the tile this pixel needs.
+layout( location = 0 ) out uvec4 feedback;
+
+in vec2 v_TexCoord;
+
+uniform vec2 u_ImageSize;
+uniform float u_TileSize;
+uniform int u_LevelCount;
+uniform float u_LodBias;
+
+vec2 LevelSize( int level )
+{
+	return max( vec2( 1.0 ), floor( u_ImageSize / exp2( float( level ) ) ) );
+}
+
+void main()
+{
+	vec2 texel = v_TexCoord * u_ImageSize;
+	float lod = log2( max( length( dFdx( texel ) ), length( dFdy( texel ) ) ) ) + u_LodBias;
+	int level = clamp( int( floor( lod ) ), 0, u_LevelCount - 1 );
+
+	vec2 pixel = min( v_TexCoord * LevelSize( level ), LevelSize( level ) - 0.5 );
+	feedback = uvec4( uvec2( pixel / u_TileSize ), uint( level ), 1u );
+}
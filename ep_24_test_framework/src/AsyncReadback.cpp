@@ -0,0 +1,67 @@
+#include "AsyncReadback.h"
+#include "Debug.h"
+
+AsyncReadback::AsyncReadback( unsigned int size )
+	: m_Size( size ), m_Buffers{ 0 }, m_Fences{ nullptr }, m_Index( 0 )
+{
+	GLCall( glGenBuffers( BUFFER_COUNT, m_Buffers ) );
+	for ( unsigned int i = 0; i < BUFFER_COUNT; i++ )
+	{
+		GLCall( glBindBuffer( GL_COPY_WRITE_BUFFER, m_Buffers[i] ) );
+		GLCall( glBufferData( GL_COPY_WRITE_BUFFER, m_Size, nullptr, GL_STREAM_READ ) );
+	}
+	GLCall( glBindBuffer( GL_COPY_WRITE_BUFFER, 0 ) );
+}
+
+AsyncReadback::~AsyncReadback()
+{
+	for ( unsigned int i = 0; i < BUFFER_COUNT; i++ )
+	{
+		if ( m_Fences[i] )
+		{
+			GLCall( glDeleteSync( m_Fences[i] ) );
+		}
+	}
+	GLCall( glDeleteBuffers( BUFFER_COUNT, m_Buffers ) );
+}
+
+void AsyncReadback::Request( unsigned int source, unsigned int offset )
+{
+	const unsigned int index = m_Index;
+	m_Index = ( m_Index + 1 ) % BUFFER_COUNT;
+	if ( m_Fences[index] )
+	{
+		GLCall( glDeleteSync( m_Fences[index] ) );
+	}
+
+	GLCall( glBindBuffer( GL_COPY_READ_BUFFER, source ) );
+	GLCall( glBindBuffer( GL_COPY_WRITE_BUFFER, m_Buffers[index] ) );
+	GLCall( glCopyBufferSubData( GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, offset, 0, m_Size ) );
+	GLCall( m_Fences[index] = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 ) );
+	GLCall( glBindBuffer( GL_COPY_WRITE_BUFFER, 0 ) );
+	GLCall( glBindBuffer( GL_COPY_READ_BUFFER, 0 ) );
+}
+
+bool AsyncReadback::Read( void* data )
+{
+	// Oldest request first, so the newest finished one is what is left in "data".
+	bool read = false;
+	for ( unsigned int i = 0; i < BUFFER_COUNT; i++ )
+	{
+		const unsigned int index = ( m_Index + i ) % BUFFER_COUNT;
+		if ( !m_Fences[index] )
+			continue;
+
+		GLCall( GLenum status = glClientWaitSync( m_Fences[index], 0, 0 ) );
+		if ( status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED )
+			continue;
+		GLCall( glDeleteSync( m_Fences[index] ) );
+		m_Fences[index] = nullptr;
+
+		GLCall( glBindBuffer( GL_COPY_READ_BUFFER, m_Buffers[index] ) );
+		GLCall( glGetBufferSubData( GL_COPY_READ_BUFFER, 0, m_Size, data ) );
+		GLCall( glBindBuffer( GL_COPY_READ_BUFFER, 0 ) );
+		read = true;
+	}
+	return read;
+}
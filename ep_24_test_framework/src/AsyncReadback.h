@@ -0,0 +1,35 @@
+#pragma once
+
+#include <GL/glew.h>
+
+// Reads buffer contents back to the CPU without waiting for the GPU. Request() copies
+// them into a staging buffer on the GPU and fences the copy, Read() picks up the
+// newest copy that has finished, usually a frame or two later. Good for statistics
+// the GPU computes, e.g. the counts of indirect draw commands.
+class AsyncReadback
+{
+private:
+	static constexpr unsigned int BUFFER_COUNT = 3;
+
+	unsigned int m_Size;
+	unsigned int m_Buffers[BUFFER_COUNT];
+	GLsync m_Fences[BUFFER_COUNT];
+	unsigned int m_Index;
+
+public:
+	AsyncReadback( unsigned int size );
+	~AsyncReadback();
+
+	AsyncReadback( const AsyncReadback& ) = delete;
+	AsyncReadback& operator=( const AsyncReadback& ) = delete;
+
+	// Queues a copy of GetSize() bytes from "offset" of the GL buffer "source". Call it
+	// after the barrier that makes shader writes visible to buffer copies. With every
+	// staging buffer in flight the oldest request is replaced.
+	void Request( unsigned int source, unsigned int offset = 0 );
+	// Copies the newest request the GPU has finished into "data". Returns false, leaving
+	// "data" alone, when none finished since the last call.
+	bool Read( void* data );
+
+	inline unsigned int GetSize() const { return m_Size; }
+};
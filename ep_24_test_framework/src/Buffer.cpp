@@ -0,0 +1,193 @@
+#include "Buffer.h"
+#include "Renderer.h"
+#include "Debug.h"
+
+#include <algorithm>
+#include <utility>
+
+Buffer::Buffer( unsigned int target, const void* data, unsigned int size, BufferUsage usage )
+	: m_RendererID( 0 ), m_Target( target ), m_Usage( usage ), m_Size( size ), m_Capacity( size )
+{
+	if ( Renderer::IsDirectStateAccessSupported() )
+	{
+		GLCall( glCreateBuffers( 1, &m_RendererID ) );
+		GLCall( glNamedBufferData( m_RendererID, size, data, GetGLUsage( usage ) ) );
+		return;
+	}
+
+	GLCall( glGenBuffers( 1, &m_RendererID ) );
+	GLCall( glBindBuffer( m_Target, m_RendererID ) );
+	GLCall( glBufferData( m_Target, size, data, GetGLUsage( usage ) ) );
+}
+
+Buffer::~Buffer()
+{
+	GLCall( glDeleteBuffers( 1, &m_RendererID ) );
+}
+
+Buffer::Buffer( Buffer&& other ) noexcept
+	: m_RendererID( std::exchange( other.m_RendererID, 0 ) ), m_Target( other.m_Target ), m_Usage( other.m_Usage ),
+	m_Size( std::exchange( other.m_Size, 0 ) ), m_Capacity( std::exchange( other.m_Capacity, 0 ) )
+{
+}
+
+Buffer& Buffer::operator=( Buffer&& other ) noexcept
+{
+	if ( this != &other )
+	{
+		GLCall( glDeleteBuffers( 1, &m_RendererID ) );
+		m_RendererID = std::exchange( other.m_RendererID, 0 );
+		m_Target = other.m_Target;
+		m_Usage = other.m_Usage;
+		m_Size = std::exchange( other.m_Size, 0 );
+		m_Capacity = std::exchange( other.m_Capacity, 0 );
+	}
+	return *this;
+}
+
+void Buffer::Bind() const
+{
+	GLCall( glBindBuffer( m_Target, m_RendererID ) );
+}
+
+void Buffer::Unbind() const
+{
+	GLCall( glBindBuffer( m_Target, 0 ) );
+}
+
+void Buffer::SetData( const void* data, unsigned int size )
+{
+	if ( size > m_Capacity )
+	{
+		// Geometric growth, so buffers refilled with slowly growing data are rarely re-specified.
+		m_Capacity = std::max( size, m_Capacity + m_Capacity / 2 );
+		Specify( m_Capacity );
+	}
+	else if ( m_Usage != BufferUsage::Static )
+	{
+		// Orphaning: the driver hands out fresh storage and frees the old one once the GPU is done with it.
+		Specify( m_Capacity );
+	}
+
+	if ( data && size > 0 )
+		Upload( 0, data, size );
+	m_Size = size;
+}
+
+void Buffer::SetSubData( unsigned int offset, const void* data, unsigned int size )
+{
+	ASSERT( offset + size <= m_Size );
+
+	Upload( offset, data, size );
+}
+
+void Buffer::GetSubData( unsigned int offset, void* data, unsigned int size ) const
+{
+	ASSERT( offset + size <= m_Size );
+
+	if ( Renderer::IsDirectStateAccessSupported() )
+	{
+		GLCall( glGetNamedBufferSubData( m_RendererID, offset, size, data ) );
+		return;
+	}
+
+	Bind();
+	GLCall( glGetBufferSubData( m_Target, offset, size, data ) );
+}
+
+void Buffer::Reserve( unsigned int capacity )
+{
+	if ( capacity <= m_Capacity )
+		return;
+
+	if ( Renderer::IsDirectStateAccessSupported() )
+	{
+		ReserveNamed( capacity );
+		return;
+	}
+
+	// Park the contents in a temporary buffer while the storage is re-specified.
+	unsigned int copy = 0;
+	if ( m_Size > 0 )
+	{
+		GLCall( glGenBuffers( 1, &copy ) );
+		GLCall( glBindBuffer( GL_COPY_WRITE_BUFFER, copy ) );
+		GLCall( glBufferData( GL_COPY_WRITE_BUFFER, m_Size, nullptr, GL_STREAM_COPY ) );
+		GLCall( glBindBuffer( GL_COPY_READ_BUFFER, m_RendererID ) );
+		GLCall( glCopyBufferSubData( GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, m_Size ) );
+	}
+
+	m_Capacity = capacity;
+	Specify( m_Capacity );
+
+	if ( copy )
+	{
+		GLCall( glBindBuffer( GL_COPY_READ_BUFFER, copy ) );
+		GLCall( glBindBuffer( GL_COPY_WRITE_BUFFER, m_RendererID ) );
+		GLCall( glCopyBufferSubData( GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, m_Size ) );
+		GLCall( glDeleteBuffers( 1, &copy ) );
+	}
+}
+
+void Buffer::ReserveNamed( unsigned int capacity )
+{
+	unsigned int copy = 0;
+	if ( m_Size > 0 )
+	{
+		GLCall( glCreateBuffers( 1, &copy ) );
+		GLCall( glNamedBufferData( copy, m_Size, nullptr, GL_STREAM_COPY ) );
+		GLCall( glCopyNamedBufferSubData( m_RendererID, copy, 0, 0, m_Size ) );
+	}
+
+	m_Capacity = capacity;
+	Specify( m_Capacity );
+
+	if ( copy )
+	{
+		GLCall( glCopyNamedBufferSubData( copy, m_RendererID, 0, 0, m_Size ) );
+		GLCall( glDeleteBuffers( 1, &copy ) );
+	}
+}
+
+void Buffer::Specify( unsigned int size )
+{
+	if ( Renderer::IsDirectStateAccessSupported() )
+	{
+		GLCall( glNamedBufferData( m_RendererID, size, nullptr, GetGLUsage( m_Usage ) ) );
+		return;
+	}
+
+	Bind();
+	GLCall( glBufferData( m_Target, size, nullptr, GetGLUsage( m_Usage ) ) );
+}
+
+void Buffer::Upload( unsigned int offset, const void* data, unsigned int size )
+{
+	if ( Renderer::IsDirectStateAccessSupported() )
+	{
+		GLCall( glNamedBufferSubData( m_RendererID, offset, size, data ) );
+		return;
+	}
+
+	Bind();
+	GLCall( glBufferSubData( m_Target, offset, size, data ) );
+}
+
+void Buffer::Resize( unsigned int size )
+{
+	Reserve( size );
+	m_Size = size;
+}
+
+unsigned int Buffer::GetGLUsage( BufferUsage usage )
+{
+	switch ( usage )
+	{
+		case BufferUsage::Static: return GL_STATIC_DRAW;
+		case BufferUsage::Dynamic: return GL_DYNAMIC_DRAW;
+		case BufferUsage::Stream: return GL_STREAM_DRAW;
+		case BufferUsage::Copy: return GL_DYNAMIC_COPY;
+	}
+	ASSERT( false );
+	return GL_STATIC_DRAW;
+}
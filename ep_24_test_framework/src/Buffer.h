@@ -0,0 +1,60 @@
+#pragma once
+
+// How often the contents of a buffer are replaced, maps to the GL usage hint.
+// Copy is for buffers the GPU rewrites every frame, e.g. the output of compute shaders.
+enum class BufferUsage
+{
+	Static, Dynamic, Stream, Copy
+};
+
+// GL buffer object bound to one target, shared by VertexBuffer and IndexBuffer.
+// The buffer keeps its GL name for its whole life, growing it re-specifies the
+// storage of the same name, so vertex arrays referencing it stay valid.
+// With direct state access (see Renderer) no call but Bind() changes the bindings.
+class Buffer
+{
+protected:
+	unsigned int m_RendererID;
+	unsigned int m_Target;
+	BufferUsage m_Usage;
+	unsigned int m_Size;
+	unsigned int m_Capacity;
+
+public:
+	Buffer( unsigned int target, const void* data, unsigned int size, BufferUsage usage );
+	~Buffer();
+
+	// Move-only, a moved-from buffer is empty and owns no GL name.
+	Buffer( const Buffer& ) = delete;
+	Buffer& operator=( const Buffer& ) = delete;
+	Buffer( Buffer&& other ) noexcept;
+	Buffer& operator=( Buffer&& other ) noexcept;
+
+	void Bind() const;
+	void Unbind() const;
+
+	// Replaces the contents. Dynamic and stream buffers orphan the old storage first,
+	// so the upload never waits for draws still reading it. Grows geometrically if needed.
+	void SetData( const void* data, unsigned int size );
+	// Overwrites part of the current contents, "offset" + "size" must not exceed GetSize().
+	void SetSubData( unsigned int offset, const void* data, unsigned int size );
+	// Copies part of the current contents back, waiting for the GPU to finish writing them.
+	void GetSubData( unsigned int offset, void* data, unsigned int size ) const;
+	// Grows the storage to at least "capacity" bytes, keeping the current contents.
+	void Reserve( unsigned int capacity );
+	// Changes the size to "size" bytes, keeping the contents that fit. New bytes are undefined.
+	void Resize( unsigned int size );
+
+	inline unsigned int GetRendererID() const { return m_RendererID; }
+	inline BufferUsage GetUsage() const { return m_Usage; }
+	inline unsigned int GetSize() const { return m_Size; }
+	inline unsigned int GetCapacity() const { return m_Capacity; }
+
+	static unsigned int GetGLUsage( BufferUsage usage );
+
+private:
+	// Re-specifies the storage with "size" undefined bytes.
+	void Specify( unsigned int size );
+	void Upload( unsigned int offset, const void* data, unsigned int size );
+	void ReserveNamed( unsigned int capacity );
+};
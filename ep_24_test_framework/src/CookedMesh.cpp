@@ -0,0 +1,128 @@
+#include "CookedMesh.h"
+
+#include <GL/glew.h>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+CookedMesh::CookedMesh( const std::string& path )
+	: m_File( path ), m_Data( nullptr ), m_Header( nullptr )
+{
+	if ( !m_File.IsOpen() )
+		return;
+
+	if ( !Validate( m_File.GetData(), m_File.GetSize() ) )
+	{
+		std::cout << "Invalid cooked mesh " << path << std::endl;
+		return;
+	}
+
+	m_Data = m_File.GetData();
+	m_Header = reinterpret_cast< const CookedMeshHeader* >( m_Data );
+}
+
+CookedMesh::CookedMesh( std::vector< unsigned char >&& image )
+	: m_File( "" ), m_Image( std::move( image ) ), m_Data( nullptr ), m_Header( nullptr )
+{
+	if ( !Validate( m_Image.data(), m_Image.size() ) )
+		return;
+
+	m_Data = m_Image.data();
+	m_Header = reinterpret_cast< const CookedMeshHeader* >( m_Data );
+}
+
+bool CookedMesh::IsUpToDate( const std::string& sourcePath ) const
+{
+	uint64_t size, time;
+	return GetSourceInfo( sourcePath, size, time ) && size == m_Header->SourceSize && time == m_Header->SourceTime;
+}
+
+VertexBufferLayout CookedMesh::GetLayout() const
+{
+	VertexBufferLayout layout;
+	layout.Push< unsigned short >( 4, true );
+	if ( m_Header->Attributes & COOKED_MESH_TEXCOORDS )
+		layout.Push< Half >( 2 );
+	if ( m_Header->Attributes & COOKED_MESH_NORMALS )
+		layout.Push< PackedNormal >( 4, true );
+	return layout;
+}
+
+bool CookedMesh::Validate( const unsigned char* data, size_t size ) const
+{
+	if ( size < sizeof( CookedMeshHeader ) )
+		return false;
+
+	const CookedMeshHeader* header = reinterpret_cast< const CookedMeshHeader* >( data );
+	if ( std::memcmp( header->Magic, COOKED_MESH_MAGIC, sizeof( COOKED_MESH_MAGIC ) ) != 0
+		 || header->Version != COOKED_MESH_VERSION
+		 || header->VertexStride != GetVertexStride( header->Attributes )
+		 || ( header->IndexType != GL_UNSIGNED_SHORT && header->IndexType != GL_UNSIGNED_INT )
+		 || header->VertexCount == 0 || header->IndexCount == 0 )
+		return false;
+
+	const size_t indexSize = header->IndexType == GL_UNSIGNED_SHORT ? 2 : 4;
+	if ( !( header->VertexOffset >= sizeof( CookedMeshHeader ) && header->IndexOffset >= sizeof( CookedMeshHeader )
+			&& (size_t) header->VertexOffset + (size_t) header->VertexCount * header->VertexStride <= size
+			&& (size_t) header->IndexOffset + (size_t) header->IndexCount * indexSize <= size
+			&& header->MeshletOffset >= sizeof( CookedMeshHeader ) && (size_t) header->MeshletOffset + (size_t) header->MeshletCount * sizeof( Meshlet ) <= size ) )
+		return false;
+
+	// An index past the vertices would make draws read outside the vertex buffer.
+	for ( uint32_t i = 0; i < header->IndexCount; i++ )
+	{
+		uint32_t index;
+		if ( indexSize == 2 )
+		{
+			uint16_t shortIndex;
+			std::memcpy( &shortIndex, data + header->IndexOffset + i * 2, 2 );
+			index = shortIndex;
+		}
+		else
+			std::memcpy( &index, data + header->IndexOffset + i * 4, 4 );
+		if ( index >= header->VertexCount )
+			return false;
+	}
+
+	// Meshlets tile the index data in order, whole triangles each. The culling shader
+	// copies their ranges, so a range past the indices would write past its output.
+	uint32_t next = 0;
+	for ( uint32_t i = 0; i < header->MeshletCount; i++ )
+	{
+		Meshlet meshlet;
+		std::memcpy( &meshlet, data + header->MeshletOffset + i * sizeof( Meshlet ), sizeof( Meshlet ) );
+		if ( meshlet.FirstIndex != next || meshlet.IndexCount == 0 || meshlet.IndexCount % 3 != 0
+			 || meshlet.IndexCount > header->IndexCount - meshlet.FirstIndex )
+			return false;
+		next = meshlet.FirstIndex + meshlet.IndexCount;
+	}
+	return header->MeshletCount == 0 || next == header->IndexCount;
+}
+
+std::string CookedMesh::GetCookedPath( const std::string& sourcePath )
+{
+	const size_t dot = sourcePath.find_last_of( '.' );
+	const size_t slash = sourcePath.find_last_of( "/\\" );
+	if ( dot == std::string::npos || ( slash != std::string::npos && dot < slash ) )
+		return sourcePath + ".cmesh";
+	return sourcePath.substr( 0, dot ) + ".cmesh";
+}
+
+unsigned int CookedMesh::GetVertexStride( uint32_t attributes )
+{
+	return 4 * sizeof( uint16_t )
+		+ ( ( attributes & COOKED_MESH_TEXCOORDS ) ? 2 * sizeof( Half ) : 0 )
+		+ ( ( attributes & COOKED_MESH_NORMALS ) ? sizeof( PackedNormal ) : 0 );
+}
+
+bool CookedMesh::GetSourceInfo( const std::string& sourcePath, uint64_t& size, uint64_t& time )
+{
+	namespace fs = std::filesystem;
+
+	std::error_code error;
+	size = fs::file_size( sourcePath, error );
+	if ( error )
+		return false;
+	time = (uint64_t) fs::last_write_time( sourcePath, error ).time_since_epoch().count();
+	return !error;
+}
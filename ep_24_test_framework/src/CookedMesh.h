@@ -0,0 +1,86 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <vector>
+
+#include "MappedFile.h"
+#include "MeshOptimizer.h"
+#include "VertexBufferLayout.h"
+
+// Layout of a cooked mesh (.cmesh) file:
+// [CookedMeshHeader][vertex data][index data][Meshlet x MeshletCount]
+// Vertices are interleaved and quantized: unorm16 position (w = 1) relative to the
+// bounds, Half texture coordinates (zero when the source has none), PackedNormal
+// normal. Shaders dequantize the position with BoundsMin + position * ( BoundsMax -
+// BoundsMin ), see Mesh::GetPositionScale. Triangles are
+// ordered for the vertex cache and overdraw, vertices by first use, and indices are
+// 16 bit whenever the vertex count allows it. Both blocks are ready to be handed to
+// VertexBuffer and IndexBuffer as they are. Meshlets (see MeshOptimizer.h) cover
+// the index data in order.
+struct CookedMeshHeader
+{
+	char Magic[4];
+	uint32_t Version;
+	// Size and modification time of the source, a cooked mesh that does not match is stale.
+	uint64_t SourceSize;
+	uint64_t SourceTime;
+	uint32_t Attributes; // COOKED_MESH_TEXCOORDS and COOKED_MESH_NORMALS.
+	uint32_t VertexStride;
+	uint32_t VertexCount;
+	uint32_t VertexOffset; // From the beginning of the file.
+	uint32_t IndexType; // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+	uint32_t IndexCount;
+	uint32_t IndexOffset;
+	uint32_t MeshletCount;
+	uint32_t MeshletOffset;
+	// Also the range the positions are quantized to.
+	float BoundsMin[3];
+	float BoundsMax[3];
+	// Vertex cache efficiency of the source order and of the cooked one, see MeshOptimizer.h.
+	float SourceAcmr, Acmr;
+	float SourceAtvr, Atvr;
+	// cooker::VertexCacheOrder the triangles were sorted with.
+	uint32_t VertexCacheOrder;
+};
+
+static const char COOKED_MESH_MAGIC[4] = { 'C', 'M', 'S', 'H' };
+static const uint32_t COOKED_MESH_VERSION = 5;
+static const uint32_t COOKED_MESH_ALIGNMENT = 16;
+static const uint32_t COOKED_MESH_TEXCOORDS = 1;
+static const uint32_t COOKED_MESH_NORMALS = 2;
+
+class CookedMesh
+{
+private:
+	MappedFile m_File;
+	// Set instead of the file for meshes cooked in memory.
+	std::vector< unsigned char > m_Image;
+	const unsigned char* m_Data;
+	const CookedMeshHeader* m_Header;
+
+public:
+	CookedMesh( const std::string& path );
+	// Takes a file image built by cooker::CookMesh.
+	CookedMesh( std::vector< unsigned char >&& image );
+
+	inline bool IsValid() const { return m_Header != nullptr; }
+	// True when "sourcePath" still has the size and modification time the mesh was cooked from.
+	bool IsUpToDate( const std::string& sourcePath ) const;
+
+	inline const CookedMeshHeader& GetHeader() const { return *m_Header; }
+	inline const void* GetVertexData() const { return m_Data + m_Header->VertexOffset; }
+	inline const void* GetIndexData() const { return m_Data + m_Header->IndexOffset; }
+	inline unsigned int GetVertexDataSize() const { return m_Header->VertexCount * m_Header->VertexStride; }
+	inline const Meshlet* GetMeshlets() const { return reinterpret_cast< const Meshlet* >( m_Data + m_Header->MeshletOffset ); }
+	VertexBufferLayout GetLayout() const;
+
+	// "res/models/torus.obj" -> "res/models/torus.cmesh".
+	static std::string GetCookedPath( const std::string& sourcePath );
+	static unsigned int GetVertexStride( uint32_t attributes );
+	// Size and modification time as stored in the header, false when the file is missing.
+	static bool GetSourceInfo( const std::string& sourcePath, uint64_t& size, uint64_t& time );
+
+private:
+	bool Validate( const unsigned char* data, size_t size ) const;
+};
@@ -0,0 +1,89 @@
+#include "CookedTexture.h"
+
+#include <GL/glew.h>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+CookedTexture::CookedTexture( const std::string& path )
+	: m_File( path ), m_Header( nullptr ), m_Levels( nullptr )
+{
+	if ( !m_File.IsOpen() )
+		return;
+
+	if ( !Validate() )
+	{
+		std::cout << "Invalid cooked texture " << path << std::endl;
+		return;
+	}
+
+	m_Header = reinterpret_cast< const CookedTextureHeader* >( m_File.GetData() );
+	m_Levels = reinterpret_cast< const CookedTextureLevel* >( m_File.GetData() + sizeof( CookedTextureHeader ) );
+}
+
+bool CookedTexture::IsCompressed() const
+{
+	return m_Header->InternalFormat == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+}
+
+bool CookedTexture::IsUpToDate( const std::string& sourcePath ) const
+{
+	uint64_t size, time;
+	return GetSourceInfo( sourcePath, size, time ) && size == m_Header->SourceSize && time == m_Header->SourceTime;
+}
+
+bool CookedTexture::GetSourceInfo( const std::string& sourcePath, uint64_t& size, uint64_t& time )
+{
+	namespace fs = std::filesystem;
+
+	std::error_code error;
+	size = fs::file_size( sourcePath, error );
+	if ( error )
+		return false;
+	time = (uint64_t) fs::last_write_time( sourcePath, error ).time_since_epoch().count();
+	return !error;
+}
+
+bool CookedTexture::Validate() const
+{
+	const size_t size = m_File.GetSize();
+	if ( size < sizeof( CookedTextureHeader ) )
+		return false;
+
+	const CookedTextureHeader* header = reinterpret_cast< const CookedTextureHeader* >( m_File.GetData() );
+	if ( std::memcmp( header->Magic, COOKED_TEXTURE_MAGIC, sizeof( COOKED_TEXTURE_MAGIC ) ) != 0
+		 || header->Version != COOKED_TEXTURE_VERSION
+		 || header->Levels == 0 || header->Levels > 32 || header->Width == 0 || header->Height == 0 )
+		return false;
+
+	const bool compressed = header->InternalFormat == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	if ( !compressed && ( header->InternalFormat != GL_RGBA8 || header->Format != GL_RGBA || header->Type != GL_UNSIGNED_BYTE ) )
+		return false;
+
+	const size_t tableEnd = sizeof( CookedTextureHeader ) + header->Levels * sizeof( CookedTextureLevel );
+	if ( size < tableEnd )
+		return false;
+
+	const CookedTextureLevel* levels = reinterpret_cast< const CookedTextureLevel* >( m_File.GetData() + sizeof( CookedTextureHeader ) );
+	for ( unsigned int i = 0; i < header->Levels; i++ )
+	{
+		// Every level halves the previous one, and the upload reads exactly its computed size.
+		const uint32_t width = std::max( 1u, header->Width >> i );
+		const uint32_t height = std::max( 1u, header->Height >> i );
+		const size_t levelSize = compressed ? (size_t) ( ( width + 3 ) / 4 ) * ( ( height + 3 ) / 4 ) * 16 : (size_t) width * height * 4;
+		if ( levels[i].Width != width || levels[i].Height != height || levels[i].Size != levelSize
+			 || levels[i].Offset < tableEnd || (size_t) levels[i].Offset + levels[i].Size > size )
+			return false;
+	}
+	return true;
+}
+
+std::string CookedTexture::GetCookedPath( const std::string& sourcePath )
+{
+	const size_t dot = sourcePath.find_last_of( '.' );
+	const size_t slash = sourcePath.find_last_of( "/\\" );
+	if ( dot == std::string::npos || ( slash != std::string::npos && dot < slash ) )
+		return sourcePath + ".ctex";
+	return sourcePath.substr( 0, dot ) + ".ctex";
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+#include "MappedFile.h"
+
+// Layout of a cooked texture (.ctex) file:
+// [CookedTextureHeader][CookedTextureLevel x Levels][level data...]
+// Levels are stored already flipped for OpenGL, largest first, each one
+// ready to be handed to glTexSubImage2D / glCompressedTexSubImage2D.
+struct CookedTextureHeader
+{
+	char Magic[4];
+	uint32_t Version;
+	// Size and modification time of the source, a cooked texture that does not match is stale.
+	uint64_t SourceSize;
+	uint64_t SourceTime;
+	uint32_t Width;
+	uint32_t Height;
+	uint32_t Levels;
+	uint32_t InternalFormat; // GL_RGBA8 or GL_COMPRESSED_RGBA_S3TC_DXT5_EXT.
+	uint32_t Format; // Client format of uncompressed levels.
+	uint32_t Type; // Client type of uncompressed levels.
+};
+
+struct CookedTextureLevel
+{
+	uint32_t Width;
+	uint32_t Height;
+	uint32_t Offset; // From the beginning of the file.
+	uint32_t Size;
+};
+
+static const char COOKED_TEXTURE_MAGIC[4] = { 'C', 'T', 'E', 'X' };
+static const uint32_t COOKED_TEXTURE_VERSION = 2;
+static const uint32_t COOKED_TEXTURE_ALIGNMENT = 16;
+
+class CookedTexture
+{
+private:
+	MappedFile m_File;
+	const CookedTextureHeader* m_Header;
+	const CookedTextureLevel* m_Levels;
+
+public:
+	CookedTexture( const std::string& path );
+
+	inline bool IsValid() const { return m_Header != nullptr; }
+	bool IsCompressed() const;
+	bool IsUpToDate( const std::string& sourcePath ) const;
+
+	inline const CookedTextureHeader& GetHeader() const { return *m_Header; }
+	inline const CookedTextureLevel& GetLevel( unsigned int level ) const { return m_Levels[level]; }
+	inline const void* GetLevelData( unsigned int level ) const { return m_File.GetData() + m_Levels[level].Offset; }
+
+	// "res/textures/phone.png" -> "res/textures/phone.ctex".
+	static std::string GetCookedPath( const std::string& sourcePath );
+	// Size and modification time as stored in the header, false when the file is missing.
+	static bool GetSourceInfo( const std::string& sourcePath, uint64_t& size, uint64_t& time );
+
+private:
+	bool Validate() const;
+};
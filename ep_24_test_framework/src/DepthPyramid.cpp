@@ -0,0 +1,49 @@
+#include "DepthPyramid.h"
+#include "Renderer.h"
+#include "Texture.h"
+#include "Debug.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Matches local_size_x and local_size_y in DepthPyramid.shader.
+static const unsigned int GROUP_SIZE = 8;
+
+DepthPyramid::DepthPyramid()
+	: m_Shader( "res/shaders/DepthPyramid.shader" )
+{
+}
+
+DepthPyramid::~DepthPyramid()
+{
+}
+
+void DepthPyramid::Build( const Renderer& renderer, const Texture& depth )
+{
+	const int width = std::max( 1, depth.GetWidth() / 2 );
+	const int height = std::max( 1, depth.GetHeight() / 2 );
+	if ( !m_Texture || m_Texture->GetWidth() != width || m_Texture->GetHeight() != height )
+	{
+		const unsigned int levels = (unsigned int) std::floor( std::log2( (float) std::max( width, height ) ) ) + 1;
+		m_Texture = std::make_unique< Texture >( width, height, GL_R32F, nullptr, levels );
+	}
+
+	m_Shader.Bind();
+	m_Shader.SetUniform1i( "u_Input", 0 );
+	for ( unsigned int level = 0; level < m_Texture->GetLevels(); level++ )
+	{
+		// Level 0 reads the depth texture, every other level the one above it.
+		if ( level == 0 )
+			depth.Bind( 0 );
+		else
+			m_Texture->Bind( 0 );
+		m_Shader.SetUniform1i( "u_InputLevel", level == 0 ? 0 : (int) level - 1 );
+		GLCall( glBindImageTexture( 0, m_Texture->GetRendererID(), level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F ) );
+
+		const unsigned int levelWidth = std::max( 1, width >> level );
+		const unsigned int levelHeight = std::max( 1, height >> level );
+		renderer.Dispatch( m_Shader, ( levelWidth + GROUP_SIZE - 1 ) / GROUP_SIZE, ( levelHeight + GROUP_SIZE - 1 ) / GROUP_SIZE );
+		GLCall( glMemoryBarrier( GL_TEXTURE_FETCH_BARRIER_BIT ) );
+	}
+	GLCall( glBindImageTexture( 0, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F ) );
+}
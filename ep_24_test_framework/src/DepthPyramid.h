@@ -0,0 +1,34 @@
+#pragma once
+
+#include <memory>
+
+#include "Shader.h"
+
+class Renderer;
+class Texture;
+
+// Hierarchical depth buffer (Hi-Z) for occlusion culling on the GPU: an R32F mip chain
+// where every texel holds the farthest depth of the depth texels it covers, so a box
+// whose nearest depth is farther than one texel of the right level is hidden.
+// Level 0 is half the size of the depth texture, built with res/shaders/DepthPyramid.shader
+// (GL 4.3, see Renderer::IsComputeSupported).
+class DepthPyramid
+{
+private:
+	Shader m_Shader;
+	std::unique_ptr< Texture > m_Texture;
+
+public:
+	DepthPyramid();
+	~DepthPyramid();
+
+	DepthPyramid( const DepthPyramid& ) = delete;
+	DepthPyramid& operator=( const DepthPyramid& ) = delete;
+
+	// Rebuilds every level from "depth", reallocating the pyramid when its size changed.
+	// Texture fetches issued afterwards see the result.
+	void Build( const Renderer& renderer, const Texture& depth );
+
+	// Null until the first Build.
+	inline const Texture* GetTexture() const { return m_Texture.get(); }
+};
@@ -0,0 +1,64 @@
+#include "FrameBuffer.h"
+#include "Texture.h"
+#include "Debug.h"
+
+#include <utility>
+
+FrameBuffer::FrameBuffer( const Texture& colorAttachment, const Texture* depthAttachment )
+	: m_RendererID( 0 ), m_Width( colorAttachment.GetWidth() ), m_Height( colorAttachment.GetHeight() )
+{
+	GLCall( glGenFramebuffers( 1, &m_RendererID ) );
+	GLCall( glBindFramebuffer( GL_FRAMEBUFFER, m_RendererID ) );
+	GLCall( glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorAttachment.GetRendererID(), 0 ) );
+	if ( depthAttachment )
+	{
+		GLCall( glFramebufferTexture2D( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthAttachment->GetRendererID(), 0 ) );
+	}
+
+	GLCall( GLenum status = glCheckFramebufferStatus( GL_FRAMEBUFFER ) );
+	if ( status != GL_FRAMEBUFFER_COMPLETE )
+		std::cout << "Framebuffer is not complete: " << status << std::endl;
+
+	Unbind();
+}
+
+FrameBuffer::~FrameBuffer()
+{
+	GLCall( glDeleteFramebuffers( 1, &m_RendererID ) );
+}
+
+FrameBuffer::FrameBuffer( FrameBuffer&& other ) noexcept
+	: m_RendererID( std::exchange( other.m_RendererID, 0 ) ), m_Width( std::exchange( other.m_Width, 0 ) ), m_Height( std::exchange( other.m_Height, 0 ) )
+{
+}
+
+FrameBuffer& FrameBuffer::operator=( FrameBuffer&& other ) noexcept
+{
+	if ( this != &other )
+	{
+		GLCall( glDeleteFramebuffers( 1, &m_RendererID ) );
+		m_RendererID = std::exchange( other.m_RendererID, 0 );
+		m_Width = std::exchange( other.m_Width, 0 );
+		m_Height = std::exchange( other.m_Height, 0 );
+	}
+	return *this;
+}
+
+void FrameBuffer::Bind() const
+{
+	GLCall( glBindFramebuffer( GL_FRAMEBUFFER, m_RendererID ) );
+	GLCall( glViewport( 0, 0, m_Width, m_Height ) );
+}
+
+void FrameBuffer::Unbind() const
+{
+	GLCall( glBindFramebuffer( GL_FRAMEBUFFER, 0 ) );
+}
+
+void FrameBuffer::BlitToScreen( int width, int height ) const
+{
+	GLCall( glBindFramebuffer( GL_READ_FRAMEBUFFER, m_RendererID ) );
+	GLCall( glBindFramebuffer( GL_DRAW_FRAMEBUFFER, 0 ) );
+	GLCall( glBlitFramebuffer( 0, 0, m_Width, m_Height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_LINEAR ) );
+	GLCall( glBindFramebuffer( GL_FRAMEBUFFER, 0 ) );
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+class Texture;
+
+// Framebuffer object rendering into a single color texture, optionally with a depth texture.
+class FrameBuffer
+{
+private:
+	unsigned int m_RendererID;
+	int m_Width, m_Height;
+
+public:
+	FrameBuffer( const Texture& colorAttachment, const Texture* depthAttachment = nullptr );
+	~FrameBuffer();
+
+	// Move-only, a moved-from framebuffer owns no GL name.
+	FrameBuffer( const FrameBuffer& ) = delete;
+	FrameBuffer& operator=( const FrameBuffer& ) = delete;
+	FrameBuffer( FrameBuffer&& other ) noexcept;
+	FrameBuffer& operator=( FrameBuffer&& other ) noexcept;
+
+	// Binds the framebuffer and sets the viewport to cover it.
+	void Bind() const;
+	void Unbind() const;
+	// Copies the color attachment to the default framebuffer, stretched to "width" x "height".
+	void BlitToScreen( int width, int height ) const;
+
+	inline int GetWidth() const { return m_Width; }
+	inline int GetHeight() const { return m_Height; }
+};
@@ -0,0 +1,126 @@
+#include "Frustum.h"
+
+#if defined( __AVX__ )
+#include <immintrin.h>
+#define FRUSTUM_AVX
+#define FRUSTUM_SSE
+#elif defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define FRUSTUM_SSE
+#endif
+
+size_t BoundingSpheres::Add( const glm::vec3& center, float radius )
+{
+	X.push_back( center.x );
+	Y.push_back( center.y );
+	Z.push_back( center.z );
+	Radius.push_back( radius );
+	return X.size() - 1;
+}
+
+void BoundingSpheres::Set( size_t index, const glm::vec3& center, float radius )
+{
+	X[index] = center.x;
+	Y[index] = center.y;
+	Z[index] = center.z;
+	Radius[index] = radius;
+}
+
+void BoundingSpheres::Clear()
+{
+	X.clear();
+	Y.clear();
+	Z.clear();
+	Radius.clear();
+}
+
+Frustum::Frustum( const glm::mat4& viewProjection )
+{
+	// Rows of the matrix, glm stores columns.
+	const glm::mat4 m = glm::transpose( viewProjection );
+	for ( int i = 0; i < 3; i++ )
+	{
+		Planes[i * 2] = m[3] + m[i];
+		Planes[i * 2 + 1] = m[3] - m[i];
+	}
+	for ( glm::vec4& plane : Planes )
+		plane /= glm::length( glm::vec3( plane ) );
+}
+
+bool Frustum::IntersectsSphere( const glm::vec3& center, float radius ) const
+{
+	for ( const glm::vec4& plane : Planes )
+		if ( glm::dot( glm::vec3( plane ), center ) + plane.w < -radius )
+			return false;
+	return true;
+}
+
+size_t Frustum::CullSpheres( const BoundingSpheres& spheres, uint32_t* visible ) const
+{
+	const size_t count = spheres.GetCount();
+	const float* x = spheres.X.data();
+	const float* y = spheres.Y.data();
+	const float* z = spheres.Z.data();
+	const float* radius = spheres.Radius.data();
+	size_t visibleCount = 0;
+	size_t i = 0;
+
+#ifdef FRUSTUM_AVX
+	{
+		__m256 planes[6][4];
+		for ( int p = 0; p < 6; p++ )
+			for ( int c = 0; c < 4; c++ )
+				planes[p][c] = _mm256_set1_ps( Planes[p][c] );
+
+		for ( ; i + 8 <= count; i += 8 )
+		{
+			const __m256 sx = _mm256_loadu_ps( x + i ), sy = _mm256_loadu_ps( y + i ), sz = _mm256_loadu_ps( z + i );
+			const __m256 negativeRadius = _mm256_sub_ps( _mm256_setzero_ps(), _mm256_loadu_ps( radius + i ) );
+			__m256 inside = _mm256_castsi256_ps( _mm256_set1_epi32( -1 ) );
+			for ( int p = 0; p < 6; p++ )
+			{
+				const __m256 distance = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( planes[p][0], sx ), _mm256_mul_ps( planes[p][1], sy ) ),
+													   _mm256_add_ps( _mm256_mul_ps( planes[p][2], sz ), planes[p][3] ) );
+				inside = _mm256_and_ps( inside, _mm256_cmp_ps( distance, negativeRadius, _CMP_GE_OQ ) );
+			}
+
+			const int mask = _mm256_movemask_ps( inside );
+			for ( int lane = 0; mask >> lane; lane++ )
+				if ( mask & ( 1 << lane ) )
+					visible[visibleCount++] = (uint32_t) ( i + lane );
+		}
+	}
+#endif
+
+#ifdef FRUSTUM_SSE
+	{
+		__m128 planes[6][4];
+		for ( int p = 0; p < 6; p++ )
+			for ( int c = 0; c < 4; c++ )
+				planes[p][c] = _mm_set1_ps( Planes[p][c] );
+
+		for ( ; i + 4 <= count; i += 4 )
+		{
+			const __m128 sx = _mm_loadu_ps( x + i ), sy = _mm_loadu_ps( y + i ), sz = _mm_loadu_ps( z + i );
+			const __m128 negativeRadius = _mm_sub_ps( _mm_setzero_ps(), _mm_loadu_ps( radius + i ) );
+			__m128 inside = _mm_castsi128_ps( _mm_set1_epi32( -1 ) );
+			for ( int p = 0; p < 6; p++ )
+			{
+				const __m128 distance = _mm_add_ps( _mm_add_ps( _mm_mul_ps( planes[p][0], sx ), _mm_mul_ps( planes[p][1], sy ) ),
+													_mm_add_ps( _mm_mul_ps( planes[p][2], sz ), planes[p][3] ) );
+				inside = _mm_and_ps( inside, _mm_cmpge_ps( distance, negativeRadius ) );
+			}
+
+			const int mask = _mm_movemask_ps( inside );
+			for ( int lane = 0; mask >> lane; lane++ )
+				if ( mask & ( 1 << lane ) )
+					visible[visibleCount++] = (uint32_t) ( i + lane );
+		}
+	}
+#endif
+
+	for ( ; i < count; i++ )
+		if ( IntersectsSphere( glm::vec3( x[i], y[i], z[i] ), radius[i] ) )
+			visible[visibleCount++] = (uint32_t) i;
+	return visibleCount;
+}
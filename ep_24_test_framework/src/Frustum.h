@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+// Bounding spheres of many objects, one array per component, the layout
+// Frustum::CullSpheres reads four or eight at a time.
+struct BoundingSpheres
+{
+	std::vector< float > X, Y, Z, Radius;
+
+	inline size_t GetCount() const { return X.size(); }
+	// Returns the index of the new sphere.
+	size_t Add( const glm::vec3& center, float radius );
+	void Set( size_t index, const glm::vec3& center, float radius );
+	void Clear();
+};
+
+// View frustum as six world space planes taken from a view-projection matrix (Gribb
+// and Hartmann). Planes are normalized, dot( plane.xyz, p ) + plane.w is the signed
+// distance of "p", positive inside. The order matches u_FrustumPlanes in the culling shaders.
+struct Frustum
+{
+	// Left, right, bottom, top, near, far.
+	glm::vec4 Planes[6];
+
+	Frustum( const glm::mat4& viewProjection );
+
+	bool IntersectsSphere( const glm::vec3& center, float radius ) const;
+	// Writes the index of every sphere that intersects the frustum to "visible", which
+	// must hold GetCount() indices, and returns how many there are. Tests eight spheres
+	// per instruction with AVX (/arch:AVX), four with SSE2, the remainder one by one.
+	size_t CullSpheres( const BoundingSpheres& spheres, uint32_t* visible ) const;
+};
@@ -0,0 +1,189 @@
+#include "GpuHeap.h"
+#include "Renderer.h"
+#include "Shader.h"
+#include "Debug.h"
+
+#include <algorithm>
+
+GpuHeap::GpuHeap( const VertexBufferLayout& layout, unsigned int vertexCapacity, unsigned int indexCapacity, float defragThreshold )
+	: m_Layout( layout ), m_Stride( layout.GetStride() ),
+	m_vb( nullptr, vertexCapacity * layout.GetStride(), BufferUsage::Dynamic ),
+	m_ib( BufferUsage::Dynamic, GL_UNSIGNED_INT, indexCapacity ),
+	m_va(),
+	m_VertexAllocator( vertexCapacity ), m_IndexAllocator( indexCapacity ),
+	m_MeshCount( 0 ), m_DefragThreshold( defragThreshold ), m_Defrags( 0 )
+{
+	m_va.AddBuffer( m_vb, m_Layout );
+	m_va.Unbind();
+}
+
+unsigned int GpuHeap::AddMesh( const void* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount )
+{
+	Entry entry;
+	entry.Vertices = Allocate( m_VertexAllocator, vertexCount, true );
+	entry.Indices = Allocate( m_IndexAllocator, indexCount, false );
+	entry.Live = true;
+
+	m_vb.SetSubData( entry.Vertices.Offset * m_Stride, vertices, vertexCount * m_Stride );
+	m_ib.SetSubData( entry.Indices.Offset, indices, indexCount );
+
+	unsigned int id;
+	if ( !m_FreeIds.empty() )
+	{
+		id = m_FreeIds.back();
+		m_FreeIds.pop_back();
+		m_Meshes[id] = entry;
+	}
+	else
+	{
+		id = (unsigned int) m_Meshes.size();
+		m_Meshes.push_back( entry );
+	}
+	m_MeshCount++;
+	return id;
+}
+
+void GpuHeap::RemoveMesh( unsigned int id )
+{
+	ASSERT( id < m_Meshes.size() && m_Meshes[id].Live );
+
+	Entry& entry = m_Meshes[id];
+	m_VertexAllocator.Free( entry.Vertices );
+	m_IndexAllocator.Free( entry.Indices );
+	entry.Live = false;
+	m_FreeIds.push_back( id );
+	m_MeshCount--;
+
+	if ( IsFragmented( m_VertexAllocator ) || IsFragmented( m_IndexAllocator ) )
+		Defragment();
+}
+
+GpuMesh GpuHeap::GetMesh( unsigned int id ) const
+{
+	const Entry& entry = m_Meshes[id];
+	GpuMesh mesh;
+	mesh.Vertices = { m_vb.GetRendererID(), entry.Vertices.Offset * m_Stride, entry.Vertices.Size * m_Stride };
+	mesh.Indices = { m_ib.GetRendererID(), entry.Indices.Offset * m_ib.GetIndexSize(), entry.Indices.Size * m_ib.GetIndexSize() };
+	mesh.BaseVertex = (int) entry.Vertices.Offset;
+	mesh.FirstIndex = entry.Indices.Offset;
+	mesh.IndexCount = entry.Indices.Size;
+	return mesh;
+}
+
+void GpuHeap::Draw( const Renderer& renderer, unsigned int id, const Shader& shader ) const
+{
+	const Entry& entry = m_Meshes[id];
+	renderer.Draw( m_va, m_ib, shader, entry.Indices.Size, entry.Indices.Offset, (int) entry.Vertices.Offset );
+}
+
+DrawElementsIndirectCommand GpuHeap::GetDrawCommand( unsigned int id, unsigned int drawIndex ) const
+{
+	const Entry& entry = m_Meshes[id];
+	return { entry.Indices.Size, 1, entry.Indices.Offset, (int32_t) entry.Vertices.Offset, drawIndex };
+}
+
+bool GpuHeap::IsFragmented( const OffsetAllocator& allocator ) const
+{
+	// Small amounts of free space are not worth moving everything for.
+	return allocator.GetFreeSize() > allocator.GetSize() / 8 && allocator.GetFragmentation() > m_DefragThreshold;
+}
+
+OffsetAllocator::Allocation GpuHeap::Allocate( OffsetAllocator& allocator, unsigned int size, bool vertices )
+{
+	OffsetAllocator::Allocation allocation = allocator.Allocate( size );
+	if ( allocation.Offset != OffsetAllocator::INVALID )
+		return allocation;
+
+	// Enough space in total, just not in one block.
+	if ( allocator.GetFreeSize() >= size )
+	{
+		Compact( allocator, vertices );
+		allocation = allocator.Allocate( size );
+		if ( allocation.Offset != OffsetAllocator::INVALID )
+			return allocation;
+	}
+
+	// Geometric growth, the buffer keeps its name so the vertex array stays valid.
+	const unsigned int capacity = std::max( allocator.GetSize() * 2, allocator.GetSize() + size );
+	if ( vertices )
+		m_vb.Resize( capacity * m_Stride );
+	else
+		m_ib.Resize( capacity );
+	allocator.Grow( capacity - allocator.GetSize() );
+	return allocator.Allocate( size );
+}
+
+void GpuHeap::Defragment()
+{
+	Compact( m_VertexAllocator, true );
+	Compact( m_IndexAllocator, false );
+}
+
+void GpuHeap::Compact( OffsetAllocator& allocator, bool vertices )
+{
+	OffsetAllocator::Allocation Entry::* member = vertices ? &Entry::Vertices : &Entry::Indices;
+	const unsigned int unitSize = vertices ? m_Stride : m_ib.GetIndexSize();
+	const unsigned int buffer = vertices ? m_vb.GetRendererID() : m_ib.GetRendererID();
+	m_Defrags++;
+
+	// Live meshes in buffer order, so every move is towards the front.
+	std::vector< Entry* > meshes;
+	for ( Entry& entry : m_Meshes )
+	{
+		if ( entry.Live )
+			meshes.push_back( &entry );
+	}
+	std::sort( meshes.begin(), meshes.end(), [member]( const Entry* a, const Entry* b ) { return ( a->*member ).Offset < ( b->*member ).Offset; } );
+
+	const unsigned int used = allocator.GetSize() - allocator.GetFreeSize();
+	if ( used == 0 )
+	{
+		allocator.Reset();
+		return;
+	}
+
+	// Ranges of one buffer may not overlap in a copy, so pack into a scratch buffer and copy back.
+	// With direct state access the copies go by name and no binding changes.
+	const bool named = Renderer::IsDirectStateAccessSupported();
+	unsigned int scratch;
+	if ( named )
+	{
+		GLCall( glCreateBuffers( 1, &scratch ) );
+		GLCall( glNamedBufferData( scratch, used * unitSize, nullptr, GL_STREAM_COPY ) );
+	}
+	else
+	{
+		GLCall( glGenBuffers( 1, &scratch ) );
+		GLCall( glBindBuffer( GL_COPY_WRITE_BUFFER, scratch ) );
+		GLCall( glBufferData( GL_COPY_WRITE_BUFFER, used * unitSize, nullptr, GL_STREAM_COPY ) );
+		GLCall( glBindBuffer( GL_COPY_READ_BUFFER, buffer ) );
+	}
+
+	allocator.Reset();
+	for ( Entry* entry : meshes )
+	{
+		OffsetAllocator::Allocation& allocation = entry->*member;
+		const OffsetAllocator::Allocation moved = allocator.Allocate( allocation.Size );
+		if ( named )
+		{
+			GLCall( glCopyNamedBufferSubData( buffer, scratch, allocation.Offset * unitSize, moved.Offset * unitSize, allocation.Size * unitSize ) );
+		}
+		else
+		{
+			GLCall( glCopyBufferSubData( GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, allocation.Offset * unitSize, moved.Offset * unitSize, allocation.Size * unitSize ) );
+		}
+		allocation = moved;
+	}
+
+	if ( named )
+	{
+		GLCall( glCopyNamedBufferSubData( scratch, buffer, 0, 0, used * unitSize ) );
+	}
+	else
+	{
+		GLCall( glBindBuffer( GL_COPY_READ_BUFFER, scratch ) );
+		GLCall( glBindBuffer( GL_COPY_WRITE_BUFFER, buffer ) );
+		GLCall( glCopyBufferSubData( GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, used * unitSize ) );
+	}
+	GLCall( glDeleteBuffers( 1, &scratch ) );
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <vector>
+
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+#include "IndexBuffer.h"
+#include "VertexBufferLayout.h"
+#include "OffsetAllocator.h"
+#include "Renderer.h"
+
+class Shader;
+
+// Range of a buffer owned by a GpuHeap, in bytes.
+struct GpuAllocation
+{
+	unsigned int Buffer;
+	unsigned int Offset;
+	unsigned int Size;
+};
+
+// Where a mesh lives in its heap, indices are relative to BaseVertex.
+struct GpuMesh
+{
+	GpuAllocation Vertices;
+	GpuAllocation Indices;
+	int BaseVertex;
+	unsigned int FirstIndex;
+	unsigned int IndexCount;
+};
+
+// Many meshes with the same vertex layout packed into one vertex buffer and one
+// index buffer, so they all draw from one vertex array with glDrawElementsBaseVertex.
+// Space is handed out by an OffsetAllocator per buffer. Buffers grow when full and
+// are compacted when their free space becomes too fragmented; meshes are referred
+// to by id because compaction moves them.
+class GpuHeap
+{
+private:
+	struct Entry
+	{
+		OffsetAllocator::Allocation Vertices;
+		OffsetAllocator::Allocation Indices;
+		bool Live;
+	};
+
+	VertexBufferLayout m_Layout;
+	unsigned int m_Stride;
+	VertexBuffer m_vb;
+	IndexBuffer m_ib;
+	VertexArray m_va;
+	// In vertices and in indices.
+	OffsetAllocator m_VertexAllocator;
+	OffsetAllocator m_IndexAllocator;
+
+	std::vector< Entry > m_Meshes;
+	std::vector< unsigned int > m_FreeIds;
+	unsigned int m_MeshCount;
+	float m_DefragThreshold;
+	unsigned int m_Defrags;
+
+public:
+	// Compacts a buffer once more than "defragThreshold" of its free space is outside the largest free block.
+	GpuHeap( const VertexBufferLayout& layout, unsigned int vertexCapacity, unsigned int indexCapacity, float defragThreshold = 0.5f );
+
+	// Copies the mesh into the heap and returns its id.
+	unsigned int AddMesh( const void* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount );
+	void RemoveMesh( unsigned int id );
+	GpuMesh GetMesh( unsigned int id ) const;
+
+	void Draw( const Renderer& renderer, unsigned int id, const Shader& shader ) const;
+	// Command drawing the mesh once, for Renderer::MultiDrawIndirect with the heap's vertex
+	// buffer and index buffer. Its BaseInstance is "drawIndex", the command's index in the
+	// multi-draw, for shaders reading their draw ID from an instanced attribute.
+	// Only valid until the heap changes, compaction moves meshes.
+	DrawElementsIndirectCommand GetDrawCommand( unsigned int id, unsigned int drawIndex = 0 ) const;
+
+	// Moves every mesh to the front of the buffers, leaving all free space in one block.
+	void Defragment();
+
+	inline const VertexArray& GetVertexArray() const { return m_va; }
+	inline const VertexBuffer& GetVertexBuffer() const { return m_vb; }
+	inline const VertexBufferLayout& GetLayout() const { return m_Layout; }
+	inline const IndexBuffer& GetIndexBuffer() const { return m_ib; }
+	inline const OffsetAllocator& GetVertexAllocator() const { return m_VertexAllocator; }
+	inline const OffsetAllocator& GetIndexAllocator() const { return m_IndexAllocator; }
+	inline unsigned int GetMeshCount() const { return m_MeshCount; }
+	// Buffers compacted so far, by Defragment or by an allocation that only fit after compacting.
+	inline unsigned int GetDefragCount() const { return m_Defrags; }
+
+private:
+	bool IsFragmented( const OffsetAllocator& allocator ) const;
+	OffsetAllocator::Allocation Allocate( OffsetAllocator& allocator, unsigned int size, bool vertices );
+	void Compact( OffsetAllocator& allocator, bool vertices );
+};
@@ -0,0 +1,152 @@
+#include "HashedGrid.h"
+#include "Debug.h"
+
+#include <algorithm>
+#include <cmath>
+
+HashedGrid::HashedGrid( float cellSize )
+	: m_CellSize( std::max( cellSize, 1e-6f ) ), m_Count( 0 )
+{
+}
+
+// Cell coordinates are clamped well inside int, so huge or infinite bounds neither
+// overflow the conversion nor the cell counts of Query.
+static const float MAX_CELL = (float) ( 1 << 29 );
+
+static int GetCell( float coordinate, float cellSize )
+{
+	return (int) std::min( std::max( std::floor( coordinate / cellSize ), -MAX_CELL ), MAX_CELL );
+}
+
+HashedGrid::CellRange HashedGrid::GetCells( const Bounds2D& bounds ) const
+{
+	return { GetCell( bounds.Min.x, m_CellSize ), GetCell( bounds.Min.y, m_CellSize ),
+			 GetCell( bounds.Max.x, m_CellSize ), GetCell( bounds.Max.y, m_CellSize ) };
+}
+
+void HashedGrid::AddToCells( uint32_t id, const CellRange& cells )
+{
+	if ( CountCells( cells ) > MAX_OBJECT_CELLS )
+	{
+		m_Oversized.push_back( id );
+		return;
+	}
+
+	for ( int y = cells.MinY; y <= cells.MaxY; y++ )
+		for ( int x = cells.MinX; x <= cells.MaxX; x++ )
+			m_Cells[GetKey( x, y )].push_back( id );
+}
+
+void HashedGrid::RemoveFromCells( uint32_t id, const CellRange& cells )
+{
+	if ( CountCells( cells ) > MAX_OBJECT_CELLS )
+	{
+		auto it = std::find( m_Oversized.begin(), m_Oversized.end(), id );
+		ASSERT( it != m_Oversized.end() );
+		*it = m_Oversized.back();
+		m_Oversized.pop_back();
+		return;
+	}
+
+	for ( int y = cells.MinY; y <= cells.MaxY; y++ )
+		for ( int x = cells.MinX; x <= cells.MaxX; x++ )
+		{
+			auto cell = m_Cells.find( GetKey( x, y ) );
+			ASSERT( cell != m_Cells.end() );
+			std::vector< uint32_t >& ids = cell->second;
+			auto it = std::find( ids.begin(), ids.end(), id );
+			*it = ids.back();
+			ids.pop_back();
+			// Empty cells go, so objects wandering far do not leave a trail of them.
+			if ( ids.empty() )
+				m_Cells.erase( cell );
+		}
+}
+
+void HashedGrid::Insert( uint32_t id, const Bounds2D& bounds )
+{
+	if ( id >= m_Items.size() )
+		m_Items.resize( id + 1, { {}, {}, false } );
+	ASSERT( !m_Items[id].Live );
+
+	Item& item = m_Items[id];
+	item.Bounds = bounds;
+	item.Cells = GetCells( bounds );
+	item.Live = true;
+	AddToCells( id, item.Cells );
+	m_Count++;
+}
+
+void HashedGrid::Update( uint32_t id, const Bounds2D& bounds )
+{
+	ASSERT( id < m_Items.size() && m_Items[id].Live );
+
+	Item& item = m_Items[id];
+	item.Bounds = bounds;
+	const CellRange cells = GetCells( bounds );
+	if ( cells == item.Cells )
+		return;
+	RemoveFromCells( id, item.Cells );
+	item.Cells = cells;
+	AddToCells( id, cells );
+}
+
+void HashedGrid::Remove( uint32_t id )
+{
+	if ( id >= m_Items.size() || !m_Items[id].Live )
+		return;
+	RemoveFromCells( id, m_Items[id].Cells );
+	m_Items[id].Live = false;
+	m_Count--;
+}
+
+void HashedGrid::Clear()
+{
+	m_Cells.clear();
+	m_Items.clear();
+	m_Oversized.clear();
+	m_Count = 0;
+}
+
+void HashedGrid::Query( const Bounds2D& area, std::vector< uint32_t >& results ) const
+{
+	// Oversized objects are in no cell, so they are never reported twice.
+	for ( uint32_t id : m_Oversized )
+	{
+		if ( m_Items[id].Bounds.Overlaps( area ) )
+			results.push_back( id );
+	}
+
+	const CellRange range = GetCells( area );
+	const uint64_t cellCount = CountCells( range );
+
+	// Areas covering more cells than are occupied are cheaper to answer from the occupied ones.
+	if ( cellCount > m_Cells.size() )
+	{
+		for ( const auto& cell : m_Cells )
+		{
+			const int x = (int) (uint32_t) ( cell.first >> 32 ), y = (int) (uint32_t) cell.first;
+			if ( x >= range.MinX && x <= range.MaxX && y >= range.MinY && y <= range.MaxY )
+				QueryCell( x, y, cell.second, range, area, results );
+		}
+		return;
+	}
+
+	for ( int y = range.MinY; y <= range.MaxY; y++ )
+		for ( int x = range.MinX; x <= range.MaxX; x++ )
+		{
+			const auto cell = m_Cells.find( GetKey( x, y ) );
+			if ( cell != m_Cells.end() )
+				QueryCell( x, y, cell->second, range, area, results );
+		}
+}
+
+void HashedGrid::QueryCell( int x, int y, const std::vector< uint32_t >& ids, const CellRange& range, const Bounds2D& area, std::vector< uint32_t >& results ) const
+{
+	for ( uint32_t id : ids )
+	{
+		const Item& item = m_Items[id];
+		if ( std::max( item.Cells.MinX, range.MinX ) == x && std::max( item.Cells.MinY, range.MinY ) == y && item.Bounds.Overlaps( area ) )
+			results.push_back( id );
+	}
+}
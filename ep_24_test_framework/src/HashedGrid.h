@@ -0,0 +1,69 @@
+#pragma once
+
+#include <unordered_map>
+
+#include "SpatialIndex.h"
+
+// Uniform grid of square cells with only the occupied cells stored, in a hash map
+// keyed by cell coordinates, so the world is unbounded. Objects are listed in every
+// cell they overlap. Objects that move without changing cells only update their bounds.
+// An object spanning several cells is reported by the first of them inside the query,
+// so queries need no duplicate removal and stay const. Objects covering more than
+// MAX_OBJECT_CELLS cells, e.g. a background spanning the map, are kept in a separate
+// list every query scans, so huge bounds never loop over millions of cells.
+class HashedGrid : public SpatialIndex
+{
+public:
+	static constexpr uint64_t MAX_OBJECT_CELLS = 256;
+
+private:
+	struct CellRange
+	{
+		int MinX, MinY, MaxX, MaxY;
+
+		inline bool operator==( const CellRange& other ) const
+		{
+			return MinX == other.MinX && MinY == other.MinY && MaxX == other.MaxX && MaxY == other.MaxY;
+		}
+	};
+
+	struct Item
+	{
+		Bounds2D Bounds;
+		CellRange Cells;
+		bool Live;
+	};
+
+	float m_CellSize;
+	std::unordered_map< uint64_t, std::vector< uint32_t > > m_Cells;
+	std::vector< Item > m_Items;
+	std::vector< uint32_t > m_Oversized;
+	size_t m_Count;
+
+public:
+	HashedGrid( float cellSize );
+
+	void Insert( uint32_t id, const Bounds2D& bounds ) override;
+	void Update( uint32_t id, const Bounds2D& bounds ) override;
+	void Remove( uint32_t id ) override;
+	void Clear() override;
+	void Query( const Bounds2D& area, std::vector< uint32_t >& results ) const override;
+	inline size_t GetCount() const override { return m_Count; }
+
+	inline size_t GetCellCount() const { return m_Cells.size(); }
+	inline size_t GetOversizedCount() const { return m_Oversized.size(); }
+
+private:
+	CellRange GetCells( const Bounds2D& bounds ) const;
+	// Lists the object in its cells, or with the oversized objects.
+	void AddToCells( uint32_t id, const CellRange& cells );
+	void RemoveFromCells( uint32_t id, const CellRange& cells );
+	// Reports the objects of one cell whose first cell inside "range" is this one.
+	void QueryCell( int x, int y, const std::vector< uint32_t >& ids, const CellRange& range, const Bounds2D& area, std::vector< uint32_t >& results ) const;
+
+	static inline uint64_t GetKey( int x, int y ) { return ( (uint64_t) (uint32_t) x << 32 ) | (uint32_t) y; }
+	static inline uint64_t CountCells( const CellRange& cells )
+	{
+		return (uint64_t) ( cells.MaxX - cells.MinX + 1 ) * (uint64_t) ( cells.MaxY - cells.MinY + 1 );
+	}
+};
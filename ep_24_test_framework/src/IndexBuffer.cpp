@@ -2,28 +2,152 @@
 #include "Renderer.h"
 #include "Debug.h"
 
-IndexBuffer::IndexBuffer( const unsigned int* indices, unsigned int count )
+#include <algorithm>
+#include <utility>
+
+template< typename Target, typename Source >
+static void ConvertIndices( const Source* indices, unsigned int count, unsigned char* out )
+{
+	Target* target = reinterpret_cast< Target* >( out );
+	for ( unsigned int i = 0; i < count; i++ )
+		target[i] = (Target) indices[i];
+}
+
+template< typename T >
+static unsigned int GetTypeOf()
+{
+	return sizeof( T ) == 1 ? GL_UNSIGNED_BYTE : sizeof( T ) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+
+IndexBuffer::IndexBuffer( const uint32_t* indices, unsigned int count, BufferUsage usage, unsigned int type )
+	: IndexBuffer( usage, type )
+{
+	SetData( indices, count );
+}
+
+IndexBuffer::IndexBuffer( const uint16_t* indices, unsigned int count, BufferUsage usage )
+	: IndexBuffer( usage, GL_UNSIGNED_SHORT )
+{
+	SetData( indices, count );
+}
+
+IndexBuffer::IndexBuffer( const uint8_t* indices, unsigned int count, BufferUsage usage )
+	: IndexBuffer( usage, GL_UNSIGNED_BYTE )
+{
+	SetData( indices, count );
+}
+
+IndexBuffer::IndexBuffer( BufferUsage usage, unsigned int type, unsigned int count )
 	:
-	m_Count( count )
+	Buffer( GL_ELEMENT_ARRAY_BUFFER, nullptr, count * GetSizeOfType( type ? type : GL_UNSIGNED_SHORT ), usage ),
+	m_Count( count ),
+	m_Type( type ? type : GL_UNSIGNED_SHORT ),
+	m_AutoType( type == 0 )
+{
+}
+
+IndexBuffer::IndexBuffer( IndexBuffer&& other ) noexcept
+	: Buffer( std::move( other ) ), m_Count( std::exchange( other.m_Count, 0 ) ), m_Type( other.m_Type ), m_AutoType( other.m_AutoType )
+{
+}
+
+IndexBuffer& IndexBuffer::operator=( IndexBuffer&& other ) noexcept
 {
-	ASSERT( sizeof( unsigned int ) == sizeof( GLuint ) );
+	Buffer::operator=( std::move( other ) );
+	m_Count = std::exchange( other.m_Count, 0 );
+	m_Type = other.m_Type;
+	m_AutoType = other.m_AutoType;
+	return *this;
+}
+
+template< typename T >
+void IndexBuffer::Upload( bool replace, unsigned int first, const T* indices, unsigned int count )
+{
+	const unsigned int maxIndex = ( indices && count > 0 ) ? *std::max_element( indices, indices + count ) : 0;
+	if ( replace && m_AutoType )
+	{
+		m_Type = maxIndex > 0xFFFF ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+	}
+	else if ( GetSizeOfType( m_Type ) < 4 && maxIndex >= ( 1u << ( 8 * GetSizeOfType( m_Type ) ) ) )
+	{
+		std::cout << "Index " << maxIndex << " does not fit the index buffer's " << 8 * GetSizeOfType( m_Type ) << " bit indices" << std::endl;
+		ASSERT( false );
+	}
+
+	// Same width, upload as is.
+	const void* data = indices;
+	if ( indices && GetTypeOf< T >() != m_Type )
+	{
+		m_Scratch.resize( count * GetIndexSize() );
+		switch ( m_Type )
+		{
+			case GL_UNSIGNED_BYTE: ConvertIndices< uint8_t >( indices, count, m_Scratch.data() ); break;
+			case GL_UNSIGNED_SHORT: ConvertIndices< uint16_t >( indices, count, m_Scratch.data() ); break;
+			case GL_UNSIGNED_INT: ConvertIndices< uint32_t >( indices, count, m_Scratch.data() ); break;
+		}
+		data = m_Scratch.data();
+	}
+
+	if ( replace )
+	{
+		Buffer::SetData( data, count * GetIndexSize() );
+		m_Count = count;
+	}
+	else
+	{
+		Buffer::SetSubData( first * GetIndexSize(), data, count * GetIndexSize() );
+	}
+}
+
+void IndexBuffer::SetData( const uint32_t* indices, unsigned int count )
+{
+	Upload( true, 0, indices, count );
+}
+
+void IndexBuffer::SetData( const uint16_t* indices, unsigned int count )
+{
+	Upload( true, 0, indices, count );
+}
+
+void IndexBuffer::SetData( const uint8_t* indices, unsigned int count )
+{
+	Upload( true, 0, indices, count );
+}
 
-	GLCall( glGenBuffers( 1, &m_RendererID ) );
-	GLCall( glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_RendererID ) );
-	GLCall( glBufferData( GL_ELEMENT_ARRAY_BUFFER, count * sizeof( unsigned int ), indices, GL_STATIC_DRAW ) );
+void IndexBuffer::SetSubData( unsigned int first, const uint32_t* indices, unsigned int count )
+{
+	Upload( false, first, indices, count );
+}
+
+void IndexBuffer::SetSubData( unsigned int first, const uint16_t* indices, unsigned int count )
+{
+	Upload( false, first, indices, count );
+}
+
+void IndexBuffer::SetSubData( unsigned int first, const uint8_t* indices, unsigned int count )
+{
+	Upload( false, first, indices, count );
 }
 
-IndexBuffer::~IndexBuffer()
+void IndexBuffer::Reserve( unsigned int count )
 {
-	GLCall( glDeleteBuffers( 1, &m_RendererID ) );
+	Buffer::Reserve( count * GetIndexSize() );
 }
 
-void IndexBuffer::Bind() const
+void IndexBuffer::Resize( unsigned int count )
 {
-	GLCall( glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_RendererID ) );
+	Buffer::Resize( count * GetIndexSize() );
+	m_Count = count;
 }
 
-void IndexBuffer::Unbind() const
+unsigned int IndexBuffer::GetSizeOfType( unsigned int type )
 {
-	GLCall( glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 ) );
+	switch ( type )
+	{
+		case GL_UNSIGNED_BYTE: return 1;
+		case GL_UNSIGNED_SHORT: return 2;
+		case GL_UNSIGNED_INT: return 4;
+	}
+	ASSERT( false );
+	return 0;
 }
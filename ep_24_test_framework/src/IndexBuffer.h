@@ -1,17 +1,58 @@
 #pragma once
 
-class IndexBuffer
+#include <cstdint>
+#include <vector>
+
+#include "Buffer.h"
+
+// Index buffer storing 8, 16 or 32 bit indices, the draw call uses GetType().
+// Indices given as uint32_t are narrowed to 16 bits whenever the largest index
+// allows it, unless a type is forced. 8 bit indices are only used on request,
+// since many GPUs have no native support for them and the driver converts them.
+class IndexBuffer : private Buffer
 {
 public:
-	IndexBuffer( const unsigned int* indices, unsigned int count );
-	~IndexBuffer();
+	// "type" forces GL_UNSIGNED_BYTE/SHORT/INT storage, 0 picks the narrowest on every SetData.
+	IndexBuffer( const uint32_t* indices, unsigned int count, BufferUsage usage = BufferUsage::Static, unsigned int type = 0 );
+	IndexBuffer( const uint16_t* indices, unsigned int count, BufferUsage usage = BufferUsage::Static );
+	IndexBuffer( const uint8_t* indices, unsigned int count, BufferUsage usage = BufferUsage::Static );
+	// Allocates "count" indices of "type" (0 for automatic) to be filled later.
+	explicit IndexBuffer( BufferUsage usage, unsigned int type = 0, unsigned int count = 0 );
+
+	// Move-only, a moved-from index buffer holds no indices.
+	IndexBuffer( IndexBuffer&& other ) noexcept;
+	IndexBuffer& operator=( IndexBuffer&& other ) noexcept;
 
-	void Bind() const;
-	void Unbind() const;
+	using Buffer::Bind;
+	using Buffer::Unbind;
+	using Buffer::GetRendererID;
+	using Buffer::GetUsage;
+
+	// Same as Buffer::SetData/SetSubData, in indices instead of bytes. The input is
+	// converted to the stored type, a sub-update can not widen it.
+	void SetData( const uint32_t* indices, unsigned int count );
+	void SetData( const uint16_t* indices, unsigned int count );
+	void SetData( const uint8_t* indices, unsigned int count );
+	void SetSubData( unsigned int first, const uint32_t* indices, unsigned int count );
+	void SetSubData( unsigned int first, const uint16_t* indices, unsigned int count );
+	void SetSubData( unsigned int first, const uint8_t* indices, unsigned int count );
+	void Reserve( unsigned int count );
+	void Resize( unsigned int count );
 
 	unsigned int GetCount() const { return m_Count; }
+	unsigned int GetCapacity() const { return m_Capacity / GetIndexSize(); }
+	// GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+	unsigned int GetType() const { return m_Type; }
+	unsigned int GetIndexSize() const { return GetSizeOfType( m_Type ); }
+
+	static unsigned int GetSizeOfType( unsigned int type );
 
 private:
-	unsigned int m_RendererID;
+	template< typename T >
+	void Upload( bool replace, unsigned int first, const T* indices, unsigned int count );
+
 	unsigned int m_Count;
+	unsigned int m_Type;
+	bool m_AutoType;
+	std::vector< unsigned char > m_Scratch;
 };
@@ -0,0 +1,53 @@
+#include "InstanceCuller.h"
+#include "Frustum.h"
+#include "Debug.h"
+
+#include "glm/gtc/type_ptr.hpp"
+
+// Matches local_size_x in InstanceCull.shader.
+static const unsigned int GROUP_SIZE = 64;
+
+InstanceCuller::InstanceCuller( unsigned int indexCount, unsigned int instanceCount )
+	: m_IndexCount( indexCount ), m_InstanceCount( instanceCount ),
+	m_Shader( "res/shaders/InstanceCull.shader" ),
+	m_Bounds( nullptr, instanceCount * (unsigned int) sizeof( glm::vec4 ), BufferUsage::Dynamic ),
+	m_Visible( nullptr, instanceCount * (unsigned int) sizeof( uint32_t ), BufferUsage::Copy ),
+	m_Command( GL_DRAW_INDIRECT_BUFFER, nullptr, sizeof( DrawElementsIndirectCommand ), BufferUsage::Dynamic ),
+	m_Readback( sizeof( DrawElementsIndirectCommand ) ),
+	m_ResetCommand{ indexCount, 0, 0, 0, 0 }, m_LastCommand{ indexCount, 0, 0, 0, 0 }
+{
+	m_Command.SetSubData( 0, &m_ResetCommand, sizeof( DrawElementsIndirectCommand ) );
+}
+
+void InstanceCuller::UpdateBounds( unsigned int first, const glm::vec4* spheres, unsigned int count )
+{
+	ASSERT( first + count <= m_InstanceCount );
+
+	StorageArray< glm::vec4 >( m_Bounds ).Set( first, spheres, count );
+}
+
+void InstanceCuller::Cull( const Renderer& renderer, const glm::mat4& viewProjection )
+{
+	// A recent count if one is ready, then the atomic counter starts over.
+	m_Readback.Read( &m_LastCommand );
+	m_Command.SetSubData( 0, &m_ResetCommand, sizeof( DrawElementsIndirectCommand ) );
+
+	const Frustum frustum( viewProjection );
+	m_Shader.Bind();
+	m_Shader.SetUniform4fv( "u_FrustumPlanes", 6, glm::value_ptr( frustum.Planes[0] ) );
+	m_Shader.SetUniform1i( "u_InstanceCount", (int) m_InstanceCount );
+
+	m_Shader.SetStorageBuffer( "Bounds", m_Bounds );
+	m_Shader.SetStorageBuffer( "Visible", m_Visible );
+	m_Shader.SetStorageBuffer( "Command", m_Command.GetRendererID() );
+	renderer.Dispatch( m_Shader, ( m_InstanceCount + GROUP_SIZE - 1 ) / GROUP_SIZE );
+
+	// The draw reads the command and the vertex shader the visible list.
+	GLCall( glMemoryBarrier( GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT ) );
+	m_Readback.Request( m_Command.GetRendererID() );
+}
+
+void InstanceCuller::BindVisible( Shader& shader, const std::string& name ) const
+{
+	shader.SetStorageBuffer( name, m_Visible );
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+
+#include "AsyncReadback.h"
+#include "Buffer.h"
+#include "Renderer.h"
+#include "Shader.h"
+#include "ShaderStorageBuffer.h"
+
+#include "glm/glm.hpp"
+
+// Frustum culling of many instances of one mesh on the GPU with res/shaders/InstanceCull.shader
+// (GL 4.3, see Renderer::IsComputeSupported). Every instance has a world space bounding
+// sphere in a storage buffer. The ones inside the frustum append their index to the visible
+// list and bump the instance count of a single DrawElementsIndirectCommand, so the draw is
+// an instanced Renderer::DrawIndirect whose vertex shader reads visible[gl_InstanceID].
+class InstanceCuller
+{
+private:
+	unsigned int m_IndexCount;
+	unsigned int m_InstanceCount;
+
+	Shader m_Shader;
+	// xyz center, w radius.
+	ShaderStorageBuffer m_Bounds;
+	// Indices of the instances that passed, in no particular order.
+	ShaderStorageBuffer m_Visible;
+	Buffer m_Command;
+	// Copies of the command, so the CPU never waits for the GPU to read its count.
+	AsyncReadback m_Readback;
+	DrawElementsIndirectCommand m_ResetCommand;
+	DrawElementsIndirectCommand m_LastCommand;
+
+public:
+	// Instances draw "indexCount" indices from the start of the mesh index buffer.
+	InstanceCuller( unsigned int indexCount, unsigned int instanceCount );
+
+	InstanceCuller( const InstanceCuller& ) = delete;
+	InstanceCuller& operator=( const InstanceCuller& ) = delete;
+
+	// Replaces the spheres of "count" instances from "first", for objects that moved.
+	void UpdateBounds( unsigned int first, const glm::vec4* spheres, unsigned int count );
+	// Fills the visible list and the command for the frustum of "viewProjection".
+	void Cull( const Renderer& renderer, const glm::mat4& viewProjection );
+
+	// Binds the visible list to the storage block "name" of the draw shader.
+	void BindVisible( Shader& shader, const std::string& name = "Visible" ) const;
+	inline const Buffer& GetCommandBuffer() const { return m_Command; }
+
+	inline unsigned int GetInstanceCount() const { return m_InstanceCount; }
+	// Instances drawn by a recent Cull, read back a frame or two late.
+	inline unsigned int GetVisibleCount() const { return m_LastCommand.InstanceCount; }
+};
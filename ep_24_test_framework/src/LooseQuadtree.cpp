@@ -0,0 +1,155 @@
+#include "LooseQuadtree.h"
+#include "Debug.h"
+
+#include <algorithm>
+#include <cmath>
+
+LooseQuadtree::LooseQuadtree( const Bounds2D& world, unsigned int depth )
+	: m_Origin( world.Min ), m_Size( std::max( std::max( world.Max.x - world.Min.x, world.Max.y - world.Min.y ), 1e-6f ) ),
+	m_Depth( std::min( depth, MAX_DEPTH ) ), m_Count( 0 )
+{
+	uint32_t nodes = 0;
+	for ( unsigned int level = 0; level <= m_Depth; level++ )
+	{
+		m_LevelStarts.push_back( nodes );
+		nodes += 1u << ( 2 * level );
+	}
+	m_Heads.assign( nodes, NONE );
+	m_Counts.assign( nodes, 0 );
+}
+
+uint32_t LooseQuadtree::FindNode( const Bounds2D& bounds ) const
+{
+	const glm::vec2 center = 0.5f * ( bounds.Min + bounds.Max ) - m_Origin;
+	if ( center.x < 0.0f || center.y < 0.0f || center.x >= m_Size || center.y >= m_Size )
+		return 0;
+
+	// Deepest level whose cells are at least as large as the object, so the object
+	// stays within the loose bounds around the cell holding its center.
+	const float extent = std::max( bounds.Max.x - bounds.Min.x, bounds.Max.y - bounds.Min.y );
+	unsigned int level = m_Depth;
+	if ( extent > 0.0f )
+		level = (unsigned int) std::min( std::max( std::floor( std::log2( m_Size / extent ) ), 0.0f ), (float) m_Depth );
+	// log2 may round up right at a power of two.
+	while ( level > 0 && m_Size / ( 1u << level ) < extent )
+		level--;
+
+	const uint32_t side = 1u << level;
+	const float cellSize = m_Size / side;
+	const uint32_t x = std::min( (uint32_t) ( center.x / cellSize ), side - 1 );
+	const uint32_t y = std::min( (uint32_t) ( center.y / cellSize ), side - 1 );
+	return m_LevelStarts[level] + y * side + x;
+}
+
+void LooseQuadtree::Link( uint32_t id, uint32_t node )
+{
+	Item& item = m_Items[id];
+	item.Node = node;
+	item.Previous = NONE;
+	item.Next = m_Heads[node];
+	if ( item.Next != NONE )
+		m_Items[item.Next].Previous = id;
+	m_Heads[node] = id;
+	AddCount( node, 1 );
+}
+
+void LooseQuadtree::Unlink( uint32_t id )
+{
+	Item& item = m_Items[id];
+	if ( item.Previous != NONE )
+		m_Items[item.Previous].Next = item.Next;
+	else
+		m_Heads[item.Node] = item.Next;
+	if ( item.Next != NONE )
+		m_Items[item.Next].Previous = item.Previous;
+	AddCount( item.Node, -1 );
+	item.Node = NONE;
+}
+
+void LooseQuadtree::AddCount( uint32_t node, int delta )
+{
+	unsigned int level = 0;
+	while ( level < m_Depth && node >= m_LevelStarts[level + 1] )
+		level++;
+
+	uint32_t x = ( node - m_LevelStarts[level] ) & ( ( 1u << level ) - 1 );
+	uint32_t y = ( node - m_LevelStarts[level] ) >> level;
+	for ( ;; )
+	{
+		m_Counts[m_LevelStarts[level] + ( y << level ) + x] += delta;
+		if ( level == 0 )
+			break;
+		level--;
+		x >>= 1;
+		y >>= 1;
+	}
+}
+
+void LooseQuadtree::Insert( uint32_t id, const Bounds2D& bounds )
+{
+	if ( id >= m_Items.size() )
+		m_Items.resize( id + 1, { {}, NONE, NONE, NONE } );
+	ASSERT( m_Items[id].Node == NONE );
+
+	m_Items[id].Bounds = bounds;
+	Link( id, FindNode( bounds ) );
+	m_Count++;
+}
+
+void LooseQuadtree::Update( uint32_t id, const Bounds2D& bounds )
+{
+	ASSERT( id < m_Items.size() && m_Items[id].Node != NONE );
+
+	m_Items[id].Bounds = bounds;
+	const uint32_t node = FindNode( bounds );
+	if ( node == m_Items[id].Node )
+		return;
+	Unlink( id );
+	Link( id, node );
+}
+
+void LooseQuadtree::Remove( uint32_t id )
+{
+	if ( id >= m_Items.size() || m_Items[id].Node == NONE )
+		return;
+	Unlink( id );
+	m_Count--;
+}
+
+void LooseQuadtree::Clear()
+{
+	std::fill( m_Heads.begin(), m_Heads.end(), NONE );
+	std::fill( m_Counts.begin(), m_Counts.end(), 0 );
+	m_Items.clear();
+	m_Count = 0;
+}
+
+void LooseQuadtree::Query( const Bounds2D& area, std::vector< uint32_t >& results ) const
+{
+	QueryNode( 0, 0, 0, area, results );
+}
+
+void LooseQuadtree::QueryNode( unsigned int level, uint32_t x, uint32_t y, const Bounds2D& area, std::vector< uint32_t >& results ) const
+{
+	const uint32_t node = m_LevelStarts[level] + ( y << level ) + x;
+	if ( m_Counts[node] == 0 )
+		return;
+
+	// The root also holds everything outside the world, it is always visited.
+	if ( level > 0 )
+	{
+		const float cellSize = m_Size / ( 1u << level );
+		const glm::vec2 cellMin = m_Origin + glm::vec2( x, y ) * cellSize;
+		const Bounds2D loose = { cellMin - 0.5f * cellSize, cellMin + 1.5f * cellSize };
+		if ( !loose.Overlaps( area ) )
+			return;
+	}
+
+	for ( uint32_t id = m_Heads[node]; id != NONE; id = m_Items[id].Next )
+		if ( m_Items[id].Bounds.Overlaps( area ) )
+			results.push_back( id );
+
+	if ( level < m_Depth )
+		for ( uint32_t child = 0; child < 4; child++ )
+			QueryNode( level + 1, x * 2 + ( child & 1 ), y * 2 + ( child >> 1 ), area, results );
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "SpatialIndex.h"
+
+// Loose quadtree stored as full levels, no node is ever allocated or freed. Every
+// node's bounds are loosened to twice its cell, so an object lives in exactly one
+// node: the one at the deepest level whose cells are at least as large as the object,
+// containing the object's center. Objects that move within their cell keep their node.
+// Nodes count the objects below them so queries skip empty subtrees. Objects centered
+// outside the world live in the root.
+//
+// Every level is allocated up front: ( 4^( depth + 1 ) - 1 ) / 3 nodes of 8 bytes, so
+// depth 8 takes 0.7 MB and every further level four times more. Depth is capped at
+// MAX_DEPTH (2.8 MB); below that, objects smaller than the nodes share them.
+class LooseQuadtree : public SpatialIndex
+{
+public:
+	static constexpr unsigned int MAX_DEPTH = 9;
+
+private:
+	static constexpr uint32_t NONE = 0xFFFFFFFF;
+
+	struct Item
+	{
+		Bounds2D Bounds;
+		uint32_t Node;
+		// Doubly linked list of the objects in the node.
+		uint32_t Previous;
+		uint32_t Next;
+	};
+
+	glm::vec2 m_Origin;
+	float m_Size;
+	unsigned int m_Depth;
+	// First node of every level, level d has 4^d nodes in rows of 2^d.
+	std::vector< uint32_t > m_LevelStarts;
+	std::vector< uint32_t > m_Heads;
+	// Objects in the node and all of its descendants.
+	std::vector< uint32_t > m_Counts;
+	std::vector< Item > m_Items;
+	size_t m_Count;
+
+public:
+	// Nodes at "depth" are 2^depth times smaller than the world's larger side.
+	LooseQuadtree( const Bounds2D& world, unsigned int depth );
+
+	void Insert( uint32_t id, const Bounds2D& bounds ) override;
+	void Update( uint32_t id, const Bounds2D& bounds ) override;
+	void Remove( uint32_t id ) override;
+	void Clear() override;
+	void Query( const Bounds2D& area, std::vector< uint32_t >& results ) const override;
+	inline size_t GetCount() const override { return m_Count; }
+
+	inline unsigned int GetDepth() const { return m_Depth; }
+
+private:
+	uint32_t FindNode( const Bounds2D& bounds ) const;
+	void Link( uint32_t id, uint32_t node );
+	void Unlink( uint32_t id );
+	// Adds "delta" to the counts of "node" and its ancestors.
+	void AddCount( uint32_t node, int delta );
+	void QueryNode( unsigned int level, uint32_t x, uint32_t y, const Bounds2D& area, std::vector< uint32_t >& results ) const;
+};
@@ -0,0 +1,141 @@
+#include "MappedFile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile( const std::string& path )
+	: m_FilePath( path ), m_Data( nullptr ), m_Size( 0 ), m_FileHandle( INVALID_HANDLE_VALUE ), m_MappingHandle( nullptr )
+{
+	m_FileHandle = CreateFileA( path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+								FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+	if ( m_FileHandle == INVALID_HANDLE_VALUE )
+		return;
+
+	LARGE_INTEGER size;
+	if ( !GetFileSizeEx( m_FileHandle, &size ) || size.QuadPart == 0 )
+	{
+		Close();
+		return;
+	}
+
+	m_MappingHandle = CreateFileMappingA( m_FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr );
+	if ( m_MappingHandle == nullptr )
+	{
+		Close();
+		return;
+	}
+
+	m_Data = static_cast< const unsigned char* >( MapViewOfFile( m_MappingHandle, FILE_MAP_READ, 0, 0, 0 ) );
+	if ( m_Data == nullptr )
+	{
+		Close();
+		return;
+	}
+	m_Size = static_cast< size_t >( size.QuadPart );
+}
+
+void MappedFile::Close()
+{
+	if ( m_Data )
+		UnmapViewOfFile( m_Data );
+	if ( m_MappingHandle )
+		CloseHandle( m_MappingHandle );
+	if ( m_FileHandle != INVALID_HANDLE_VALUE )
+		CloseHandle( m_FileHandle );
+
+	m_Data = nullptr;
+	m_Size = 0;
+	m_MappingHandle = nullptr;
+	m_FileHandle = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+MappedFile::MappedFile( const std::string& path )
+	: m_FilePath( path ), m_Data( nullptr ), m_Size( 0 ), m_FileDescriptor( -1 )
+{
+	m_FileDescriptor = open( path.c_str(), O_RDONLY );
+	if ( m_FileDescriptor < 0 )
+		return;
+
+	struct stat info;
+	if ( fstat( m_FileDescriptor, &info ) != 0 || info.st_size == 0 )
+	{
+		Close();
+		return;
+	}
+
+	void* data = mmap( nullptr, static_cast< size_t >( info.st_size ), PROT_READ, MAP_PRIVATE, m_FileDescriptor, 0 );
+	if ( data == MAP_FAILED )
+	{
+		Close();
+		return;
+	}
+	m_Data = static_cast< const unsigned char* >( data );
+	m_Size = static_cast< size_t >( info.st_size );
+}
+
+void MappedFile::Close()
+{
+	if ( m_Data )
+		munmap( const_cast< unsigned char* >( m_Data ), m_Size );
+	if ( m_FileDescriptor >= 0 )
+		close( m_FileDescriptor );
+
+	m_Data = nullptr;
+	m_Size = 0;
+	m_FileDescriptor = -1;
+}
+
+#endif
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+MappedFile::MappedFile( MappedFile&& other ) noexcept
+	: m_Data( nullptr ), m_Size( 0 ),
+#ifdef _WIN32
+	m_FileHandle( INVALID_HANDLE_VALUE ), m_MappingHandle( nullptr )
+#else
+	m_FileDescriptor( -1 )
+#endif
+{
+	MoveFrom( other );
+}
+
+MappedFile& MappedFile::operator=( MappedFile&& other ) noexcept
+{
+	if ( this != &other )
+	{
+		Close();
+		MoveFrom( other );
+	}
+	return *this;
+}
+
+void MappedFile::MoveFrom( MappedFile& other )
+{
+	m_FilePath = std::move( other.m_FilePath );
+	m_Data = std::exchange( other.m_Data, nullptr );
+	m_Size = std::exchange( other.m_Size, 0 );
+#ifdef _WIN32
+	m_FileHandle = std::exchange( other.m_FileHandle, INVALID_HANDLE_VALUE );
+	m_MappingHandle = std::exchange( other.m_MappingHandle, nullptr );
+#else
+	m_FileDescriptor = std::exchange( other.m_FileDescriptor, -1 );
+#endif
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+
+// Read-only view of a whole file mapped into memory.
+class MappedFile
+{
+private:
+	std::string m_FilePath;
+	const unsigned char* m_Data;
+	size_t m_Size;
+#ifdef _WIN32
+	void* m_FileHandle;
+	void* m_MappingHandle;
+#else
+	int m_FileDescriptor;
+#endif
+
+public:
+	MappedFile( const std::string& path );
+	~MappedFile();
+
+	// Move-only, the mapping keeps its address so pointers into the data stay valid.
+	// A moved-from file is closed.
+	MappedFile( const MappedFile& ) = delete;
+	MappedFile& operator=( const MappedFile& ) = delete;
+	MappedFile( MappedFile&& other ) noexcept;
+	MappedFile& operator=( MappedFile&& other ) noexcept;
+
+	inline bool IsOpen() const { return m_Data != nullptr; }
+	inline const unsigned char* GetData() const { return m_Data; }
+	inline size_t GetSize() const { return m_Size; }
+	inline const std::string& GetFilePath() const { return m_FilePath; }
+
+private:
+	void Close();
+	void MoveFrom( MappedFile& other );
+};
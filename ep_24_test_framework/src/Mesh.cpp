@@ -0,0 +1,67 @@
+#include "Mesh.h"
+#include "CookedMesh.h"
+#include "MeshCooker.h"
+
+#include <GL/glew.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+Mesh::Mesh( const std::string& path, unsigned int threadCount, cooker::VertexCacheOrder order )
+	: m_FilePath( path ), m_VertexCount( 0 ), m_BoundsMin{ 0.0f, 0.0f, 0.0f }, m_BoundsMax{ 0.0f, 0.0f, 0.0f }, m_PositionScale{ 0.0f, 0.0f, 0.0f },
+	m_Acmr{ 0.0f, 0.0f }, m_Atvr{ 0.0f, 0.0f }, m_LoadedFromCache( false ), m_LoadTime( 0.0 )
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	const std::string cookedPath = CookedMesh::GetCookedPath( path );
+	std::unique_ptr< CookedMesh > cooked = std::make_unique< CookedMesh >( cookedPath );
+	m_LoadedFromCache = cooked->IsValid() && ( path == cookedPath
+		|| ( cooked->IsUpToDate( path ) && cooked->GetHeader().VertexCacheOrder == (uint32_t) order ) );
+	if ( !m_LoadedFromCache && path != cookedPath )
+	{
+		// Unmapped first, a mapped file can not be overwritten on Windows.
+		cooked = nullptr;
+
+		uint64_t sourceSize, sourceTime;
+		MeshData data;
+		if ( !CookedMesh::GetSourceInfo( path, sourceSize, sourceTime ) || !meshloader::Load( path, data, threadCount ) )
+		{
+			std::cout << "Failed to load mesh " << path << std::endl;
+			return;
+		}
+
+		std::vector< unsigned char > image = cooker::CookMesh( data, sourceSize, sourceTime, order );
+		std::ofstream stream( cookedPath, std::ios::binary | std::ios::trunc );
+		stream.write( reinterpret_cast< const char* >( image.data() ), image.size() );
+		if ( !stream )
+			std::cout << "Failed to write " << cookedPath << ", the mesh will be parsed again next time" << std::endl;
+		cooked = std::make_unique< CookedMesh >( std::move( image ) );
+	}
+
+	if ( !cooked || !cooked->IsValid() )
+	{
+		std::cout << "Failed to load mesh " << path << std::endl;
+		return;
+	}
+
+	const CookedMeshHeader& header = cooked->GetHeader();
+	m_VertexBuffer = std::make_unique< VertexBuffer >( cooked->GetVertexData(), cooked->GetVertexDataSize() );
+	if ( header.IndexType == GL_UNSIGNED_SHORT )
+		m_IndexBuffer = std::make_unique< IndexBuffer >( static_cast< const uint16_t* >( cooked->GetIndexData() ), header.IndexCount );
+	else
+		m_IndexBuffer = std::make_unique< IndexBuffer >( static_cast< const uint32_t* >( cooked->GetIndexData() ), header.IndexCount );
+	m_Layout = cooked->GetLayout();
+	m_Meshlets.assign( cooked->GetMeshlets(), cooked->GetMeshlets() + header.MeshletCount );
+	m_VertexCount = header.VertexCount;
+	std::copy_n( header.BoundsMin, 3, m_BoundsMin );
+	std::copy_n( header.BoundsMax, 3, m_BoundsMax );
+	for ( int c = 0; c < 3; c++ )
+		m_PositionScale[c] = m_BoundsMax[c] - m_BoundsMin[c];
+	m_Acmr[0] = header.SourceAcmr;
+	m_Acmr[1] = header.Acmr;
+	m_Atvr[0] = header.SourceAtvr;
+	m_Atvr[1] = header.Atvr;
+
+	m_LoadTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+}
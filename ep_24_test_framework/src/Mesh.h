@@ -0,0 +1,64 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "VertexBuffer.h"
+#include "IndexBuffer.h"
+#include "VertexBufferLayout.h"
+#include "MeshOptimizer.h"
+#include "MeshCooker.h"
+
+
+// Static mesh loaded from an OBJ or glTF file through its cooked sibling (see
+// CookedMesh.h). A cooked mesh that matches the source is mapped and uploaded as
+// it is, otherwise the source is parsed and cooked, and the result written next
+// to it for the next run. Attribute locations: 0 position, 1 texture coordinates,
+// 2 normal. Positions are normalized to the bounds, shaders restore them with
+// position.xyz * GetPositionScale() + GetBoundsMin() (u_PositionScale and
+// u_PositionOffset in res/shaders/Mesh.shader).
+class Mesh
+{
+private:
+	std::string m_FilePath;
+	std::unique_ptr< VertexBuffer > m_VertexBuffer;
+	std::unique_ptr< IndexBuffer > m_IndexBuffer;
+	VertexBufferLayout m_Layout;
+	std::vector< Meshlet > m_Meshlets;
+	unsigned int m_VertexCount;
+	float m_BoundsMin[3];
+	float m_BoundsMax[3];
+	float m_PositionScale[3];
+	float m_Acmr[2];
+	float m_Atvr[2];
+	bool m_LoadedFromCache;
+	double m_LoadTime;
+
+public:
+	// "threadCount" is passed to the parser on a cache miss, 0 uses one thread per core.
+	// A cooked mesh sorted with another vertex cache order than "order" is cooked again.
+	Mesh( const std::string& path, unsigned int threadCount = 0, cooker::VertexCacheOrder order = cooker::VertexCacheOrder::Tipsify );
+
+	inline bool IsValid() const { return m_VertexBuffer != nullptr; }
+	inline const std::string& GetFilePath() const { return m_FilePath; }
+
+	inline const VertexBuffer& GetVertexBuffer() const { return *m_VertexBuffer; }
+	inline const IndexBuffer& GetIndexBuffer() const { return *m_IndexBuffer; }
+	inline const VertexBufferLayout& GetLayout() const { return m_Layout; }
+	inline unsigned int GetVertexCount() const { return m_VertexCount; }
+	// Meshlets covering the index buffer in order, for GPU culling (see MeshletCuller).
+	inline const std::vector< Meshlet >& GetMeshlets() const { return m_Meshlets; }
+	inline const float* GetBoundsMin() const { return m_BoundsMin; }
+	inline const float* GetBoundsMax() const { return m_BoundsMax; }
+	inline const float* GetPositionScale() const { return m_PositionScale; }
+	// Vertex cache efficiency of the source triangle order and of the cooked one, see MeshOptimizer.h.
+	inline float GetSourceAcmr() const { return m_Acmr[0]; }
+	inline float GetAcmr() const { return m_Acmr[1]; }
+	inline float GetSourceAtvr() const { return m_Atvr[0]; }
+	inline float GetAtvr() const { return m_Atvr[1]; }
+
+	// Whether the last load skipped parsing, and how long it took in milliseconds.
+	inline bool WasLoadedFromCache() const { return m_LoadedFromCache; }
+	inline double GetLoadTime() const { return m_LoadTime; }
+};
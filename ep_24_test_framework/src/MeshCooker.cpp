@@ -0,0 +1,200 @@
+#include "MeshCooker.h"
+#include "CookedMesh.h"
+#include "MeshOptimizer.h"
+#include "Quantize.h"
+
+#include <GL/glew.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+namespace cooker
+{
+	// Quantized vertices compared by their bytes.
+	struct VertexKey
+	{
+		const unsigned char* Data;
+	};
+
+	struct VertexKeyHash
+	{
+		size_t Stride;
+
+		size_t operator()( const VertexKey& key ) const
+		{
+			// FNV-1a.
+			uint32_t hash = 2166136261u;
+			for ( size_t i = 0; i < Stride; i++ )
+				hash = ( hash ^ key.Data[i] ) * 16777619u;
+			return hash;
+		}
+	};
+
+	struct VertexKeyEqual
+	{
+		size_t Stride;
+
+		bool operator()( const VertexKey& a, const VertexKey& b ) const
+		{
+			return std::memcmp( a.Data, b.Data, Stride ) == 0;
+		}
+	};
+
+	std::vector< unsigned char > CookMesh( const MeshData& mesh, uint64_t sourceSize, uint64_t sourceTime, VertexCacheOrder order )
+	{
+		const size_t vertexCount = mesh.GetVertexCount();
+		// Every vertex gets texture coordinates, zero when the source has none, so
+		// shaders see the same attribute locations for every mesh.
+		const bool hasTexCoords = mesh.TexCoords.size() == vertexCount * 2;
+		const uint32_t attributes = COOKED_MESH_TEXCOORDS | ( mesh.Normals.size() == vertexCount * 3 ? COOKED_MESH_NORMALS : 0 );
+		const size_t stride = CookedMesh::GetVertexStride( attributes );
+
+		float boundsMin[3], boundsMax[3];
+		for ( int c = 0; c < 3; c++ )
+		{
+			boundsMin[c] = vertexCount ? mesh.Positions[c] : 0.0f;
+			boundsMax[c] = boundsMin[c];
+		}
+		for ( size_t i = 0; i < vertexCount; i++ )
+		{
+			for ( int c = 0; c < 3; c++ )
+			{
+				boundsMin[c] = std::min( boundsMin[c], mesh.Positions[i * 3 + c] );
+				boundsMax[c] = std::max( boundsMax[c], mesh.Positions[i * 3 + c] );
+			}
+		}
+
+		// Quantize every attribute separately, then interleave. Positions are stored
+		// relative to the bounds, so the precision follows the size of the mesh and not
+		// its distance from the origin.
+		std::vector< float > positions( vertexCount * 4, 1.0f );
+		for ( size_t i = 0; i < vertexCount; i++ )
+		{
+			for ( int c = 0; c < 3; c++ )
+			{
+				const float extent = boundsMax[c] - boundsMin[c];
+				positions[i * 4 + c] = extent > 0.0f ? ( mesh.Positions[i * 3 + c] - boundsMin[c] ) / extent : 0.0f;
+			}
+		}
+		std::vector< uint16_t > unormPositions( vertexCount * 4 );
+		quantize::FloatToUnorm16( positions.data(), unormPositions.data(), positions.size() );
+		std::vector< Half > halfTexCoords( vertexCount * 2, Half{ 0 } );
+		if ( hasTexCoords )
+			quantize::FloatToHalf( mesh.TexCoords.data(), halfTexCoords.data(), halfTexCoords.size() );
+		std::vector< PackedNormal > normals( ( attributes & COOKED_MESH_NORMALS ) ? vertexCount : 0 );
+		if ( !normals.empty() )
+			quantize::PackNormals( mesh.Normals.data(), normals.data(), vertexCount );
+
+		std::vector< unsigned char > vertices( vertexCount * stride );
+		for ( size_t i = 0; i < vertexCount; i++ )
+		{
+			unsigned char* vertex = &vertices[i * stride];
+			std::memcpy( vertex, &unormPositions[i * 4], 4 * sizeof( uint16_t ) );
+			vertex += 4 * sizeof( uint16_t );
+			std::memcpy( vertex, &halfTexCoords[i * 2], 2 * sizeof( Half ) );
+			vertex += 2 * sizeof( Half );
+			if ( !normals.empty() )
+				std::memcpy( vertex, &normals[i], sizeof( PackedNormal ) );
+		}
+
+		// Weld vertices quantization made identical, and drop the triangles that collapse.
+		// Those are closer than 1/65535 of the bounds on every axis.
+		std::unordered_map< VertexKey, uint32_t, VertexKeyHash, VertexKeyEqual > unique( vertexCount, VertexKeyHash{ stride }, VertexKeyEqual{ stride } );
+		std::vector< uint32_t > welded( vertexCount );
+		for ( size_t i = 0; i < vertexCount; i++ )
+			welded[i] = unique.emplace( VertexKey{ &vertices[i * stride] }, (uint32_t) i ).first->second;
+
+		std::vector< uint32_t > indices;
+		indices.reserve( mesh.Indices.size() );
+		for ( size_t i = 0; i + 2 < mesh.Indices.size(); i += 3 )
+		{
+			const uint32_t a = welded[mesh.Indices[i]], b = welded[mesh.Indices[i + 1]], c = welded[mesh.Indices[i + 2]];
+			if ( a != b && b != c && c != a )
+				indices.insert( indices.end(), { a, b, c } );
+		}
+
+		// Triangles for the vertex cache, then clusters of them for overdraw, then vertices by first use.
+		// Forsyth finds no clusters, overdraw optimization then cuts the whole order itself.
+		const VertexCacheStatistics sourceStatistics = meshoptimizer::AnalyzeVertexCache( indices.data(), indices.size(), vertexCount );
+		std::vector< uint32_t > clusters;
+		if ( order == VertexCacheOrder::Forsyth )
+			meshoptimizer::OptimizeVertexCacheForsyth( indices.data(), indices.size(), vertexCount );
+		else
+			meshoptimizer::OptimizeVertexCacheTipsify( indices.data(), indices.size(), vertexCount, 16, &clusters );
+		meshoptimizer::OptimizeOverdraw( indices.data(), indices.size(), mesh.Positions.data(), vertexCount, 3 * sizeof( float ), clusters );
+		std::vector< Meshlet > meshlets;
+		meshoptimizer::BuildMeshlets( indices.data(), indices.size(), mesh.Positions.data(), vertexCount, 3 * sizeof( float ), meshlets );
+		const uint32_t usedCount = (uint32_t) meshoptimizer::OptimizeVertexFetch( vertices.data(), indices.data(), indices.size(), vertexCount, stride );
+		const VertexCacheStatistics statistics = meshoptimizer::AnalyzeVertexCache( indices.data(), indices.size(), usedCount );
+
+		CookedMeshHeader header = {};
+		std::copy_n( COOKED_MESH_MAGIC, 4, header.Magic );
+		header.Version = COOKED_MESH_VERSION;
+		header.SourceSize = sourceSize;
+		header.SourceTime = sourceTime;
+		header.Attributes = attributes;
+		header.VertexStride = (uint32_t) stride;
+		header.VertexCount = usedCount;
+		header.IndexType = usedCount <= 0xFFFF ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+		header.IndexCount = (uint32_t) indices.size();
+		header.MeshletCount = (uint32_t) meshlets.size();
+		header.SourceAcmr = sourceStatistics.Acmr;
+		header.Acmr = statistics.Acmr;
+		header.SourceAtvr = sourceStatistics.Atvr;
+		header.Atvr = statistics.Atvr;
+		header.VertexCacheOrder = (uint32_t) order;
+		std::copy_n( boundsMin, 3, header.BoundsMin );
+		std::copy_n( boundsMax, 3, header.BoundsMax );
+
+		const auto align = []( size_t offset ) { return ( offset + COOKED_MESH_ALIGNMENT - 1 ) & ~(size_t) ( COOKED_MESH_ALIGNMENT - 1 ); };
+		const size_t indexSize = header.IndexType == GL_UNSIGNED_SHORT ? 2 : 4;
+		header.VertexOffset = (uint32_t) align( sizeof( header ) );
+		header.IndexOffset = (uint32_t) align( header.VertexOffset + usedCount * stride );
+		header.MeshletOffset = (uint32_t) align( header.IndexOffset + indices.size() * indexSize );
+
+		std::vector< unsigned char > image( header.MeshletOffset + meshlets.size() * sizeof( Meshlet ), 0 );
+		std::memcpy( image.data(), &header, sizeof( header ) );
+		std::copy_n( vertices.begin(), usedCount * stride, image.begin() + header.VertexOffset );
+		for ( size_t i = 0; i < indices.size(); i++ )
+		{
+			if ( indexSize == 2 )
+			{
+				const uint16_t index = (uint16_t) indices[i];
+				std::memcpy( &image[header.IndexOffset + i * 2], &index, 2 );
+			}
+			else
+				std::memcpy( &image[header.IndexOffset + i * 4], &indices[i], 4 );
+		}
+		if ( !meshlets.empty() )
+			std::memcpy( &image[header.MeshletOffset], meshlets.data(), meshlets.size() * sizeof( Meshlet ) );
+		return image;
+	}
+
+	bool CookMesh( const std::string& sourcePath, const std::string& cookedPath, unsigned int threadCount, VertexCacheOrder order )
+	{
+		uint64_t sourceSize, sourceTime;
+		MeshData mesh;
+		if ( !CookedMesh::GetSourceInfo( sourcePath, sourceSize, sourceTime ) || !meshloader::Load( sourcePath, mesh, threadCount ) )
+		{
+			std::cout << "Failed to load " << sourcePath << std::endl;
+			return false;
+		}
+
+		const std::vector< unsigned char > image = CookMesh( mesh, sourceSize, sourceTime, order );
+		std::ofstream stream( cookedPath, std::ios::binary | std::ios::trunc );
+		if ( !stream )
+		{
+			std::cout << "Failed to open " << cookedPath << " for writing" << std::endl;
+			return false;
+		}
+		stream.write( reinterpret_cast< const char* >( image.data() ), image.size() );
+
+		const CookedMeshHeader* header = reinterpret_cast< const CookedMeshHeader* >( image.data() );
+		std::cout << "Cooked " << sourcePath << " -> " << cookedPath << " (" << header->VertexCount << " vertices, "
+			<< header->IndexCount / 3 << " triangles, " << header->MeshletCount << " meshlets, " << header->VertexStride << " bytes per vertex, ACMR "
+			<< header->SourceAcmr << " -> " << header->Acmr << ", ATVR " << header->SourceAtvr << " -> " << header->Atvr << ")" << std::endl;
+		return stream.good();
+	}
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MeshLoader.h"
+
+// Offline conversion of source meshes into cooked meshes (see CookedMesh.h).
+namespace cooker
+{
+	// Triangle order for the vertex cache, see meshoptimizer::OptimizeVertexCacheTipsify
+	// and OptimizeVertexCacheForsyth. Stored in the cooked mesh.
+	enum class VertexCacheOrder : uint32_t
+	{
+		Tipsify, Forsyth
+	};
+
+	// Quantizes and interleaves "mesh", welds the vertices that became identical and
+	// reorders triangles and vertices and splits them into meshlets (see MeshOptimizer.h),
+	// returning the image of a .cmesh file.
+	std::vector< unsigned char > CookMesh( const MeshData& mesh, uint64_t sourceSize, uint64_t sourceTime,
+										   VertexCacheOrder order = VertexCacheOrder::Tipsify );
+
+	// Parses "sourcePath" (see meshloader::Load) and writes it cooked to "cookedPath".
+	bool CookMesh( const std::string& sourcePath, const std::string& cookedPath, unsigned int threadCount = 0,
+				   VertexCacheOrder order = VertexCacheOrder::Tipsify );
+}
@@ -0,0 +1,940 @@
+#include "MeshLoader.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/quaternion.hpp"
+#include "glm/gtc/type_ptr.hpp"
+
+namespace meshloader
+{
+	// Runs job( i ) for every i < count, spread over up to "threadCount" threads including the caller.
+	static void ParallelFor( size_t count, unsigned int threadCount, const std::function< void( size_t ) >& job )
+	{
+		if ( threadCount == 0 )
+			threadCount = std::max( 1u, std::thread::hardware_concurrency() );
+		threadCount = (unsigned int) std::min< size_t >( threadCount, count );
+
+		std::atomic< size_t > next( 0 );
+		auto worker = [&]()
+		{
+			for ( size_t i = next++; i < count; i = next++ )
+				job( i );
+		};
+
+		std::vector< std::thread > threads;
+		for ( unsigned int i = 1; i < threadCount; i++ )
+			threads.emplace_back( worker );
+		worker();
+		for ( auto& thread : threads )
+			thread.join();
+	}
+
+	static std::string GetExtension( const std::string& path )
+	{
+		const size_t dot = path.find_last_of( '.' );
+		std::string extension = dot == std::string::npos ? "" : path.substr( dot );
+		std::transform( extension.begin(), extension.end(), extension.begin(), []( char c ) { return (char) std::tolower( c ); } );
+		return extension;
+	}
+
+	// Number parsing bounded by "end", mapped files are not null terminated.
+	static inline void SkipSpaces( const char*& p, const char* end )
+	{
+		while ( p < end && ( *p == ' ' || *p == '\t' ) )
+			p++;
+	}
+
+	static int ParseInt( const char*& p, const char* end )
+	{
+		SkipSpaces( p, end );
+		bool negative = false;
+		if ( p < end && ( *p == '-' || *p == '+' ) )
+			negative = *p++ == '-';
+		int value = 0;
+		while ( p < end && *p >= '0' && *p <= '9' )
+			value = value * 10 + ( *p++ - '0' );
+		return negative ? -value : value;
+	}
+
+	static float ParseFloat( const char*& p, const char* end )
+	{
+		SkipSpaces( p, end );
+		bool negative = false;
+		if ( p < end && ( *p == '-' || *p == '+' ) )
+			negative = *p++ == '-';
+		double value = 0.0;
+		while ( p < end && *p >= '0' && *p <= '9' )
+			value = value * 10.0 + ( *p++ - '0' );
+		if ( p < end && *p == '.' )
+		{
+			p++;
+			double scale = 0.1;
+			while ( p < end && *p >= '0' && *p <= '9' )
+			{
+				value += ( *p++ - '0' ) * scale;
+				scale *= 0.1;
+			}
+		}
+		if ( p < end && ( *p == 'e' || *p == 'E' ) )
+		{
+			p++;
+			value *= std::pow( 10.0, ParseInt( p, end ) );
+		}
+		return (float) ( negative ? -value : value );
+	}
+
+	void GenerateNormals( MeshData& mesh )
+	{
+		mesh.Normals.assign( mesh.Positions.size(), 0.0f );
+		const glm::vec3* positions = reinterpret_cast< const glm::vec3* >( mesh.Positions.data() );
+		glm::vec3* normals = reinterpret_cast< glm::vec3* >( mesh.Normals.data() );
+		for ( size_t i = 0; i + 2 < mesh.Indices.size(); i += 3 )
+		{
+			const uint32_t a = mesh.Indices[i], b = mesh.Indices[i + 1], c = mesh.Indices[i + 2];
+			// Not normalized, so larger faces weigh more.
+			const glm::vec3 normal = glm::cross( positions[b] - positions[a], positions[c] - positions[a] );
+			normals[a] += normal;
+			normals[b] += normal;
+			normals[c] += normal;
+		}
+		for ( unsigned int i = 0; i < mesh.GetVertexCount(); i++ )
+		{
+			const float length = glm::length( normals[i] );
+			normals[i] = length > 0.0f ? normals[i] / length : glm::vec3( 0.0f, 0.0f, 1.0f );
+		}
+	}
+
+	// OBJ ---------------------------------------------------------------------
+
+	struct ObjCorner
+	{
+		// 1-based, 0 when absent.
+		int Position, TexCoord, Normal;
+		// Bit per component counted from the start of its chunk, see ParseObjChunk.
+		unsigned char LocalMask;
+	};
+
+	struct ObjChunk
+	{
+		const char* Begin;
+		const char* End;
+		std::vector< float > Positions, TexCoords, Normals;
+		std::vector< ObjCorner > Corners;
+		std::vector< uint32_t > FaceSizes;
+	};
+
+	struct ObjCornerHash
+	{
+		size_t operator()( const ObjCorner& corner ) const
+		{
+			return ( (size_t) corner.Position * 73856093u ) ^ ( (size_t) corner.TexCoord * 19349663u ) ^ ( (size_t) corner.Normal * 83492791u );
+		}
+	};
+
+	struct ObjCornerEqual
+	{
+		bool operator()( const ObjCorner& a, const ObjCorner& b ) const
+		{
+			return a.Position == b.Position && a.TexCoord == b.TexCoord && a.Normal == b.Normal;
+		}
+	};
+
+	// Negative indices count back from the last element parsed so far, which for a
+	// chunk parsed in parallel is only known relative to the chunk. They are stored
+	// relative to the chunk and flagged, and made absolute once all chunks are done.
+	static int ParseObjIndex( const char*& p, const char* end, size_t localCount, unsigned char bit, unsigned char& localMask )
+	{
+		const int index = ParseInt( p, end );
+		if ( index >= 0 )
+			return index;
+		localMask |= bit;
+		return (int) localCount + index + 1;
+	}
+
+	static void ParseObjChunk( ObjChunk& chunk )
+	{
+		const char* p = chunk.Begin;
+		const char* end = chunk.End;
+		while ( p < end )
+		{
+			const char* lineEnd = static_cast< const char* >( std::memchr( p, '\n', end - p ) );
+			if ( !lineEnd )
+				lineEnd = end;
+
+			SkipSpaces( p, lineEnd );
+			if ( lineEnd - p > 2 && p[0] == 'v' && ( p[1] == ' ' || p[1] == '\t' ) )
+			{
+				p += 1;
+				for ( int i = 0; i < 3; i++ )
+					chunk.Positions.push_back( ParseFloat( p, lineEnd ) );
+			}
+			else if ( lineEnd - p > 3 && p[0] == 'v' && p[1] == 't' )
+			{
+				p += 2;
+				for ( int i = 0; i < 2; i++ )
+					chunk.TexCoords.push_back( ParseFloat( p, lineEnd ) );
+			}
+			else if ( lineEnd - p > 3 && p[0] == 'v' && p[1] == 'n' )
+			{
+				p += 2;
+				for ( int i = 0; i < 3; i++ )
+					chunk.Normals.push_back( ParseFloat( p, lineEnd ) );
+			}
+			else if ( lineEnd - p > 2 && p[0] == 'f' && ( p[1] == ' ' || p[1] == '\t' ) )
+			{
+				p += 1;
+				uint32_t count = 0;
+				while ( true )
+				{
+					SkipSpaces( p, lineEnd );
+					if ( p >= lineEnd || *p == '\r' || *p == '#' )
+						break;
+
+					// v, v/vt, v//vn or v/vt/vn.
+					ObjCorner corner = { 0, 0, 0, 0 };
+					corner.Position = ParseObjIndex( p, lineEnd, chunk.Positions.size() / 3, 1, corner.LocalMask );
+					if ( p < lineEnd && *p == '/' )
+					{
+						p++;
+						if ( p < lineEnd && *p != '/' )
+							corner.TexCoord = ParseObjIndex( p, lineEnd, chunk.TexCoords.size() / 2, 2, corner.LocalMask );
+						if ( p < lineEnd && *p == '/' )
+						{
+							p++;
+							corner.Normal = ParseObjIndex( p, lineEnd, chunk.Normals.size() / 3, 4, corner.LocalMask );
+						}
+					}
+					// Skip whatever could not be parsed so a malformed corner can not stall the loop.
+					while ( p < lineEnd && *p != ' ' && *p != '\t' && *p != '\r' )
+						p++;
+
+					chunk.Corners.push_back( corner );
+					count++;
+				}
+
+				if ( count >= 3 )
+					chunk.FaceSizes.push_back( count );
+				else
+					chunk.Corners.resize( chunk.Corners.size() - count );
+			}
+
+			p = lineEnd + 1;
+		}
+	}
+
+	bool LoadObj( const std::string& path, MeshData& mesh, unsigned int threadCount )
+	{
+		MappedFile file( path );
+		if ( !file.IsOpen() )
+		{
+			std::cout << "Failed to open " << path << std::endl;
+			return false;
+		}
+
+		// Chunks of whole lines, one per thread.
+		if ( threadCount == 0 )
+			threadCount = std::max( 1u, std::thread::hardware_concurrency() );
+		const char* data = reinterpret_cast< const char* >( file.GetData() );
+		const char* dataEnd = data + file.GetSize();
+		const size_t chunkCount = std::max< size_t >( 1, std::min< size_t >( threadCount, file.GetSize() / ( 64 * 1024 ) ) );
+		std::vector< ObjChunk > chunks( chunkCount );
+		const char* begin = data;
+		for ( size_t i = 0; i < chunkCount; i++ )
+		{
+			const char* end = i + 1 == chunkCount ? dataEnd : data + file.GetSize() * ( i + 1 ) / chunkCount;
+			if ( end < begin )
+				end = begin;
+			const char* newline = static_cast< const char* >( std::memchr( end, '\n', dataEnd - end ) );
+			end = newline ? newline + 1 : dataEnd;
+			chunks[i].Begin = begin;
+			chunks[i].End = end;
+			begin = end;
+		}
+
+		ParallelFor( chunkCount, threadCount, [&]( size_t i ) { ParseObjChunk( chunks[i] ); } );
+
+		// Concatenate the attributes and make every index absolute and 0-based.
+		std::vector< float > positions, texCoords, normals;
+		size_t cornerCount = 0;
+		for ( const ObjChunk& chunk : chunks )
+			cornerCount += chunk.Corners.size();
+		std::vector< ObjCorner > corners;
+		corners.reserve( cornerCount );
+		for ( ObjChunk& chunk : chunks )
+		{
+			const int positionOffset = (int) positions.size() / 3;
+			const int texCoordOffset = (int) texCoords.size() / 2;
+			const int normalOffset = (int) normals.size() / 3;
+			positions.insert( positions.end(), chunk.Positions.begin(), chunk.Positions.end() );
+			texCoords.insert( texCoords.end(), chunk.TexCoords.begin(), chunk.TexCoords.end() );
+			normals.insert( normals.end(), chunk.Normals.begin(), chunk.Normals.end() );
+
+			for ( ObjCorner corner : chunk.Corners )
+			{
+				corner.Position += ( corner.LocalMask & 1 ) ? positionOffset : 0;
+				corner.TexCoord += ( corner.LocalMask & 2 ) ? texCoordOffset : 0;
+				corner.Normal += ( corner.LocalMask & 4 ) ? normalOffset : 0;
+				corner.LocalMask = 0;
+				corners.push_back( corner );
+			}
+			chunk.Corners = std::vector< ObjCorner >();
+		}
+
+		const int positionCount = (int) positions.size() / 3;
+		const int texCoordCount = (int) texCoords.size() / 2;
+		const int normalCount = (int) normals.size() / 3;
+		bool missingNormals = normalCount == 0;
+		for ( const ObjCorner& corner : corners )
+		{
+			if ( corner.Position < 1 || corner.Position > positionCount || corner.TexCoord < 0 || corner.TexCoord > texCoordCount
+				 || corner.Normal < 0 || corner.Normal > normalCount )
+			{
+				std::cout << "Index out of range in " << path << std::endl;
+				return false;
+			}
+			missingNormals |= corner.Normal == 0;
+		}
+
+		// One vertex per distinct corner, faces as triangle fans.
+		mesh = MeshData();
+		std::unordered_map< ObjCorner, uint32_t, ObjCornerHash, ObjCornerEqual > vertices;
+		vertices.reserve( corners.size() );
+		std::vector< uint32_t > cornerVertices( corners.size() );
+		for ( size_t i = 0; i < corners.size(); i++ )
+		{
+			const ObjCorner& corner = corners[i];
+			auto inserted = vertices.emplace( corner, mesh.GetVertexCount() );
+			cornerVertices[i] = inserted.first->second;
+			if ( !inserted.second )
+				continue;
+
+			const float* position = &positions[( corner.Position - 1 ) * 3];
+			mesh.Positions.insert( mesh.Positions.end(), position, position + 3 );
+			if ( texCoordCount > 0 )
+			{
+				const float* texCoord = corner.TexCoord ? &texCoords[( corner.TexCoord - 1 ) * 2] : nullptr;
+				mesh.TexCoords.push_back( texCoord ? texCoord[0] : 0.0f );
+				mesh.TexCoords.push_back( texCoord ? texCoord[1] : 0.0f );
+			}
+			if ( !missingNormals )
+			{
+				const float* normal = &normals[( corner.Normal - 1 ) * 3];
+				mesh.Normals.insert( mesh.Normals.end(), normal, normal + 3 );
+			}
+		}
+
+		size_t first = 0;
+		for ( const ObjChunk& chunk : chunks )
+		{
+			for ( uint32_t faceSize : chunk.FaceSizes )
+			{
+				for ( uint32_t i = 1; i + 1 < faceSize; i++ )
+					mesh.Indices.insert( mesh.Indices.end(), { cornerVertices[first], cornerVertices[first + i], cornerVertices[first + i + 1] } );
+				first += faceSize;
+			}
+		}
+
+		if ( missingNormals )
+			GenerateNormals( mesh );
+		return !mesh.Indices.empty();
+	}
+
+	// JSON, only as much as glTF needs -----------------------------------------
+
+	struct JsonValue
+	{
+		enum class Type { Null, Bool, Number, String, Array, Object };
+
+		Type Kind = Type::Null;
+		double Number = 0.0;
+		std::string String;
+		std::vector< JsonValue > Elements;
+		std::vector< std::pair< std::string, JsonValue > > Members;
+
+		// Missing members and elements are null.
+		const JsonValue& operator[]( const char* key ) const;
+		const JsonValue& operator[]( size_t index ) const;
+		// Literal indices, 0 would be ambiguous otherwise.
+		inline const JsonValue& operator[]( int index ) const { return ( *this )[(size_t) index]; }
+
+		inline bool IsNull() const { return Kind == Type::Null; }
+		inline size_t GetSize() const { return Elements.size(); }
+		inline double GetNumber( double fallback = 0.0 ) const { return Kind == Type::Number ? Number : fallback; }
+		inline bool GetBool( bool fallback = false ) const { return Kind == Type::Bool ? Number != 0.0 : fallback; }
+	};
+
+	static const JsonValue JSON_NULL;
+
+	const JsonValue& JsonValue::operator[]( const char* key ) const
+	{
+		for ( const auto& member : Members )
+		{
+			if ( member.first == key )
+				return member.second;
+		}
+		return JSON_NULL;
+	}
+
+	const JsonValue& JsonValue::operator[]( size_t index ) const
+	{
+		return index < Elements.size() ? Elements[index] : JSON_NULL;
+	}
+
+	class JsonParser
+	{
+	private:
+		const char* m_Position;
+		const char* m_End;
+		unsigned int m_Depth;
+
+	public:
+		JsonParser( const char* begin, const char* end ) : m_Position( begin ), m_End( end ), m_Depth( 0 ) {}
+
+		bool Parse( JsonValue& value )
+		{
+			SkipWhitespace();
+			if ( m_Position >= m_End || ++m_Depth > 128 )
+				return false;
+
+			bool ok = true;
+			const char c = *m_Position;
+			if ( c == '{' )
+				ok = ParseObject( value );
+			else if ( c == '[' )
+				ok = ParseArray( value );
+			else if ( c == '"' )
+			{
+				value.Kind = JsonValue::Type::String;
+				ok = ParseString( value.String );
+			}
+			else if ( Match( "true" ) || Match( "false" ) )
+			{
+				value.Kind = JsonValue::Type::Bool;
+				value.Number = m_Position[-1] == 'e' && m_Position[-2] == 'u' ? 1.0 : 0.0;
+			}
+			else if ( Match( "null" ) )
+				value.Kind = JsonValue::Type::Null;
+			else if ( c == '-' || ( c >= '0' && c <= '9' ) )
+			{
+				value.Kind = JsonValue::Type::Number;
+				value.Number = ParseFloat( m_Position, m_End );
+			}
+			else
+				ok = false;
+
+			m_Depth--;
+			return ok;
+		}
+
+	private:
+		void SkipWhitespace()
+		{
+			while ( m_Position < m_End && std::isspace( (unsigned char) *m_Position ) )
+				m_Position++;
+		}
+
+		bool Match( const char* word )
+		{
+			const size_t length = std::strlen( word );
+			if ( (size_t) ( m_End - m_Position ) < length || std::strncmp( m_Position, word, length ) != 0 )
+				return false;
+			m_Position += length;
+			return true;
+		}
+
+		bool ParseString( std::string& out )
+		{
+			m_Position++;
+			while ( m_Position < m_End && *m_Position != '"' )
+			{
+				char c = *m_Position++;
+				if ( c == '\\' && m_Position < m_End )
+				{
+					c = *m_Position++;
+					switch ( c )
+					{
+						case 'n': c = '\n'; break;
+						case 't': c = '\t'; break;
+						case 'r': c = '\r'; break;
+						case 'b': c = '\b'; break;
+						case 'f': c = '\f'; break;
+						case 'u':
+						{
+							// glTF keys and URIs are ASCII, anything else is replaced.
+							unsigned int code = 0;
+							for ( int i = 0; i < 4 && m_Position < m_End; i++ )
+							{
+								const char h = *m_Position++;
+								code = code * 16 + ( h <= '9' ? h - '0' : ( h | 0x20 ) - 'a' + 10 );
+							}
+							c = code < 0x80 ? (char) code : '?';
+							break;
+						}
+					}
+				}
+				out.push_back( c );
+			}
+			if ( m_Position >= m_End )
+				return false;
+			m_Position++;
+			return true;
+		}
+
+		bool ParseArray( JsonValue& value )
+		{
+			value.Kind = JsonValue::Type::Array;
+			m_Position++;
+			SkipWhitespace();
+			if ( m_Position < m_End && *m_Position == ']' )
+			{
+				m_Position++;
+				return true;
+			}
+			while ( true )
+			{
+				value.Elements.emplace_back();
+				if ( !Parse( value.Elements.back() ) )
+					return false;
+				SkipWhitespace();
+				if ( m_Position >= m_End )
+					return false;
+				if ( *m_Position++ == ']' )
+					return true;
+				if ( m_Position[-1] != ',' )
+					return false;
+			}
+		}
+
+		bool ParseObject( JsonValue& value )
+		{
+			value.Kind = JsonValue::Type::Object;
+			m_Position++;
+			SkipWhitespace();
+			if ( m_Position < m_End && *m_Position == '}' )
+			{
+				m_Position++;
+				return true;
+			}
+			while ( true )
+			{
+				SkipWhitespace();
+				value.Members.emplace_back();
+				if ( m_Position >= m_End || *m_Position != '"' || !ParseString( value.Members.back().first ) )
+					return false;
+				SkipWhitespace();
+				if ( m_Position >= m_End || *m_Position++ != ':' )
+					return false;
+				if ( !Parse( value.Members.back().second ) )
+					return false;
+				SkipWhitespace();
+				if ( m_Position >= m_End )
+					return false;
+				if ( *m_Position++ == '}' )
+					return true;
+				if ( m_Position[-1] != ',' )
+					return false;
+			}
+		}
+	};
+
+	// glTF ---------------------------------------------------------------------
+
+	struct GltfBuffer
+	{
+		const unsigned char* Data;
+		size_t Size;
+	};
+
+	struct GltfPrimitive
+	{
+		const JsonValue* Primitive;
+		glm::mat4 Transform;
+	};
+
+	static bool DecodeBase64( const char* begin, const char* end, std::vector< unsigned char >& out )
+	{
+		unsigned int bits = 0, count = 0;
+		for ( const char* p = begin; p < end && *p != '='; p++ )
+		{
+			const char c = *p;
+			int value;
+			if ( c >= 'A' && c <= 'Z' ) value = c - 'A';
+			else if ( c >= 'a' && c <= 'z' ) value = c - 'a' + 26;
+			else if ( c >= '0' && c <= '9' ) value = c - '0' + 52;
+			else if ( c == '+' ) value = 62;
+			else if ( c == '/' ) value = 63;
+			else return false;
+
+			bits = ( bits << 6 ) | value;
+			count += 6;
+			if ( count >= 8 )
+			{
+				count -= 8;
+				out.push_back( (unsigned char) ( bits >> count ) );
+			}
+		}
+		return true;
+	}
+
+	static std::string DecodeUri( const std::string& uri )
+	{
+		std::string path;
+		for ( size_t i = 0; i < uri.size(); i++ )
+		{
+			if ( uri[i] == '%' && i + 2 < uri.size() )
+			{
+				path.push_back( (char) std::stoi( uri.substr( i + 1, 2 ), nullptr, 16 ) );
+				i += 2;
+			}
+			else
+				path.push_back( uri[i] );
+		}
+		return path;
+	}
+
+	static unsigned int GetComponentCount( const std::string& type )
+	{
+		if ( type == "SCALAR" ) return 1;
+		if ( type == "VEC2" ) return 2;
+		if ( type == "VEC3" ) return 3;
+		if ( type == "VEC4" ) return 4;
+		return 0;
+	}
+
+	static unsigned int GetComponentSize( unsigned int componentType )
+	{
+		switch ( componentType )
+		{
+			case 5120: case 5121: return 1; // BYTE, UNSIGNED_BYTE
+			case 5122: case 5123: return 2; // SHORT, UNSIGNED_SHORT
+			case 5125: case 5126: return 4; // UNSIGNED_INT, FLOAT
+		}
+		return 0;
+	}
+
+	static double ReadComponent( const unsigned char* data, unsigned int componentType, bool normalized )
+	{
+		switch ( componentType )
+		{
+			case 5120: { int8_t v; std::memcpy( &v, data, 1 ); return normalized ? std::max( v / 127.0, -1.0 ) : v; }
+			case 5121: { uint8_t v; std::memcpy( &v, data, 1 ); return normalized ? v / 255.0 : v; }
+			case 5122: { int16_t v; std::memcpy( &v, data, 2 ); return normalized ? std::max( v / 32767.0, -1.0 ) : v; }
+			case 5123: { uint16_t v; std::memcpy( &v, data, 2 ); return normalized ? v / 65535.0 : v; }
+			case 5125: { uint32_t v; std::memcpy( &v, data, 4 ); return v; }
+			case 5126: { float v; std::memcpy( &v, data, 4 ); return v; }
+		}
+		return 0.0;
+	}
+
+	// Reads the first "components" components of every element of an accessor.
+	static bool ReadAccessor( const JsonValue& root, const std::vector< GltfBuffer >& buffers, size_t index, unsigned int components, std::vector< double >& out )
+	{
+		const JsonValue& accessor = root["accessors"][index];
+		const unsigned int componentType = (unsigned int) accessor["componentType"].GetNumber();
+		const unsigned int componentSize = GetComponentSize( componentType );
+		const unsigned int componentCount = GetComponentCount( accessor["type"].String );
+		const size_t count = (size_t) accessor["count"].GetNumber();
+		if ( accessor.IsNull() || componentSize == 0 || componentCount < components )
+			return false;
+		if ( !accessor["sparse"].IsNull() )
+		{
+			std::cout << "Sparse glTF accessors are not supported" << std::endl;
+			return false;
+		}
+
+		out.assign( count * components, 0.0 );
+		if ( accessor["bufferView"].IsNull() )
+			return true;
+
+		const JsonValue& view = root["bufferViews"][(size_t) accessor["bufferView"].GetNumber()];
+		const size_t bufferIndex = (size_t) view["buffer"].GetNumber();
+		if ( view.IsNull() || bufferIndex >= buffers.size() )
+			return false;
+
+		const size_t elementSize = componentSize * componentCount;
+		const size_t stride = (size_t) view["byteStride"].GetNumber( (double) elementSize );
+		const size_t viewOffset = (size_t) view["byteOffset"].GetNumber();
+		const size_t viewLength = (size_t) view["byteLength"].GetNumber();
+		const size_t offset = (size_t) accessor["byteOffset"].GetNumber();
+		if ( count > 0 && ( offset + ( count - 1 ) * stride + elementSize > viewLength || viewOffset + viewLength > buffers[bufferIndex].Size ) )
+		{
+			std::cout << "glTF accessor " << index << " is out of bounds" << std::endl;
+			return false;
+		}
+
+		const bool normalized = accessor["normalized"].GetBool();
+		const unsigned char* data = buffers[bufferIndex].Data + viewOffset + offset;
+		for ( size_t i = 0; i < count; i++ )
+		{
+			for ( unsigned int c = 0; c < components; c++ )
+				out[i * components + c] = ReadComponent( data + i * stride + c * componentSize, componentType, normalized );
+		}
+		return true;
+	}
+
+	static bool LoadGltfPrimitive( const JsonValue& root, const std::vector< GltfBuffer >& buffers, const GltfPrimitive& source, MeshData& mesh )
+	{
+		const JsonValue& primitive = *source.Primitive;
+		const JsonValue& attributes = primitive["attributes"];
+		if ( attributes["POSITION"].IsNull() )
+			return false;
+
+		std::vector< double > values;
+		if ( !ReadAccessor( root, buffers, (size_t) attributes["POSITION"].GetNumber(), 3, values ) )
+			return false;
+		const size_t vertexCount = values.size() / 3;
+		mesh.Positions.resize( vertexCount * 3 );
+		for ( size_t i = 0; i < vertexCount; i++ )
+		{
+			const glm::vec4 position = source.Transform * glm::vec4( (float) values[i * 3], (float) values[i * 3 + 1], (float) values[i * 3 + 2], 1.0f );
+			std::copy_n( glm::value_ptr( position ), 3, &mesh.Positions[i * 3] );
+		}
+
+		if ( !attributes["TEXCOORD_0"].IsNull() && ReadAccessor( root, buffers, (size_t) attributes["TEXCOORD_0"].GetNumber(), 2, values ) && values.size() == vertexCount * 2 )
+		{
+			// glTF puts the origin of texture coordinates at the top left.
+			mesh.TexCoords.resize( vertexCount * 2 );
+			for ( size_t i = 0; i < vertexCount; i++ )
+			{
+				mesh.TexCoords[i * 2] = (float) values[i * 2];
+				mesh.TexCoords[i * 2 + 1] = 1.0f - (float) values[i * 2 + 1];
+			}
+		}
+
+		if ( !primitive["indices"].IsNull() )
+		{
+			if ( !ReadAccessor( root, buffers, (size_t) primitive["indices"].GetNumber(), 1, values ) )
+				return false;
+			mesh.Indices.resize( values.size() - values.size() % 3 );
+			for ( size_t i = 0; i < mesh.Indices.size(); i++ )
+			{
+				mesh.Indices[i] = (uint32_t) values[i];
+				if ( mesh.Indices[i] >= vertexCount )
+					return false;
+			}
+		}
+		else
+		{
+			mesh.Indices.resize( vertexCount - vertexCount % 3 );
+			for ( size_t i = 0; i < mesh.Indices.size(); i++ )
+				mesh.Indices[i] = (uint32_t) i;
+		}
+
+		// Mirroring transforms flip the winding.
+		if ( glm::determinant( glm::mat3( source.Transform ) ) < 0.0f )
+		{
+			for ( size_t i = 0; i < mesh.Indices.size(); i += 3 )
+				std::swap( mesh.Indices[i + 1], mesh.Indices[i + 2] );
+		}
+
+		if ( !attributes["NORMAL"].IsNull() && ReadAccessor( root, buffers, (size_t) attributes["NORMAL"].GetNumber(), 3, values ) && values.size() == vertexCount * 3 )
+		{
+			const glm::mat3 normalMatrix = glm::transpose( glm::inverse( glm::mat3( source.Transform ) ) );
+			mesh.Normals.resize( vertexCount * 3 );
+			for ( size_t i = 0; i < vertexCount; i++ )
+			{
+				glm::vec3 normal = normalMatrix * glm::vec3( (float) values[i * 3], (float) values[i * 3 + 1], (float) values[i * 3 + 2] );
+				const float length = glm::length( normal );
+				normal = length > 0.0f ? normal / length : glm::vec3( 0.0f, 0.0f, 1.0f );
+				std::copy_n( glm::value_ptr( normal ), 3, &mesh.Normals[i * 3] );
+			}
+		}
+		else
+			GenerateNormals( mesh );
+		return true;
+	}
+
+	static glm::mat4 GetNodeTransform( const JsonValue& node )
+	{
+		const JsonValue& matrix = node["matrix"];
+		if ( matrix.GetSize() == 16 )
+		{
+			// Column major, like glm.
+			float values[16];
+			for ( size_t i = 0; i < 16; i++ )
+				values[i] = (float) matrix[i].GetNumber();
+			return glm::make_mat4( values );
+		}
+
+		const JsonValue& t = node["translation"];
+		const JsonValue& r = node["rotation"];
+		const JsonValue& s = node["scale"];
+		const glm::vec3 translation( (float) t[0].GetNumber(), (float) t[1].GetNumber(), (float) t[2].GetNumber() );
+		const glm::quat rotation( (float) r[3].GetNumber( 1.0 ), (float) r[0].GetNumber(), (float) r[1].GetNumber(), (float) r[2].GetNumber() );
+		const glm::vec3 scale( (float) s[0].GetNumber( 1.0 ), (float) s[1].GetNumber( 1.0 ), (float) s[2].GetNumber( 1.0 ) );
+		return glm::translate( glm::mat4( 1.0f ), translation ) * glm::mat4_cast( rotation ) * glm::scale( glm::mat4( 1.0f ), scale );
+	}
+
+	static void CollectGltfPrimitives( const JsonValue& root, size_t nodeIndex, const glm::mat4& parent, unsigned int depth, std::vector< GltfPrimitive >& out )
+	{
+		const JsonValue& node = root["nodes"][nodeIndex];
+		if ( node.IsNull() || depth > 64 )
+			return;
+
+		const glm::mat4 transform = parent * GetNodeTransform( node );
+		if ( !node["mesh"].IsNull() )
+		{
+			const JsonValue& primitives = root["meshes"][(size_t) node["mesh"].GetNumber()]["primitives"];
+			for ( size_t i = 0; i < primitives.GetSize(); i++ )
+				out.push_back( { &primitives[i], transform } );
+		}
+
+		const JsonValue& children = node["children"];
+		for ( size_t i = 0; i < children.GetSize(); i++ )
+			CollectGltfPrimitives( root, (size_t) children[i].GetNumber(), transform, depth + 1, out );
+	}
+
+	bool LoadGltf( const std::string& path, MeshData& mesh, unsigned int threadCount )
+	{
+		MappedFile file( path );
+		if ( !file.IsOpen() )
+		{
+			std::cout << "Failed to open " << path << std::endl;
+			return false;
+		}
+
+		// Binary glTF: 12 byte header, a JSON chunk and an optional BIN chunk.
+		const char* json = reinterpret_cast< const char* >( file.GetData() );
+		const char* jsonEnd = json + file.GetSize();
+		GltfBuffer binaryChunk = { nullptr, 0 };
+		if ( file.GetSize() >= 20 && std::memcmp( file.GetData(), "glTF", 4 ) == 0 )
+		{
+			uint32_t chunkLength, chunkType;
+			std::memcpy( &chunkLength, file.GetData() + 12, 4 );
+			std::memcpy( &chunkType, file.GetData() + 16, 4 );
+			if ( chunkType != 0x4E4F534A || 20 + (size_t) chunkLength > file.GetSize() )
+			{
+				std::cout << "Invalid binary glTF " << path << std::endl;
+				return false;
+			}
+			json = reinterpret_cast< const char* >( file.GetData() + 20 );
+			jsonEnd = json + chunkLength;
+
+			const size_t binOffset = 20 + ( ( (size_t) chunkLength + 3 ) & ~(size_t) 3 );
+			if ( binOffset + 8 <= file.GetSize() )
+			{
+				std::memcpy( &chunkLength, file.GetData() + binOffset, 4 );
+				std::memcpy( &chunkType, file.GetData() + binOffset + 4, 4 );
+				if ( chunkType == 0x004E4942 && binOffset + 8 + chunkLength <= file.GetSize() )
+					binaryChunk = { file.GetData() + binOffset + 8, chunkLength };
+			}
+		}
+
+		JsonValue root;
+		if ( !JsonParser( json, jsonEnd ).Parse( root ) || root.Kind != JsonValue::Type::Object )
+		{
+			std::cout << "Invalid glTF JSON in " << path << std::endl;
+			return false;
+		}
+
+		// Buffers: the BIN chunk, base64 data URIs or files next to the asset.
+		const size_t slash = path.find_last_of( "/\\" );
+		const std::string directory = slash == std::string::npos ? "" : path.substr( 0, slash + 1 );
+		const JsonValue& bufferList = root["buffers"];
+		std::vector< GltfBuffer > buffers( bufferList.GetSize(), GltfBuffer{ nullptr, 0 } );
+		std::vector< std::vector< unsigned char > > decoded( bufferList.GetSize() );
+		std::vector< MappedFile > files;
+		for ( size_t i = 0; i < bufferList.GetSize(); i++ )
+		{
+			const std::string& uri = bufferList[i]["uri"].String;
+			if ( uri.empty() )
+				buffers[i] = binaryChunk;
+			else if ( uri.compare( 0, 5, "data:" ) == 0 )
+			{
+				const size_t comma = uri.find( ',' );
+				if ( comma == std::string::npos || uri.find( ";base64" ) > comma || !DecodeBase64( uri.data() + comma + 1, uri.data() + uri.size(), decoded[i] ) )
+				{
+					std::cout << "Unsupported glTF buffer URI in " << path << std::endl;
+					return false;
+				}
+				buffers[i] = { decoded[i].data(), decoded[i].size() };
+			}
+			else
+			{
+				files.emplace_back( directory + DecodeUri( uri ) );
+				if ( !files.back().IsOpen() )
+				{
+					std::cout << "Failed to open glTF buffer " << directory + uri << std::endl;
+					return false;
+				}
+				buffers[i] = { files.back().GetData(), files.back().GetSize() };
+			}
+		}
+
+		// Every primitive of every node of the default scene, or of every mesh without scenes.
+		std::vector< GltfPrimitive > primitives;
+		const JsonValue& scene = root["scenes"][(size_t) root["scene"].GetNumber()];
+		if ( !scene.IsNull() )
+		{
+			for ( size_t i = 0; i < scene["nodes"].GetSize(); i++ )
+				CollectGltfPrimitives( root, (size_t) scene["nodes"][i].GetNumber(), glm::mat4( 1.0f ), 0, primitives );
+		}
+		else
+		{
+			for ( size_t i = 0; i < root["meshes"].GetSize(); i++ )
+			{
+				const JsonValue& meshPrimitives = root["meshes"][i]["primitives"];
+				for ( size_t j = 0; j < meshPrimitives.GetSize(); j++ )
+					primitives.push_back( { &meshPrimitives[j], glm::mat4( 1.0f ) } );
+			}
+		}
+
+		// Decode the primitives in parallel, then append them in order.
+		std::vector< MeshData > parts( primitives.size() );
+		std::vector< char > loaded( primitives.size(), 0 );
+		ParallelFor( primitives.size(), threadCount, [&]( size_t i )
+		{
+			// Points and lines are skipped, only triangle lists (mode 4) are supported.
+			if ( ( *primitives[i].Primitive )["mode"].GetNumber( 4.0 ) == 4.0 )
+				loaded[i] = LoadGltfPrimitive( root, buffers, primitives[i], parts[i] );
+		} );
+
+		mesh = MeshData();
+		const bool hasTexCoords = std::any_of( parts.begin(), parts.end(), []( const MeshData& part ) { return !part.TexCoords.empty(); } );
+		for ( size_t i = 0; i < parts.size(); i++ )
+		{
+			if ( !loaded[i] )
+			{
+				std::cout << "Skipped primitive " << i << " of " << path << std::endl;
+				continue;
+			}
+
+			MeshData& part = parts[i];
+			const uint32_t baseVertex = mesh.GetVertexCount();
+			mesh.Positions.insert( mesh.Positions.end(), part.Positions.begin(), part.Positions.end() );
+			mesh.Normals.insert( mesh.Normals.end(), part.Normals.begin(), part.Normals.end() );
+			if ( hasTexCoords )
+			{
+				part.TexCoords.resize( part.GetVertexCount() * 2, 0.0f );
+				mesh.TexCoords.insert( mesh.TexCoords.end(), part.TexCoords.begin(), part.TexCoords.end() );
+			}
+			for ( uint32_t index : part.Indices )
+				mesh.Indices.push_back( baseVertex + index );
+		}
+		return !mesh.Indices.empty();
+	}
+
+	bool Load( const std::string& path, MeshData& mesh, unsigned int threadCount )
+	{
+		const std::string extension = GetExtension( path );
+		if ( extension == ".obj" )
+			return LoadObj( path, mesh, threadCount );
+		if ( extension == ".gltf" || extension == ".glb" )
+			return LoadGltf( path, mesh, threadCount );
+
+		std::cout << "Unsupported mesh format " << path << std::endl;
+		return false;
+	}
+}
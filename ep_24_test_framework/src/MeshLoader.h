@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Triangle list in plain float arrays, as parsed from a source asset.
+struct MeshData
+{
+	std::vector< float > Positions; // xyz per vertex.
+	std::vector< float > TexCoords; // uv per vertex, empty when the source has none.
+	std::vector< float > Normals; // xyz per vertex, generated when the source has none.
+	std::vector< uint32_t > Indices;
+
+	inline unsigned int GetVertexCount() const { return (unsigned int) ( Positions.size() / 3 ); }
+};
+
+// Parsers for source mesh files, see MeshCooker.h for turning the result into a
+// cooked mesh. "threadCount" 0 uses one thread per core.
+namespace meshloader
+{
+	// Wavefront OBJ: v, vt, vn and polygonal faces, triangulated as fans.
+	// Objects, groups and materials are ignored, everything becomes one mesh.
+	bool LoadObj( const std::string& path, MeshData& mesh, unsigned int threadCount = 0 );
+
+	// glTF 2.0, .gltf with external or base64 buffers or .glb: the triangle
+	// primitives of every node of the default scene, with the node transforms applied.
+	bool LoadGltf( const std::string& path, MeshData& mesh, unsigned int threadCount = 0 );
+
+	// Picks the parser from the extension.
+	bool Load( const std::string& path, MeshData& mesh, unsigned int threadCount = 0 );
+
+	// Smooth normals, the sum of the adjacent face normals weighted by area.
+	void GenerateNormals( MeshData& mesh );
+}
@@ -0,0 +1,525 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "glm/glm.hpp"
+
+namespace meshoptimizer
+{
+	static constexpr uint32_t NO_VERTEX = ~0u;
+	static constexpr uint32_t NO_TRIANGLE = ~0u;
+
+	// Triangles using each vertex, as ranges of one array.
+	struct TriangleAdjacency
+	{
+		std::vector< uint32_t > Counts;
+		std::vector< uint32_t > Offsets;
+		std::vector< uint32_t > Triangles;
+	};
+
+	static void BuildAdjacency( const uint32_t* indices, size_t indexCount, size_t vertexCount, TriangleAdjacency& adjacency )
+	{
+		adjacency.Counts.assign( vertexCount, 0 );
+		for ( size_t i = 0; i < indexCount; i++ )
+			adjacency.Counts[indices[i]]++;
+
+		adjacency.Offsets.resize( vertexCount );
+		uint32_t offset = 0;
+		for ( size_t v = 0; v < vertexCount; v++ )
+		{
+			adjacency.Offsets[v] = offset;
+			offset += adjacency.Counts[v];
+		}
+
+		adjacency.Triangles.resize( indexCount );
+		std::vector< uint32_t > fill = adjacency.Offsets;
+		for ( size_t i = 0; i < indexCount; i++ )
+			adjacency.Triangles[fill[indices[i]]++] = (uint32_t) ( i / 3 );
+	}
+
+	// FIFO post-transform cache: a vertex is cached while fewer than "size" misses happened since its own.
+	class VertexCache
+	{
+	private:
+		std::vector< uint32_t > m_Timestamps;
+		uint32_t m_Time;
+		unsigned int m_Size;
+
+	public:
+		VertexCache( size_t vertexCount, unsigned int size ) : m_Timestamps( vertexCount, 0 ), m_Time( size + 1 ), m_Size( size ) {}
+
+		// Returns true on a miss, which transforms the vertex.
+		inline bool Access( uint32_t vertex )
+		{
+			if ( m_Time - m_Timestamps[vertex] <= m_Size )
+				return false;
+			m_Timestamps[vertex] = m_Time++;
+			return true;
+		}
+
+		inline void Reset() { m_Time += m_Size + 1; }
+	};
+
+	void OptimizeVertexCacheTipsify( uint32_t* indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize, std::vector< uint32_t >* clusters )
+	{
+		if ( clusters )
+			clusters->clear();
+		const size_t triangleCount = indexCount / 3;
+		if ( triangleCount == 0 )
+			return;
+
+		TriangleAdjacency adjacency;
+		BuildAdjacency( indices, triangleCount * 3, vertexCount, adjacency );
+
+		std::vector< uint32_t > liveTriangles = adjacency.Counts;
+		std::vector< uint32_t > cacheTimes( vertexCount, 0 );
+		std::vector< char > emitted( triangleCount, 0 );
+		std::vector< uint32_t > deadEnds;
+		std::vector< uint32_t > candidates;
+		std::vector< uint32_t > result;
+		result.reserve( triangleCount * 3 );
+		deadEnds.reserve( triangleCount * 3 );
+
+		uint32_t time = cacheSize + 1;
+		uint32_t cursor = 0;
+		uint32_t current = indices[0];
+		if ( clusters )
+			clusters->push_back( 0 );
+
+		while ( current != NO_VERTEX )
+		{
+			// Fan out every remaining triangle around the current vertex.
+			candidates.clear();
+			const uint32_t* triangles = &adjacency.Triangles[adjacency.Offsets[current]];
+			for ( uint32_t i = 0; i < adjacency.Counts[current]; i++ )
+			{
+				const uint32_t triangle = triangles[i];
+				if ( emitted[triangle] )
+					continue;
+				emitted[triangle] = 1;
+
+				for ( int c = 0; c < 3; c++ )
+				{
+					const uint32_t vertex = indices[triangle * 3 + c];
+					result.push_back( vertex );
+					deadEnds.push_back( vertex );
+					candidates.push_back( vertex );
+					liveTriangles[vertex]--;
+					if ( time - cacheTimes[vertex] > cacheSize )
+						cacheTimes[vertex] = time++;
+				}
+			}
+
+			// Next: the candidate that will still be cached once its own triangles are
+			// emitted, the oldest one first. Otherwise any candidate with triangles left.
+			uint32_t next = NO_VERTEX;
+			int bestPriority = -1;
+			for ( uint32_t vertex : candidates )
+			{
+				if ( liveTriangles[vertex] == 0 )
+					continue;
+				int priority = 0;
+				if ( time - cacheTimes[vertex] + 2 * liveTriangles[vertex] <= cacheSize )
+					priority = (int) ( time - cacheTimes[vertex] );
+				if ( priority > bestPriority )
+				{
+					bestPriority = priority;
+					next = vertex;
+				}
+			}
+
+			// Dead end: back to a recently used vertex, or the next unfinished one in index order.
+			if ( next == NO_VERTEX )
+			{
+				while ( !deadEnds.empty() && next == NO_VERTEX )
+				{
+					if ( liveTriangles[deadEnds.back()] > 0 )
+						next = deadEnds.back();
+					deadEnds.pop_back();
+				}
+				while ( next == NO_VERTEX && cursor < vertexCount )
+				{
+					if ( liveTriangles[cursor] > 0 )
+						next = cursor;
+					cursor++;
+				}
+				if ( next != NO_VERTEX && clusters )
+					clusters->push_back( (uint32_t) ( result.size() / 3 ) );
+			}
+			current = next;
+		}
+
+		std::copy( result.begin(), result.end(), indices );
+	}
+
+	// Forsyth's scoring: recently used vertices and vertices with few triangles left first.
+	static const unsigned int FORSYTH_CACHE_SIZE = 32;
+	static const unsigned int FORSYTH_VALENCE_TABLE_SIZE = 32;
+
+	static float GetForsythScore( int cachePosition, uint32_t liveTriangles )
+	{
+		static float cacheScores[FORSYTH_CACHE_SIZE];
+		static float valenceScores[FORSYTH_VALENCE_TABLE_SIZE];
+		static const bool initialized = []()
+		{
+			for ( unsigned int i = 0; i < FORSYTH_CACHE_SIZE; i++ )
+			{
+				// The last triangle's vertices get a fixed score, so it is not simply repeated.
+				cacheScores[i] = i < 3 ? 0.75f : std::pow( 1.0f - ( i - 3 ) / (float) ( FORSYTH_CACHE_SIZE - 3 ), 1.5f );
+			}
+			valenceScores[0] = 0.0f;
+			for ( unsigned int i = 1; i < FORSYTH_VALENCE_TABLE_SIZE; i++ )
+				valenceScores[i] = 2.0f / std::sqrt( (float) i );
+			return true;
+		}();
+		(void) initialized;
+
+		if ( liveTriangles == 0 )
+			return -1.0f;
+		const float valenceScore = liveTriangles < FORSYTH_VALENCE_TABLE_SIZE ? valenceScores[liveTriangles] : 2.0f / std::sqrt( (float) liveTriangles );
+		return ( cachePosition < 0 ? 0.0f : cacheScores[cachePosition] ) + valenceScore;
+	}
+
+	void OptimizeVertexCacheForsyth( uint32_t* indices, size_t indexCount, size_t vertexCount )
+	{
+		const size_t triangleCount = indexCount / 3;
+		if ( triangleCount == 0 )
+			return;
+
+		// The live triangles of a vertex are the first liveTriangles[v] of its adjacency range.
+		TriangleAdjacency adjacency;
+		BuildAdjacency( indices, triangleCount * 3, vertexCount, adjacency );
+		std::vector< uint32_t > liveTriangles = adjacency.Counts;
+
+		std::vector< int > cachePositions( vertexCount, -1 );
+		std::vector< float > vertexScores( vertexCount );
+		for ( size_t v = 0; v < vertexCount; v++ )
+			vertexScores[v] = GetForsythScore( -1, liveTriangles[v] );
+
+		std::vector< float > triangleScores( triangleCount );
+		uint32_t best = 0;
+		for ( size_t t = 0; t < triangleCount; t++ )
+		{
+			triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+			if ( triangleScores[t] > triangleScores[best] )
+				best = (uint32_t) t;
+		}
+
+		std::vector< char > emitted( triangleCount, 0 );
+		std::vector< uint32_t > cache, newCache;
+		std::vector< uint32_t > result( triangleCount * 3 );
+		uint32_t cursor = 0;
+		for ( size_t output = 0; output < triangleCount; output++ )
+		{
+			// Nothing cached has triangles left, continue in input order.
+			if ( best == NO_TRIANGLE )
+			{
+				while ( emitted[cursor] )
+					cursor++;
+				best = cursor;
+			}
+
+			emitted[best] = 1;
+			newCache.clear();
+			for ( int c = 0; c < 3; c++ )
+			{
+				const uint32_t vertex = indices[best * 3 + c];
+				result[output * 3 + c] = vertex;
+
+				uint32_t* triangles = &adjacency.Triangles[adjacency.Offsets[vertex]];
+				uint32_t* last = triangles + liveTriangles[vertex];
+				uint32_t* found = std::find( triangles, last, best );
+				if ( found != last )
+				{
+					*found = *( last - 1 );
+					liveTriangles[vertex]--;
+				}
+				if ( std::find( newCache.begin(), newCache.end(), vertex ) == newCache.end() )
+					newCache.push_back( vertex );
+			}
+			const size_t emittedVertices = newCache.size();
+			for ( uint32_t vertex : cache )
+			{
+				if ( std::find( newCache.begin(), newCache.begin() + emittedVertices, vertex ) == newCache.begin() + emittedVertices )
+					newCache.push_back( vertex );
+			}
+
+			// Rescore the cached vertices and the ones pushed out, then pick the best
+			// triangle among those using a cached vertex.
+			for ( size_t i = 0; i < newCache.size(); i++ )
+			{
+				const uint32_t vertex = newCache[i];
+				cachePositions[vertex] = i < FORSYTH_CACHE_SIZE ? (int) i : -1;
+				const float score = GetForsythScore( cachePositions[vertex], liveTriangles[vertex] );
+				const float delta = score - vertexScores[vertex];
+				vertexScores[vertex] = score;
+
+				const uint32_t* triangles = &adjacency.Triangles[adjacency.Offsets[vertex]];
+				for ( uint32_t j = 0; j < liveTriangles[vertex]; j++ )
+					triangleScores[triangles[j]] += delta;
+			}
+
+			best = NO_TRIANGLE;
+			float bestScore = -1.0f;
+			newCache.resize( std::min< size_t >( newCache.size(), FORSYTH_CACHE_SIZE ) );
+			for ( uint32_t vertex : newCache )
+			{
+				const uint32_t* triangles = &adjacency.Triangles[adjacency.Offsets[vertex]];
+				for ( uint32_t j = 0; j < liveTriangles[vertex]; j++ )
+				{
+					if ( triangleScores[triangles[j]] > bestScore )
+					{
+						bestScore = triangleScores[triangles[j]];
+						best = triangles[j];
+					}
+				}
+			}
+			std::swap( cache, newCache );
+		}
+
+		std::copy( result.begin(), result.end(), indices );
+	}
+
+	void OptimizeOverdraw( uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount, size_t stride,
+						   const std::vector< uint32_t >& clusters, unsigned int cacheSize, float threshold )
+	{
+		const size_t triangleCount = indexCount / 3;
+		if ( triangleCount == 0 )
+			return;
+
+		// Cut every cluster where the part before the cut, drawn from a cold cache,
+		// is almost as cache friendly as the whole cluster.
+		std::vector< uint32_t > boundaries = clusters;
+		if ( boundaries.empty() || boundaries[0] != 0 )
+			boundaries.insert( boundaries.begin(), 0 );
+		boundaries.push_back( (uint32_t) triangleCount );
+
+		std::vector< uint32_t > pieces;
+		VertexCache cache( vertexCount, cacheSize );
+		for ( size_t i = 0; i + 1 < boundaries.size(); i++ )
+		{
+			const uint32_t begin = boundaries[i], end = boundaries[i + 1];
+			if ( begin >= end )
+				continue;
+			cache.Reset();
+			uint32_t clusterMisses = 0;
+			for ( uint32_t j = begin * 3; j < end * 3; j++ )
+				clusterMisses += cache.Access( indices[j] ) ? 1 : 0;
+			const float clusterAcmr = clusterMisses / (float) ( end - begin );
+
+			cache.Reset();
+			pieces.push_back( begin );
+			uint32_t pieceBegin = begin, misses = 0;
+			for ( uint32_t t = begin; t < end; t++ )
+			{
+				for ( int c = 0; c < 3; c++ )
+					misses += cache.Access( indices[t * 3 + c] ) ? 1 : 0;
+				if ( t + 1 < end && misses <= clusterAcmr * threshold * ( t + 1 - pieceBegin ) )
+				{
+					cache.Reset();
+					pieceBegin = t + 1;
+					misses = 0;
+					pieces.push_back( pieceBegin );
+				}
+			}
+		}
+		pieces.push_back( (uint32_t) triangleCount );
+
+		// Area weighted centroid and normal of every piece and of the whole mesh.
+		const auto position = [&]( uint32_t vertex )
+		{
+			const float* p = reinterpret_cast< const float* >( reinterpret_cast< const unsigned char* >( positions ) + vertex * stride );
+			return glm::vec3( p[0], p[1], p[2] );
+		};
+		const size_t pieceCount = pieces.size() - 1;
+		std::vector< glm::vec3 > centroids( pieceCount ), normals( pieceCount );
+		glm::vec3 meshCentroid( 0.0f );
+		float meshArea = 0.0f;
+		for ( size_t i = 0; i < pieceCount; i++ )
+		{
+			glm::vec3 centroid( 0.0f ), normal( 0.0f );
+			float area = 0.0f;
+			for ( uint32_t t = pieces[i]; t < pieces[i + 1]; t++ )
+			{
+				const glm::vec3 a = position( indices[t * 3] ), b = position( indices[t * 3 + 1] ), c = position( indices[t * 3 + 2] );
+				const glm::vec3 cross = glm::cross( b - a, c - a );
+				const float triangleArea = glm::length( cross );
+				centroid += ( a + b + c ) * ( triangleArea / 3.0f );
+				normal += cross;
+				area += triangleArea;
+			}
+			meshCentroid += centroid;
+			meshArea += area;
+			centroids[i] = area > 0.0f ? centroid / area : centroid;
+			const float length = glm::length( normal );
+			normals[i] = length > 0.0f ? normal / length : normal;
+		}
+		if ( meshArea > 0.0f )
+			meshCentroid /= meshArea;
+
+		// Pieces further out along their normal first.
+		std::vector< float > sortKeys( pieceCount );
+		std::vector< uint32_t > order( pieceCount );
+		for ( size_t i = 0; i < pieceCount; i++ )
+		{
+			sortKeys[i] = glm::dot( centroids[i] - meshCentroid, normals[i] );
+			order[i] = (uint32_t) i;
+		}
+		std::stable_sort( order.begin(), order.end(), [&]( uint32_t a, uint32_t b ) { return sortKeys[a] > sortKeys[b]; } );
+
+		std::vector< uint32_t > result;
+		result.reserve( triangleCount * 3 );
+		for ( uint32_t piece : order )
+			result.insert( result.end(), indices + pieces[piece] * 3, indices + pieces[piece + 1] * 3 );
+		std::copy( result.begin(), result.end(), indices );
+	}
+
+	size_t OptimizeVertexFetch( void* vertices, uint32_t* indices, size_t indexCount, size_t vertexCount, size_t vertexSize )
+	{
+		unsigned char* data = static_cast< unsigned char* >( vertices );
+		std::vector< uint32_t > remap( vertexCount, NO_VERTEX );
+		std::vector< unsigned char > ordered;
+		ordered.reserve( vertexCount * vertexSize );
+		uint32_t count = 0;
+		for ( size_t i = 0; i < indexCount; i++ )
+		{
+			uint32_t& index = indices[i];
+			if ( remap[index] == NO_VERTEX )
+			{
+				remap[index] = count++;
+				ordered.insert( ordered.end(), data + index * vertexSize, data + ( index + 1 ) * vertexSize );
+			}
+			index = remap[index];
+		}
+		std::memcpy( data, ordered.data(), ordered.size() );
+		return count;
+	}
+
+	static void ComputeMeshletBounds( const uint32_t* indices, const float* positions, size_t stride, Meshlet& meshlet )
+	{
+		const auto position = [&]( uint32_t vertex )
+		{
+			const float* p = reinterpret_cast< const float* >( reinterpret_cast< const unsigned char* >( positions ) + vertex * stride );
+			return glm::vec3( p[0], p[1], p[2] );
+		};
+
+		// Sphere around the center of the bounding box.
+		glm::vec3 boxMin( position( indices[0] ) ), boxMax( boxMin );
+		for ( uint32_t i = 1; i < meshlet.IndexCount; i++ )
+		{
+			boxMin = glm::min( boxMin, position( indices[i] ) );
+			boxMax = glm::max( boxMax, position( indices[i] ) );
+		}
+		const glm::vec3 center = 0.5f * ( boxMin + boxMax );
+		float radius = 0.0f;
+		for ( uint32_t i = 0; i < meshlet.IndexCount; i++ )
+			radius = std::max( radius, glm::length( position( indices[i] ) - center ) );
+
+		// Cone around the average normal, as wide as the normal furthest from it.
+		std::vector< glm::vec3 > normals;
+		glm::vec3 axis( 0.0f );
+		for ( uint32_t i = 0; i < meshlet.IndexCount; i += 3 )
+		{
+			const glm::vec3 a = position( indices[i] ), b = position( indices[i + 1] ), c = position( indices[i + 2] );
+			const glm::vec3 normal = glm::cross( b - a, c - a );
+			const float length = glm::length( normal );
+			if ( length > 0.0f )
+			{
+				normals.push_back( normal / length );
+				axis += normals.back();
+			}
+		}
+		const float axisLength = glm::length( axis );
+		float minDot = 1.0f;
+		if ( axisLength > 0.0f )
+		{
+			axis /= axisLength;
+			for ( const glm::vec3& normal : normals )
+				minDot = std::min( minDot, glm::dot( normal, axis ) );
+		}
+
+		std::copy_n( &center.x, 3, meshlet.Center );
+		meshlet.Radius = radius;
+		// Nearly flat cones cull almost nothing, they are not worth the test.
+		if ( axisLength == 0.0f || minDot <= 0.1f )
+		{
+			std::fill_n( meshlet.ConeAxis, 3, 0.0f );
+			meshlet.ConeCutoff = 1.0f;
+		}
+		else
+		{
+			std::copy_n( &axis.x, 3, meshlet.ConeAxis );
+			// Sine of the cone angle: the view direction must be within 90 degrees minus it of the axis.
+			meshlet.ConeCutoff = std::sqrt( 1.0f - minDot * minDot );
+		}
+	}
+
+	void BuildMeshlets( const uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount, size_t stride,
+						std::vector< Meshlet >& meshlets, unsigned int maxVertices, unsigned int maxTriangles )
+	{
+		meshlets.clear();
+		const size_t triangleCount = indexCount / 3;
+
+		// Vertices are counted once per meshlet, stamped with the meshlet they were last seen in.
+		std::vector< uint32_t > stamps( vertexCount, NO_VERTEX );
+		Meshlet meshlet = {};
+		const auto finish = [&]()
+		{
+			if ( meshlet.IndexCount == 0 )
+				return;
+			ComputeMeshletBounds( indices + meshlet.FirstIndex, positions, stride, meshlet );
+			meshlets.push_back( meshlet );
+		};
+
+		for ( size_t t = 0; t < triangleCount; t++ )
+		{
+			const uint32_t* triangle = indices + t * 3;
+			const uint32_t a = triangle[0], b = triangle[1], c = triangle[2];
+			uint32_t id = (uint32_t) meshlets.size();
+			const unsigned int newVertices = ( stamps[a] != id ? 1 : 0 ) + ( stamps[b] != id && b != a ? 1 : 0 ) + ( stamps[c] != id && c != a && c != b ? 1 : 0 );
+			if ( meshlet.VertexCount + newVertices > maxVertices || meshlet.IndexCount / 3 >= maxTriangles )
+			{
+				finish();
+				meshlet = {};
+				meshlet.FirstIndex = (uint32_t) ( t * 3 );
+				id = (uint32_t) meshlets.size();
+			}
+
+			for ( uint32_t vertex : { a, b, c } )
+			{
+				if ( stamps[vertex] != id )
+				{
+					stamps[vertex] = id;
+					meshlet.VertexCount++;
+				}
+			}
+			meshlet.IndexCount += 3;
+		}
+		finish();
+	}
+
+	VertexCacheStatistics AnalyzeVertexCache( const uint32_t* indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize )
+	{
+		VertexCache cache( vertexCount, cacheSize );
+		std::vector< char > used( vertexCount, 0 );
+		unsigned int usedCount = 0;
+		VertexCacheStatistics statistics = { 0, 0.0f, 0.0f };
+		for ( size_t i = 0; i < indexCount; i++ )
+		{
+			statistics.VerticesTransformed += cache.Access( indices[i] ) ? 1 : 0;
+			if ( !used[indices[i]] )
+			{
+				used[indices[i]] = 1;
+				usedCount++;
+			}
+		}
+
+		if ( indexCount >= 3 )
+			statistics.Acmr = statistics.VerticesTransformed / (float) ( indexCount / 3 );
+		if ( usedCount > 0 )
+			statistics.Atvr = statistics.VerticesTransformed / (float) usedCount;
+		return statistics;
+	}
+}
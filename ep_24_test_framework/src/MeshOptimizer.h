@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Post-transform vertex cache efficiency of a triangle list, for a FIFO cache of a given size.
+struct VertexCacheStatistics
+{
+	unsigned int VerticesTransformed;
+	// Average cache miss ratio: transformed vertices per triangle, 0.5 at best, 3 at worst.
+	float Acmr;
+	// Average transform to vertex ratio: transformed vertices per vertex, 1 at best.
+	float Atvr;
+};
+
+// Run of consecutive triangles of an index buffer with the bounds to cull it as a
+// whole. Laid out like the std430 struct of res/shaders/MeshletCull.shader, so an
+// array of them is uploaded as it is.
+struct Meshlet
+{
+	// Bounding sphere.
+	float Center[3];
+	float Radius;
+	// Normal cone: every triangle faces away from a viewer at "eye" when
+	// dot( Center - eye, ConeAxis ) >= ConeCutoff * length( Center - eye ) + Radius.
+	// A zero axis with cutoff 1 never culls.
+	float ConeAxis[3];
+	float ConeCutoff;
+	uint32_t FirstIndex;
+	uint32_t IndexCount;
+	uint32_t VertexCount;
+	uint32_t Padding;
+};
+
+// Reordering of indexed triangle lists so the GPU does less work for the same image.
+// Nothing here changes what is drawn: triangles keep their winding, vertices their
+// contents. The usual order is a vertex cache optimization, then OptimizeOverdraw
+// with the clusters it found, then OptimizeVertexFetch.
+namespace meshoptimizer
+{
+	// Tipsify (Sander, Nehab and Barczak 2007): linear time, tuned for a FIFO cache of
+	// "cacheSize" entries. When "clusters" is given it receives the first triangle of
+	// every run of triangles that ends in a dead end, for OptimizeOverdraw.
+	void OptimizeVertexCacheTipsify( uint32_t* indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize = 16,
+									 std::vector< uint32_t >* clusters = nullptr );
+
+	// Forsyth's greedy triangle order for an LRU cache, slower than Tipsify but
+	// usually a little better and less dependent on the actual cache size.
+	void OptimizeVertexCacheForsyth( uint32_t* indices, size_t indexCount, size_t vertexCount );
+
+	// Splits the clusters of a cache optimized order further, as long as a split costs
+	// less than "threshold" times the cluster's ACMR, and sorts them so the ones facing
+	// away from the mesh center, which tend to occlude the others, are drawn first.
+	// "positions" holds xyz floats every "stride" bytes.
+	void OptimizeOverdraw( uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount, size_t stride,
+						   const std::vector< uint32_t >& clusters, unsigned int cacheSize = 16, float threshold = 1.05f );
+
+	// Reorders the vertices of "vertexSize" bytes by first use and rewrites the indices,
+	// so the vertex fetch reads memory mostly in order. Unused vertices are dropped.
+	// Returns the new vertex count.
+	size_t OptimizeVertexFetch( void* vertices, uint32_t* indices, size_t indexCount, size_t vertexCount, size_t vertexSize );
+
+	// Cuts the triangle list, in its current order, into meshlets of at most "maxVertices"
+	// distinct vertices and "maxTriangles" triangles. Best after the vertex cache and
+	// overdraw optimizations, whose orders keep neighboring triangles together.
+	void BuildMeshlets( const uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount, size_t stride,
+						std::vector< Meshlet >& meshlets, unsigned int maxVertices = 64, unsigned int maxTriangles = 124 );
+
+	VertexCacheStatistics AnalyzeVertexCache( const uint32_t* indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize = 16 );
+}
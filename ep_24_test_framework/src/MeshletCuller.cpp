@@ -0,0 +1,117 @@
+#include "MeshletCuller.h"
+#include "DepthPyramid.h"
+#include "Frustum.h"
+#include "Mesh.h"
+#include "Texture.h"
+#include "Debug.h"
+
+#include "glm/gtc/type_ptr.hpp"
+
+MeshletCuller::MeshletCuller( const Mesh& mesh, unsigned int instanceCount )
+	: m_MeshletCount( (unsigned int) mesh.GetMeshlets().size() ), m_InstanceCount( instanceCount ),
+	m_IndexCount( mesh.GetIndexBuffer().GetCount() ), m_ShortIndices( mesh.GetIndexBuffer().GetType() == GL_UNSIGNED_SHORT ),
+	m_ConeCulling( true ), m_OcclusionCulling( true ),
+	m_Shader( "res/shaders/MeshletCull.shader" ),
+	m_Meshlets( mesh.GetMeshlets().data(), m_MeshletCount * (unsigned int) sizeof( Meshlet ), BufferUsage::Static ),
+	m_SourceIndices( nullptr, ( m_IndexCount * mesh.GetIndexBuffer().GetIndexSize() + 3 ) & ~3u, BufferUsage::Static ),
+	m_Models( nullptr, instanceCount * (unsigned int) sizeof( glm::mat4 ), BufferUsage::Stream ),
+	m_Visibility( nullptr, m_MeshletCount * instanceCount * (unsigned int) sizeof( uint32_t ), BufferUsage::Copy ),
+	m_Commands( GL_DRAW_INDIRECT_BUFFER, nullptr, 2 * instanceCount * (unsigned int) sizeof( DrawElementsIndirectCommand ), BufferUsage::Dynamic ),
+	m_Indices( BufferUsage::Copy, GL_UNSIGNED_INT, 2 * instanceCount * m_IndexCount ),
+	m_Readback( 2 * instanceCount * (unsigned int) sizeof( DrawElementsIndirectCommand ) ),
+	m_ResetCommands( 2 * instanceCount ), m_LastCommands( 2 * instanceCount )
+{
+	// 8 bit indices would need their own unpacking, cooked meshes never have them.
+	ASSERT( mesh.GetIndexBuffer().GetType() != GL_UNSIGNED_BYTE );
+
+	// The source indices never leave the GPU, the shader reads them as a storage buffer
+	// padded to whole uints.
+	const unsigned int indexDataSize = m_IndexCount * mesh.GetIndexBuffer().GetIndexSize();
+	if ( Renderer::IsDirectStateAccessSupported() )
+	{
+		GLCall( glCopyNamedBufferSubData( mesh.GetIndexBuffer().GetRendererID(), m_SourceIndices.GetRendererID(), 0, 0, indexDataSize ) );
+	}
+	else
+	{
+		GLCall( glBindBuffer( GL_COPY_READ_BUFFER, mesh.GetIndexBuffer().GetRendererID() ) );
+		GLCall( glBindBuffer( GL_COPY_WRITE_BUFFER, m_SourceIndices.GetRendererID() ) );
+		GLCall( glCopyBufferSubData( GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, indexDataSize ) );
+	}
+
+	// Every instance and phase compacts into its own range of the index buffer.
+	for ( unsigned int i = 0; i < 2 * instanceCount; i++ )
+		m_ResetCommands[i] = { 0, 1, i * m_IndexCount, 0, 0 };
+	m_Commands.SetSubData( 0, m_ResetCommands.data(), m_Commands.GetSize() );
+	SetOcclusionCulling( true );
+}
+
+void MeshletCuller::SetOcclusionCulling( bool enabled )
+{
+	if ( enabled )
+	{
+		const std::vector< uint32_t > visibility( m_MeshletCount * m_InstanceCount, 0 );
+		m_Visibility.SetSubData( 0, visibility.data(), m_Visibility.GetSize() );
+	}
+	m_OcclusionCulling = enabled;
+}
+
+void MeshletCuller::BeginFrame( const std::vector< glm::mat4 >& models )
+{
+	ASSERT( models.size() == m_InstanceCount );
+
+	// Recent counts if a copy is ready, never waiting for one.
+	m_Readback.Read( m_LastCommands.data() );
+	m_Commands.SetSubData( 0, m_ResetCommands.data(), m_Commands.GetSize() );
+	m_Models.SetData( models.data(), m_Models.GetSize() );
+}
+
+void MeshletCuller::Cull( const Renderer& renderer, unsigned int phase, const glm::mat4& viewProjection, const glm::vec3& cameraPosition,
+						  const DepthPyramid* pyramid )
+{
+	ASSERT( phase < 2 && ( phase == 0 || ( m_OcclusionCulling && pyramid && pyramid->GetTexture() ) ) );
+	if ( m_MeshletCount == 0 )
+		return;
+
+	const Frustum frustum( viewProjection );
+
+	m_Shader.Bind();
+	m_Shader.SetUniformMat4f( "u_ViewProjection", viewProjection );
+	m_Shader.SetUniform4fv( "u_FrustumPlanes", 6, glm::value_ptr( frustum.Planes[0] ) );
+	m_Shader.SetUniform3f( "u_CameraPosition", cameraPosition.x, cameraPosition.y, cameraPosition.z );
+	m_Shader.SetUniform1i( "u_Phase", (int) phase );
+	m_Shader.SetUniform1i( "u_InstanceCount", (int) m_InstanceCount );
+	m_Shader.SetUniform1i( "u_ShortIndices", m_ShortIndices ? 1 : 0 );
+	m_Shader.SetUniform1i( "u_ConeCulling", m_ConeCulling ? 1 : 0 );
+	m_Shader.SetUniform1i( "u_OcclusionCulling", m_OcclusionCulling ? 1 : 0 );
+	if ( phase == 1 )
+	{
+		pyramid->GetTexture()->Bind( 0 );
+		m_Shader.SetUniform1i( "u_DepthPyramid", 0 );
+	}
+
+	m_Shader.SetStorageBuffer( "Meshlets", m_Meshlets );
+	m_Shader.SetStorageBuffer( "SourceIndices", m_SourceIndices );
+	m_Shader.SetStorageBuffer( "Indices", m_Indices.GetRendererID() );
+	m_Shader.SetStorageBuffer( "Commands", m_Commands.GetRendererID() );
+	m_Shader.SetStorageBuffer( "Visibility", m_Visibility );
+	m_Shader.SetStorageBuffer( "Models", m_Models );
+
+	// One workgroup per meshlet and instance, every implementation allows 65535 groups per dimension.
+	ASSERT( m_MeshletCount <= 65535 && m_InstanceCount <= 65535 );
+	renderer.Dispatch( m_Shader, m_MeshletCount, m_InstanceCount );
+
+	// The draws read the commands and indices, the next phase and frame the visibility.
+	GLCall( glMemoryBarrier( GL_COMMAND_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT ) );
+
+	// The last phase of the frame completes the commands.
+	if ( phase == 1 || !m_OcclusionCulling )
+		m_Readback.Request( m_Commands.GetRendererID() );
+}
+
+unsigned int MeshletCuller::GetDrawnTriangles( unsigned int phase ) const
+{
+	unsigned int count = 0;
+	for ( unsigned int i = 0; i < m_InstanceCount; i++ )
+		count += m_LastCommands[phase * m_InstanceCount + i].Count;
+	return count / 3;
+}
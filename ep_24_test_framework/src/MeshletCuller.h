@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vector>
+
+#include "AsyncReadback.h"
+#include "Buffer.h"
+#include "IndexBuffer.h"
+#include "Renderer.h"
+#include "Shader.h"
+#include "ShaderStorageBuffer.h"
+
+#include "glm/glm.hpp"
+
+class Mesh;
+class DepthPyramid;
+
+// Culls the meshlets (see MeshOptimizer.h) of every instance of a mesh on the GPU with
+// res/shaders/MeshletCull.shader (GL 4.3, see Renderer::IsComputeSupported). Meshlets
+// outside the frustum, facing away from the camera (normal cone) or hidden behind the
+// depth pyramid have their indices left out of a compacted index buffer, drawn with
+// one DrawElementsIndirectCommand per instance and phase whose count the CPU never sees.
+//
+// Occlusion culling takes two phases per frame:
+// 0. Meshlets visible last frame are culled without the pyramid and drawn.
+// 1. The pyramid built from that depth tests every meshlet, the ones that became
+//    visible are drawn too and the visibility is kept for the next frame.
+// Without occlusion culling phase 0 alone draws everything that passes the other tests.
+class MeshletCuller
+{
+private:
+	unsigned int m_MeshletCount;
+	unsigned int m_InstanceCount;
+	unsigned int m_IndexCount;
+	bool m_ShortIndices;
+	bool m_ConeCulling;
+	bool m_OcclusionCulling;
+
+	Shader m_Shader;
+	ShaderStorageBuffer m_Meshlets;
+	// Copy of the mesh indices the shader reads as uints, two per uint when 16 bit.
+	ShaderStorageBuffer m_SourceIndices;
+	ShaderStorageBuffer m_Models;
+	// One uint per meshlet and instance, non-zero when it was visible last frame.
+	ShaderStorageBuffer m_Visibility;
+	Buffer m_Commands;
+	IndexBuffer m_Indices;
+	// Copies of the commands for their counts, so the CPU never waits for the GPU.
+	AsyncReadback m_Readback;
+	std::vector< DrawElementsIndirectCommand > m_ResetCommands;
+	std::vector< DrawElementsIndirectCommand > m_LastCommands;
+
+public:
+	MeshletCuller( const Mesh& mesh, unsigned int instanceCount );
+
+	MeshletCuller( const MeshletCuller& ) = delete;
+	MeshletCuller& operator=( const MeshletCuller& ) = delete;
+
+	inline void SetConeCulling( bool enabled ) { m_ConeCulling = enabled; }
+	// Turning it on again starts from an empty visibility, so phase 1 draws the first frame.
+	void SetOcclusionCulling( bool enabled );
+	inline bool IsOcclusionCulling() const { return m_OcclusionCulling; }
+
+	// Empties the draw commands and uploads one model matrix per instance. Call once
+	// per frame, before phase 0.
+	void BeginFrame( const std::vector< glm::mat4 >& models );
+	// Fills the commands of "phase" (0 or 1). Phase 1 needs the pyramid built after phase 0 was drawn.
+	void Cull( const Renderer& renderer, unsigned int phase, const glm::mat4& viewProjection, const glm::vec3& cameraPosition,
+			   const DepthPyramid* pyramid = nullptr );
+
+	// Draw the compacted indices with the vertex array of the mesh, see Renderer::DrawIndirect.
+	inline const IndexBuffer& GetIndexBuffer() const { return m_Indices; }
+	inline const Buffer& GetCommandBuffer() const { return m_Commands; }
+	inline unsigned int GetCommandOffset( unsigned int phase, unsigned int instance ) const
+	{
+		return ( phase * m_InstanceCount + instance ) * (unsigned int) sizeof( DrawElementsIndirectCommand );
+	}
+
+	inline unsigned int GetMeshletCount() const { return m_MeshletCount; }
+	inline unsigned int GetInstanceCount() const { return m_InstanceCount; }
+	// Triangles a recent frame drew in "phase", read back a frame or two late.
+	unsigned int GetDrawnTriangles( unsigned int phase ) const;
+};
@@ -0,0 +1,244 @@
+#include "OffsetAllocator.h"
+
+#include <algorithm>
+
+static unsigned int HighestBit( unsigned int value )
+{
+	unsigned int bit = 0;
+	while ( value >>= 1 )
+		bit++;
+	return bit;
+}
+
+static unsigned int LowestBit( unsigned int value )
+{
+	unsigned int bit = 0;
+	while ( ( value & 1 ) == 0 )
+	{
+		value >>= 1;
+		bit++;
+	}
+	return bit;
+}
+
+OffsetAllocator::OffsetAllocator( unsigned int size )
+	: m_Size( size ), m_FreeSize( 0 ), m_FirstLevelMask( 0 ), m_SecondLevelMasks{ 0 }, m_LastNode( INVALID )
+{
+	Reset();
+}
+
+void OffsetAllocator::Reset()
+{
+	m_Nodes.clear();
+	m_UnusedNodes.clear();
+	m_FirstLevelMask = 0;
+	std::fill( std::begin( m_SecondLevelMasks ), std::end( m_SecondLevelMasks ), 0 );
+	std::fill( std::begin( m_Bins ), std::end( m_Bins ), INVALID );
+	m_FreeSize = 0;
+	m_LastNode = INVALID;
+
+	if ( m_Size > 0 )
+	{
+		m_LastNode = CreateNode( 0, m_Size );
+		InsertFree( m_LastNode );
+	}
+}
+
+unsigned int OffsetAllocator::GetBin( unsigned int size, bool roundUp )
+{
+	// Sizes below 8 get a bin each, above that 8 bins per power of two.
+	if ( size < SECOND_LEVEL_COUNT )
+		return size;
+
+	const unsigned int shift = HighestBit( size ) - SECOND_LEVEL_BITS;
+	// Rounding up makes any block in the bin large enough.
+	if ( roundUp && ( size & ( ( 1u << shift ) - 1 ) ) )
+	{
+		size += 1u << shift;
+		if ( HighestBit( size ) - SECOND_LEVEL_BITS != shift )
+			return ( shift + 2 ) * SECOND_LEVEL_COUNT;
+	}
+	const unsigned int firstLevel = shift + 1;
+	const unsigned int secondLevel = ( size >> shift ) - SECOND_LEVEL_COUNT;
+	return firstLevel * SECOND_LEVEL_COUNT + secondLevel;
+}
+
+unsigned int OffsetAllocator::FindBin( unsigned int minimumBin ) const
+{
+	const unsigned int firstLevel = minimumBin / SECOND_LEVEL_COUNT;
+	if ( firstLevel >= FIRST_LEVEL_COUNT )
+		return INVALID;
+
+	const unsigned int secondLevelMask = m_SecondLevelMasks[firstLevel] & ( ~0u << ( minimumBin % SECOND_LEVEL_COUNT ) );
+	if ( secondLevelMask )
+		return firstLevel * SECOND_LEVEL_COUNT + LowestBit( secondLevelMask );
+
+	if ( firstLevel + 1 >= FIRST_LEVEL_COUNT )
+		return INVALID;
+	const unsigned int firstLevelMask = m_FirstLevelMask & ( ~0u << ( firstLevel + 1 ) );
+	if ( firstLevelMask == 0 )
+		return INVALID;
+
+	const unsigned int level = LowestBit( firstLevelMask );
+	return level * SECOND_LEVEL_COUNT + LowestBit( m_SecondLevelMasks[level] );
+}
+
+unsigned int OffsetAllocator::CreateNode( unsigned int offset, unsigned int size )
+{
+	unsigned int index;
+	if ( !m_UnusedNodes.empty() )
+	{
+		index = m_UnusedNodes.back();
+		m_UnusedNodes.pop_back();
+	}
+	else
+	{
+		index = (unsigned int) m_Nodes.size();
+		m_Nodes.push_back( {} );
+	}
+	m_Nodes[index] = { offset, size, INVALID, INVALID, INVALID, INVALID, false };
+	return index;
+}
+
+void OffsetAllocator::InsertFree( unsigned int index )
+{
+	Node& node = m_Nodes[index];
+	const unsigned int bin = GetBin( node.Size, false );
+	node.Used = false;
+	node.PrevFree = INVALID;
+	node.NextFree = m_Bins[bin];
+	if ( node.NextFree != INVALID )
+		m_Nodes[node.NextFree].PrevFree = index;
+	m_Bins[bin] = index;
+
+	m_FirstLevelMask |= 1u << ( bin / SECOND_LEVEL_COUNT );
+	m_SecondLevelMasks[bin / SECOND_LEVEL_COUNT] |= 1u << ( bin % SECOND_LEVEL_COUNT );
+	m_FreeSize += node.Size;
+}
+
+void OffsetAllocator::RemoveFree( unsigned int index )
+{
+	Node& node = m_Nodes[index];
+	const unsigned int bin = GetBin( node.Size, false );
+	if ( node.PrevFree != INVALID )
+		m_Nodes[node.PrevFree].NextFree = node.NextFree;
+	else
+		m_Bins[bin] = node.NextFree;
+	if ( node.NextFree != INVALID )
+		m_Nodes[node.NextFree].PrevFree = node.PrevFree;
+
+	if ( m_Bins[bin] == INVALID )
+	{
+		m_SecondLevelMasks[bin / SECOND_LEVEL_COUNT] &= ~( 1u << ( bin % SECOND_LEVEL_COUNT ) );
+		if ( m_SecondLevelMasks[bin / SECOND_LEVEL_COUNT] == 0 )
+			m_FirstLevelMask &= ~( 1u << ( bin / SECOND_LEVEL_COUNT ) );
+	}
+	m_FreeSize -= node.Size;
+}
+
+OffsetAllocator::Allocation OffsetAllocator::Allocate( unsigned int size )
+{
+	size = std::max( size, 1u );
+	const unsigned int bin = FindBin( GetBin( size, true ) );
+	if ( bin == INVALID )
+		return { INVALID, 0, INVALID };
+
+	const unsigned int index = m_Bins[bin];
+	RemoveFree( index );
+	m_Nodes[index].Used = true;
+
+	// Return the rest of the block to the bins.
+	if ( m_Nodes[index].Size > size )
+	{
+		const unsigned int rest = CreateNode( m_Nodes[index].Offset + size, m_Nodes[index].Size - size );
+		Node& node = m_Nodes[index];
+		node.Size = size;
+		m_Nodes[rest].PrevPhysical = index;
+		m_Nodes[rest].NextPhysical = node.NextPhysical;
+		if ( node.NextPhysical != INVALID )
+			m_Nodes[node.NextPhysical].PrevPhysical = rest;
+		else
+			m_LastNode = rest;
+		node.NextPhysical = rest;
+		InsertFree( rest );
+	}
+
+	return { m_Nodes[index].Offset, size, index };
+}
+
+void OffsetAllocator::Free( const Allocation& allocation )
+{
+	if ( allocation.Node == INVALID )
+		return;
+
+	unsigned int index = allocation.Node;
+	m_Nodes[index].Used = false;
+
+	// Merge with the previous block.
+	const unsigned int prev = m_Nodes[index].PrevPhysical;
+	if ( prev != INVALID && !m_Nodes[prev].Used )
+	{
+		RemoveFree( prev );
+		m_Nodes[prev].Size += m_Nodes[index].Size;
+		m_Nodes[prev].NextPhysical = m_Nodes[index].NextPhysical;
+		if ( m_Nodes[index].NextPhysical != INVALID )
+			m_Nodes[m_Nodes[index].NextPhysical].PrevPhysical = prev;
+		else
+			m_LastNode = prev;
+		m_UnusedNodes.push_back( index );
+		index = prev;
+	}
+
+	// Merge with the next block.
+	const unsigned int next = m_Nodes[index].NextPhysical;
+	if ( next != INVALID && !m_Nodes[next].Used )
+	{
+		RemoveFree( next );
+		m_Nodes[index].Size += m_Nodes[next].Size;
+		m_Nodes[index].NextPhysical = m_Nodes[next].NextPhysical;
+		if ( m_Nodes[next].NextPhysical != INVALID )
+			m_Nodes[m_Nodes[next].NextPhysical].PrevPhysical = index;
+		else
+			m_LastNode = index;
+		m_UnusedNodes.push_back( next );
+	}
+
+	InsertFree( index );
+}
+
+void OffsetAllocator::Grow( unsigned int size )
+{
+	if ( size == 0 )
+		return;
+
+	const unsigned int node = CreateNode( m_Size, size );
+	m_Size += size;
+	m_Nodes[node].Used = true;
+	m_Nodes[node].PrevPhysical = m_LastNode;
+	if ( m_LastNode != INVALID )
+		m_Nodes[m_LastNode].NextPhysical = node;
+	m_LastNode = node;
+
+	// Freeing it merges it with a free block at the old end.
+	Free( { m_Nodes[node].Offset, size, node } );
+}
+
+unsigned int OffsetAllocator::GetLargestFreeBlock() const
+{
+	if ( m_FirstLevelMask == 0 )
+		return 0;
+
+	const unsigned int level = HighestBit( m_FirstLevelMask );
+	const unsigned int bin = level * SECOND_LEVEL_COUNT + HighestBit( m_SecondLevelMasks[level] );
+	unsigned int largest = 0;
+	for ( unsigned int index = m_Bins[bin]; index != INVALID; index = m_Nodes[index].NextFree )
+		largest = std::max( largest, m_Nodes[index].Size );
+	return largest;
+}
+
+float OffsetAllocator::GetFragmentation() const
+{
+	if ( m_FreeSize == 0 )
+		return 0.0f;
+	return 1.0f - (float) GetLargestFreeBlock() / m_FreeSize;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+
+// Two level segregated fit (TLSF) allocator over an abstract range of units, it
+// never touches the memory it manages. Free blocks are kept in bins of size
+// classes, 8 per power of two, found through two levels of bitmasks, so
+// Allocate and Free are O(1). Freed blocks merge with free neighbours.
+class OffsetAllocator
+{
+public:
+	static constexpr unsigned int INVALID = ~0u;
+
+	struct Allocation
+	{
+		unsigned int Offset;
+		unsigned int Size;
+		// Identifies the block for Free.
+		unsigned int Node;
+	};
+
+private:
+	static const unsigned int SECOND_LEVEL_BITS = 3;
+	static const unsigned int SECOND_LEVEL_COUNT = 1 << SECOND_LEVEL_BITS;
+	static const unsigned int FIRST_LEVEL_COUNT = 32;
+
+	struct Node
+	{
+		unsigned int Offset;
+		unsigned int Size;
+		// Neighbours in address order.
+		unsigned int PrevPhysical, NextPhysical;
+		// Neighbours in the same bin, only for free nodes.
+		unsigned int PrevFree, NextFree;
+		bool Used;
+	};
+
+	unsigned int m_Size;
+	unsigned int m_FreeSize;
+	unsigned int m_FirstLevelMask;
+	unsigned int m_SecondLevelMasks[FIRST_LEVEL_COUNT];
+	unsigned int m_Bins[FIRST_LEVEL_COUNT * SECOND_LEVEL_COUNT];
+	std::vector< Node > m_Nodes;
+	std::vector< unsigned int > m_UnusedNodes;
+	unsigned int m_LastNode;
+
+public:
+	OffsetAllocator( unsigned int size );
+
+	// Returns an allocation with Offset == INVALID when no free block is large enough.
+	Allocation Allocate( unsigned int size );
+	void Free( const Allocation& allocation );
+	// Adds "size" units at the end of the range.
+	void Grow( unsigned int size );
+	// Forgets every allocation.
+	void Reset();
+
+	inline unsigned int GetSize() const { return m_Size; }
+	inline unsigned int GetFreeSize() const { return m_FreeSize; }
+	unsigned int GetLargestFreeBlock() const;
+	// 0 when all free space is one block, close to 1 when it is scattered in small ones.
+	float GetFragmentation() const;
+
+private:
+	static unsigned int GetBin( unsigned int size, bool roundUp );
+	unsigned int FindBin( unsigned int minimumBin ) const;
+	unsigned int CreateNode( unsigned int offset, unsigned int size );
+	void InsertFree( unsigned int node );
+	void RemoveFree( unsigned int node );
+};
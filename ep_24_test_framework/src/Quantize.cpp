@@ -0,0 +1,214 @@
+#include "Quantize.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined( _M_X64 ) || defined( _M_IX86 ) || defined( __SSE2__ )
+#define QUANTIZE_SSE2
+#include <emmintrin.h>
+#endif
+
+// F16C intrinsics can only be used without compiler flags with MSVC.
+#if defined( QUANTIZE_SSE2 ) && defined( _MSC_VER )
+#define QUANTIZE_F16C
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace quantize
+{
+	static uint32_t FloatBits( float value )
+	{
+		uint32_t bits;
+		std::memcpy( &bits, &value, sizeof( bits ) );
+		return bits;
+	}
+
+	uint16_t FloatToHalf( float value )
+	{
+		const uint32_t bits = FloatBits( value );
+		const uint16_t sign = (uint16_t) ( ( bits >> 16 ) & 0x8000 );
+		const uint32_t magnitude = bits & 0x7FFFFFFF;
+
+		// NaN stays NaN, infinity and overflow become infinity.
+		if ( magnitude > 0x7F800000 )
+			return sign | 0x7E00;
+		if ( magnitude >= 0x477FF000 )
+			return sign | 0x7C00;
+
+		// Too small even for a denormal half.
+		if ( magnitude < 0x33000001 )
+			return sign;
+
+		const int exponent = (int) ( magnitude >> 23 ) - 127;
+		uint32_t mantissa = ( magnitude & 0x007FFFFF ) | 0x00800000;
+		int shift;
+		uint32_t half;
+		if ( exponent < -14 )
+		{
+			// Denormal half.
+			shift = -1 - exponent;
+			half = 0;
+		}
+		else
+		{
+			shift = 13;
+			half = (uint32_t) ( exponent + 15 ) << 10;
+			mantissa &= 0x007FFFFF;
+		}
+
+		// Round to nearest even, a carry into the exponent is still correct.
+		const uint32_t rest = mantissa & ( ( 1u << shift ) - 1 );
+		const uint32_t halfway = 1u << ( shift - 1 );
+		mantissa >>= shift;
+		if ( rest > halfway || ( rest == halfway && ( mantissa & 1 ) ) )
+			mantissa++;
+		return sign | (uint16_t) ( half + mantissa );
+	}
+
+	float HalfToFloat( uint16_t half )
+	{
+		const uint32_t sign = (uint32_t) ( half & 0x8000 ) << 16;
+		const uint32_t exponent = ( half >> 10 ) & 0x1F;
+		const uint32_t mantissa = half & 0x3FF;
+
+		float value;
+		if ( exponent == 0 )
+			value = std::ldexp( (float) mantissa, -24 );
+		else if ( exponent == 31 )
+			value = mantissa ? NAN : INFINITY;
+		else
+			value = std::ldexp( (float) ( mantissa | 0x400 ), (int) exponent - 25 );
+
+		uint32_t bits = FloatBits( value ) | sign;
+		std::memcpy( &value, &bits, sizeof( value ) );
+		return value;
+	}
+
+	// Rounds half to even like the SSE2 conversion in the default rounding mode.
+	static int32_t QuantizeSigned( float value, float scale )
+	{
+		return (int32_t) std::nearbyint( std::min( std::max( value, -1.0f ), 1.0f ) * scale );
+	}
+
+	static uint32_t QuantizeUnsigned( float value, float scale )
+	{
+		return (uint32_t) std::nearbyint( std::min( std::max( value, 0.0f ), 1.0f ) * scale );
+	}
+
+	PackedNormal PackNormal( float x, float y, float z, float w )
+	{
+		const uint32_t bits =
+			( (uint32_t) QuantizeSigned( x, 511.0f ) & 0x3FF ) |
+			( ( (uint32_t) QuantizeSigned( y, 511.0f ) & 0x3FF ) << 10 ) |
+			( ( (uint32_t) QuantizeSigned( z, 511.0f ) & 0x3FF ) << 20 ) |
+			( ( (uint32_t) QuantizeSigned( w, 1.0f ) & 0x3 ) << 30 );
+		return { bits };
+	}
+
+#ifdef QUANTIZE_F16C
+	static bool HasF16C()
+	{
+		static const bool supported = []
+		{
+			int info[4];
+			__cpuid( info, 1 );
+			return ( info[2] & ( 1 << 29 ) ) != 0;
+		}( );
+		return supported;
+	}
+#endif
+
+	void FloatToHalf( const float* in, Half* out, size_t count )
+	{
+		size_t i = 0;
+#ifdef QUANTIZE_F16C
+		if ( HasF16C() )
+		{
+			for ( ; i + 4 <= count; i += 4 )
+				_mm_storel_epi64( (__m128i*) ( out + i ), _mm_cvtps_ph( _mm_loadu_ps( in + i ), _MM_FROUND_TO_NEAREST_INT ) );
+		}
+#endif
+		for ( ; i < count; i++ )
+			out[i].Bits = FloatToHalf( in[i] );
+	}
+
+#ifdef QUANTIZE_SSE2
+	// Clamps 4 floats to [low, 1], scales them and rounds to the nearest integer.
+	static __m128i QuantizeSSE2( const float* in, float low, float scale )
+	{
+		const __m128 value = _mm_min_ps( _mm_max_ps( _mm_loadu_ps( in ), _mm_set1_ps( low ) ), _mm_set1_ps( 1.0f ) );
+		return _mm_cvtps_epi32( _mm_mul_ps( value, _mm_set1_ps( scale ) ) );
+	}
+#endif
+
+	void FloatToUnorm16( const float* in, uint16_t* out, size_t count )
+	{
+		size_t i = 0;
+#ifdef QUANTIZE_SSE2
+		// SSE2 only packs to signed 16 bits, so pack around 32768 and flip the top bit back.
+		const __m128i bias = _mm_set1_epi32( 32768 );
+		const __m128i flip = _mm_set1_epi16( (short) 0x8000 );
+		for ( ; i + 4 <= count; i += 4 )
+		{
+			const __m128i value = _mm_sub_epi32( QuantizeSSE2( in + i, 0.0f, 65535.0f ), bias );
+			_mm_storel_epi64( (__m128i*) ( out + i ), _mm_xor_si128( _mm_packs_epi32( value, value ), flip ) );
+		}
+#endif
+		for ( ; i < count; i++ )
+			out[i] = (uint16_t) QuantizeUnsigned( in[i], 65535.0f );
+	}
+
+	void FloatToSnorm16( const float* in, int16_t* out, size_t count )
+	{
+		size_t i = 0;
+#ifdef QUANTIZE_SSE2
+		for ( ; i + 4 <= count; i += 4 )
+		{
+			const __m128i value = QuantizeSSE2( in + i, -1.0f, 32767.0f );
+			_mm_storel_epi64( (__m128i*) ( out + i ), _mm_packs_epi32( value, value ) );
+		}
+#endif
+		for ( ; i < count; i++ )
+			out[i] = (int16_t) QuantizeSigned( in[i], 32767.0f );
+	}
+
+	void FloatToUnorm8( const float* in, uint8_t* out, size_t count )
+	{
+		size_t i = 0;
+#ifdef QUANTIZE_SSE2
+		for ( ; i + 4 <= count; i += 4 )
+		{
+			const __m128i value = QuantizeSSE2( in + i, 0.0f, 255.0f );
+			const __m128i packed = _mm_packs_epi32( value, value );
+			const int bytes = _mm_cvtsi128_si32( _mm_packus_epi16( packed, packed ) );
+			std::memcpy( out + i, &bytes, 4 );
+		}
+#endif
+		for ( ; i < count; i++ )
+			out[i] = (uint8_t) QuantizeUnsigned( in[i], 255.0f );
+	}
+
+	void FloatToSnorm8( const float* in, int8_t* out, size_t count )
+	{
+		size_t i = 0;
+#ifdef QUANTIZE_SSE2
+		for ( ; i + 4 <= count; i += 4 )
+		{
+			const __m128i value = QuantizeSSE2( in + i, -1.0f, 127.0f );
+			const __m128i packed = _mm_packs_epi32( value, value );
+			const int bytes = _mm_cvtsi128_si32( _mm_packs_epi16( packed, packed ) );
+			std::memcpy( out + i, &bytes, 4 );
+		}
+#endif
+		for ( ; i < count; i++ )
+			out[i] = (int8_t) QuantizeSigned( in[i], 127.0f );
+	}
+
+	void PackNormals( const float* in, PackedNormal* out, size_t count )
+	{
+		for ( size_t i = 0; i < count; i++ )
+			out[i] = PackNormal( in[i * 3 + 0], in[i * 3 + 1], in[i * 3 + 2] );
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Compact vertex component types, see VertexBufferLayout::Push.
+// IEEE 754 half precision float (GL_HALF_FLOAT).
+struct Half
+{
+	uint16_t Bits;
+};
+
+// Four signed components of 10, 10, 10 and 2 bits, x in the lowest bits (GL_INT_2_10_10_10_REV).
+struct PackedNormal
+{
+	uint32_t Bits;
+};
+
+// Conversion of float vertex data into the compact types above. The array versions
+// use SSE2, and F16C for half floats when the CPU has it; the results are the same
+// as the scalar versions.
+namespace quantize
+{
+	uint16_t FloatToHalf( float value );
+	float HalfToFloat( uint16_t half );
+	// Signed normalized values use the GL 4.2 rule, -1 and 1 map to -max and max.
+	PackedNormal PackNormal( float x, float y, float z, float w = 0.0f );
+
+	void FloatToHalf( const float* in, Half* out, size_t count );
+	void FloatToUnorm16( const float* in, uint16_t* out, size_t count );
+	void FloatToSnorm16( const float* in, int16_t* out, size_t count );
+	void FloatToUnorm8( const float* in, uint8_t* out, size_t count );
+	void FloatToSnorm8( const float* in, int8_t* out, size_t count );
+	// "in" holds "count" xyz triples.
+	void PackNormals( const float* in, PackedNormal* out, size_t count );
+}
@@ -2,9 +2,11 @@
 
 #include <GL/glew.h>
 
+#include "Buffer.h"
 #include "VertexArray.h"
 #include "IndexBuffer.h"
 #include "Shader.h"
+#include "Resources.h"
 #include "Debug.h"
 
 void Renderer::Clear() const
@@ -17,5 +19,65 @@ void Renderer::Draw( const VertexArray& va, const IndexBuffer& ib, const Shader&
 	shader.Bind();
 	va.Bind(); // Instead of binding vertex buffer, attrib pointer, just bind Vertex Array Object.
 	ib.Bind(); // Bind index buffer.
-	GLCall( glDrawElements( GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr ) );
-}
\ No newline at end of file
+	GLCall( glDrawElements( GL_TRIANGLES, ib.GetCount(), ib.GetType(), nullptr ) );
+}
+
+void Renderer::Draw( const VertexArray& va, const IndexBuffer& ib, const Shader& shader, unsigned int count, unsigned int firstIndex, int baseVertex ) const
+{
+	shader.Bind();
+	va.Bind();
+	ib.Bind();
+	GLCall( glDrawElementsBaseVertex( GL_TRIANGLES, count, ib.GetType(), (void*) ( (size_t) firstIndex * ib.GetIndexSize() ), baseVertex ) );
+}
+
+void Renderer::DrawArrays( const VertexArray& va, const Shader& shader, unsigned int count, unsigned int first ) const
+{
+	shader.Bind();
+	va.Bind();
+	GLCall( glDrawArrays( GL_TRIANGLES, first, count ) );
+}
+
+void Renderer::Draw( Handle< VertexArray > va, Handle< IndexBuffer > ib, Handle< Shader > shader ) const
+{
+	Resources& resources = Resources::Get();
+	Draw( resources.Get( va ), resources.Get( ib ), resources.Get( shader ) );
+}
+
+void Renderer::DrawIndirect( const VertexArray& va, const IndexBuffer& ib, const Shader& shader, const Buffer& commands, unsigned int offset ) const
+{
+	shader.Bind();
+	va.Bind();
+	ib.Bind();
+	GLCall( glBindBuffer( GL_DRAW_INDIRECT_BUFFER, commands.GetRendererID() ) );
+	GLCall( glDrawElementsIndirect( GL_TRIANGLES, ib.GetType(), (void*) (size_t) offset ) );
+}
+
+void Renderer::MultiDrawIndirect( const VertexArray& va, const IndexBuffer& ib, const Shader& shader, const Buffer& commands, unsigned int drawCount, unsigned int offset ) const
+{
+	shader.Bind();
+	va.Bind();
+	ib.Bind();
+	GLCall( glBindBuffer( GL_DRAW_INDIRECT_BUFFER, commands.GetRendererID() ) );
+	GLCall( glMultiDrawElementsIndirect( GL_TRIANGLES, ib.GetType(), (void*) (size_t) offset, drawCount, 0 ) );
+}
+
+void Renderer::Dispatch( const Shader& shader, unsigned int groupsX, unsigned int groupsY, unsigned int groupsZ ) const
+{
+	shader.Bind();
+	GLCall( glDispatchCompute( groupsX, groupsY, groupsZ ) );
+}
+
+bool Renderer::IsDirectStateAccessSupported()
+{
+	return GLEW_VERSION_4_5 || GLEW_ARB_direct_state_access;
+}
+
+bool Renderer::IsComputeSupported()
+{
+	return GLEW_VERSION_4_3;
+}
+
+bool Renderer::IsDrawParametersSupported()
+{
+	return GLEW_ARB_shader_draw_parameters;
+}
@@ -1,12 +1,56 @@
 #pragma once
 
+#include <cstdint>
+
+class Buffer;
 class VertexArray;
 class IndexBuffer;
 class Shader;
+template< typename T > struct Handle;
+
+// Record read by the indirect draw calls from the GL_DRAW_INDIRECT_BUFFER.
+struct DrawElementsIndirectCommand
+{
+	uint32_t Count;
+	uint32_t InstanceCount;
+	uint32_t FirstIndex;
+	int32_t BaseVertex;
+	uint32_t BaseInstance;
+};
 
 class Renderer
 {
 public:
 	void Clear() const;
 	void Draw( const VertexArray& va, const IndexBuffer& ib, const Shader& shader ) const;
+	// Draws "count" indices starting at "firstIndex", every index offset by "baseVertex".
+	void Draw( const VertexArray& va, const IndexBuffer& ib, const Shader& shader, unsigned int count, unsigned int firstIndex, int baseVertex ) const;
+	// Same with objects owned by Resources.
+	void Draw( Handle< VertexArray > va, Handle< IndexBuffer > ib, Handle< Shader > shader ) const;
+	// Draws "count" vertices from "first" as triangles without indices. With an empty
+	// vertex array this is vertex pulling: the shader builds vertices from gl_VertexID.
+	void DrawArrays( const VertexArray& va, const Shader& shader, unsigned int count, unsigned int first = 0 ) const;
+	// Draws with the DrawElementsIndirectCommand "offset" bytes into "commands", usually
+	// written by a compute shader, so the CPU never learns the count (GL 4.0).
+	void DrawIndirect( const VertexArray& va, const IndexBuffer& ib, const Shader& shader, const Buffer& commands, unsigned int offset = 0 ) const;
+	// Draws "drawCount" tightly packed commands from "offset" bytes into "commands" with one
+	// glMultiDrawElementsIndirect (GL 4.3). Shaders index per-draw data with DRAW_ID, which is
+	// gl_DrawIDARB when IsDrawParametersSupported() and the shader was built with the
+	// DRAW_PARAMETERS define. Otherwise it is an instanced uint attribute holding 0..N-1
+	// (divisor 1), and every command's BaseInstance is its index, so the attribute reads it
+	// back. See res/shaders/MultiDraw.shader and GpuHeap::GetDrawCommand.
+	void MultiDrawIndirect( const VertexArray& va, const IndexBuffer& ib, const Shader& shader, const Buffer& commands, unsigned int drawCount, unsigned int offset = 0 ) const;
+
+	// Runs a compute shader. Its writes are only visible to later commands after a
+	// glMemoryBarrier for the way they are read.
+	void Dispatch( const Shader& shader, unsigned int groupsX, unsigned int groupsY = 1, unsigned int groupsZ = 1 ) const;
+
+	// GL 4.5 direct state access. Buffers, vertex arrays and textures are then created
+	// and edited through their names, without touching the bindings used for drawing.
+	static bool IsDirectStateAccessSupported();
+	// GL 4.3 compute shaders with shader storage buffers and image load/store.
+	static bool IsComputeSupported();
+	// ARB_shader_draw_parameters, which gives shaders gl_DrawIDARB. GL 4.6 drivers without
+	// the extension only offer gl_DrawID to #version 460 shaders, which these are not.
+	static bool IsDrawParametersSupported();
 };
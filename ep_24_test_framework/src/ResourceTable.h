@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "Debug.h"
+
+// 32 bit reference to an object in a ResourceTable< T >: a slot index in the low
+// bits and the slot's generation in the high bits. Destroying the object bumps the
+// generation, so handles still pointing at the slot are detected as stale instead
+// of silently reaching whatever reuses it. 0 is never a valid handle.
+template< typename T >
+struct Handle
+{
+	static constexpr uint32_t INDEX_BITS = 20;
+	static constexpr uint32_t INDEX_MASK = ( 1u << INDEX_BITS ) - 1;
+	static constexpr uint32_t GENERATION_MASK = ( 1u << ( 32 - INDEX_BITS ) ) - 1;
+
+	uint32_t Value;
+
+	Handle() : Value( 0 ) {}
+	Handle( uint32_t index, uint32_t generation ) : Value( ( generation << INDEX_BITS ) | index ) {}
+
+	inline uint32_t GetIndex() const { return Value & INDEX_MASK; }
+	inline uint32_t GetGeneration() const { return Value >> INDEX_BITS; }
+	inline bool IsNull() const { return Value == 0; }
+
+	inline bool operator==( const Handle& other ) const { return Value == other.Value; }
+	inline bool operator!=( const Handle& other ) const { return Value != other.Value; }
+	inline bool operator<( const Handle& other ) const { return Value < other.Value; }
+};
+
+// Owns objects of a move-only type in one contiguous array, referred to by Handle.
+// Slots (indirection and generations) and objects are kept in separate arrays, so
+// validating a handle only touches two small integers and iterating all objects
+// walks memory linearly. Destroy moves the last object into the hole, so pointers
+// and references returned by Get stay valid only until the next Create/Destroy.
+template< typename T >
+class ResourceTable
+{
+private:
+	static constexpr uint32_t NO_OBJECT = ~0u;
+
+	// Dense, one per live object.
+	std::vector< T > m_Objects;
+	std::vector< uint32_t > m_ObjectSlots;
+
+	// Sparse, one per slot ever used.
+	std::vector< uint32_t > m_SlotObjects;
+	std::vector< uint32_t > m_SlotGenerations;
+	std::vector< uint32_t > m_FreeSlots;
+
+public:
+	template< typename... Args >
+	Handle< T > Create( Args&&... args )
+	{
+		uint32_t slot;
+		if ( !m_FreeSlots.empty() )
+		{
+			slot = m_FreeSlots.back();
+			m_FreeSlots.pop_back();
+		}
+		else
+		{
+			ASSERT( m_SlotObjects.size() <= Handle< T >::INDEX_MASK );
+			slot = (uint32_t) m_SlotObjects.size();
+			m_SlotObjects.push_back( NO_OBJECT );
+			m_SlotGenerations.push_back( 1 );
+		}
+
+		m_SlotObjects[slot] = (uint32_t) m_Objects.size();
+		m_Objects.emplace_back( std::forward< Args >( args )... );
+		m_ObjectSlots.push_back( slot );
+		return Handle< T >( slot, m_SlotGenerations[slot] );
+	}
+
+	// Destroys the object, stale handles are ignored.
+	void Destroy( Handle< T > handle )
+	{
+		if ( !IsValid( handle ) )
+			return;
+
+		const uint32_t slot = handle.GetIndex();
+		const uint32_t object = m_SlotObjects[slot];
+		const uint32_t last = (uint32_t) m_Objects.size() - 1;
+		if ( object != last )
+		{
+			m_Objects[object] = std::move( m_Objects[last] );
+			m_ObjectSlots[object] = m_ObjectSlots[last];
+			m_SlotObjects[m_ObjectSlots[object]] = object;
+		}
+		m_Objects.pop_back();
+		m_ObjectSlots.pop_back();
+
+		ReleaseSlot( slot );
+	}
+
+	inline bool IsValid( Handle< T > handle ) const
+	{
+		const uint32_t slot = handle.GetIndex();
+		return slot < m_SlotGenerations.size() && m_SlotGenerations[slot] == handle.GetGeneration() && m_SlotObjects[slot] != NO_OBJECT;
+	}
+
+	// Returns nullptr for a stale or null handle.
+	inline T* TryGet( Handle< T > handle )
+	{
+		return IsValid( handle ) ? &m_Objects[m_SlotObjects[handle.GetIndex()]] : nullptr;
+	}
+
+	inline const T* TryGet( Handle< T > handle ) const
+	{
+		return IsValid( handle ) ? &m_Objects[m_SlotObjects[handle.GetIndex()]] : nullptr;
+	}
+
+	// The handle must be valid, which is only checked in debug builds.
+	inline T& Get( Handle< T > handle )
+	{
+#ifdef DEBUG
+		ASSERT( IsValid( handle ) );
+#endif
+		return m_Objects[m_SlotObjects[handle.GetIndex()]];
+	}
+
+	inline const T& Get( Handle< T > handle ) const
+	{
+#ifdef DEBUG
+		ASSERT( IsValid( handle ) );
+#endif
+		return m_Objects[m_SlotObjects[handle.GetIndex()]];
+	}
+
+	void Clear()
+	{
+		for ( uint32_t slot : m_ObjectSlots )
+			ReleaseSlot( slot );
+		m_Objects.clear();
+		m_ObjectSlots.clear();
+	}
+
+	inline size_t GetCount() const { return m_Objects.size(); }
+
+	// All live objects, in no particular order.
+	inline typename std::vector< T >::iterator begin() { return m_Objects.begin(); }
+	inline typename std::vector< T >::iterator end() { return m_Objects.end(); }
+	inline typename std::vector< T >::const_iterator begin() const { return m_Objects.begin(); }
+	inline typename std::vector< T >::const_iterator end() const { return m_Objects.end(); }
+
+private:
+	void ReleaseSlot( uint32_t slot )
+	{
+		// Generation 0 is skipped so no handle ever has the value 0.
+		m_SlotObjects[slot] = NO_OBJECT;
+		m_SlotGenerations[slot] = ( m_SlotGenerations[slot] + 1 ) & Handle< T >::GENERATION_MASK;
+		if ( m_SlotGenerations[slot] == 0 )
+			m_SlotGenerations[slot] = 1;
+		m_FreeSlots.push_back( slot );
+	}
+};
@@ -0,0 +1,17 @@
+#include "Resources.h"
+
+Resources& Resources::Get()
+{
+	static Resources resources;
+	return resources;
+}
+
+void Resources::Clear()
+{
+	// Vertex arrays reference buffers, release them first.
+	m_VertexArrays.Clear();
+	m_VertexBuffers.Clear();
+	m_IndexBuffers.Clear();
+	m_Shaders.Clear();
+	m_Textures.Clear();
+}
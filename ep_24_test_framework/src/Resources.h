@@ -0,0 +1,65 @@
+#pragma once
+
+#include "ResourceTable.h"
+#include "VertexBuffer.h"
+#include "IndexBuffer.h"
+#include "VertexArray.h"
+#include "Shader.h"
+#include "Texture.h"
+
+using VertexBufferHandle = Handle< VertexBuffer >;
+using IndexBufferHandle = Handle< IndexBuffer >;
+using VertexArrayHandle = Handle< VertexArray >;
+using ShaderHandle = Handle< Shader >;
+using TextureHandle = Handle< Texture >;
+
+// Owner of GL resources referred to by handle, e.g. from sort keys and draw
+// packets that must stay small and copyable (see Renderer::Draw with handles).
+// Everything still alive must be destroyed with Clear() before the context goes.
+class Resources
+{
+private:
+	ResourceTable< VertexBuffer > m_VertexBuffers;
+	ResourceTable< IndexBuffer > m_IndexBuffers;
+	ResourceTable< VertexArray > m_VertexArrays;
+	ResourceTable< Shader > m_Shaders;
+	ResourceTable< Texture > m_Textures;
+
+	Resources() {}
+
+public:
+	static Resources& Get();
+
+	// Creates a T from the arguments of one of its constructors.
+	template< typename T, typename... Args >
+	Handle< T > Create( Args&&... args )
+	{
+		return GetTable< T >().Create( std::forward< Args >( args )... );
+	}
+
+	template< typename T >
+	void Destroy( Handle< T > handle ) { GetTable< T >().Destroy( handle ); }
+
+	template< typename T >
+	bool IsValid( Handle< T > handle ) const { return GetTable< T >().IsValid( handle ); }
+
+	// The handle must be valid, see ResourceTable::Get.
+	template< typename T >
+	T& Get( Handle< T > handle ) { return GetTable< T >().Get( handle ); }
+
+	template< typename T >
+	T* TryGet( Handle< T > handle ) { return GetTable< T >().TryGet( handle ); }
+
+	template< typename T >
+	ResourceTable< T >& GetTable();
+	template< typename T >
+	const ResourceTable< T >& GetTable() const { return const_cast< Resources* >( this )->GetTable< T >(); }
+
+	void Clear();
+};
+
+template<> inline ResourceTable< VertexBuffer >& Resources::GetTable< VertexBuffer >() { return m_VertexBuffers; }
+template<> inline ResourceTable< IndexBuffer >& Resources::GetTable< IndexBuffer >() { return m_IndexBuffers; }
+template<> inline ResourceTable< VertexArray >& Resources::GetTable< VertexArray >() { return m_VertexArrays; }
+template<> inline ResourceTable< Shader >& Resources::GetTable< Shader >() { return m_Shaders; }
+template<> inline ResourceTable< Texture >& Resources::GetTable< Texture >() { return m_Textures; }
@@ -1,21 +1,30 @@
 #include "Renderer.h"
 #include "Shader.h"
+#include "ShaderStorageBuffer.h"
 
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <sstream>
+#include <utility>
 #include "Debug.h"
 
-Shader::Shader( const std::string& filepath )
-	: m_FilePath( filepath ), m_RendererID( 0 )
+Shader::Shader( const std::string& filepath, const std::vector<std::string>& defines )
+	: m_FilePath( filepath ), m_RendererID( 0 ), m_Defines( defines )
 {
 	ShaderProgramSource source = ParseShader( filepath );
 
-	std::cout << "VERTEX" << std::endl << source.VertexSource << std::endl;
-	std::cout << "FRAGMENT" << std::endl << source.FragmentSource << std::endl;
-
-	m_RendererID = CreateShader( source.VertexSource, source.FragmentSource );
+	if ( !source.ComputeSource.empty() )
+	{
+		std::cout << "COMPUTE" << std::endl << source.ComputeSource << std::endl;
+		m_RendererID = CreateComputeShader( source.ComputeSource );
+	}
+	else
+	{
+		std::cout << "VERTEX" << std::endl << source.VertexSource << std::endl;
+		std::cout << "FRAGMENT" << std::endl << source.FragmentSource << std::endl;
+		m_RendererID = CreateShader( source.VertexSource, source.FragmentSource );
+	}
 
 	GLCall( glUseProgram( m_RendererID ) );
 }
@@ -25,6 +34,32 @@ Shader::~Shader()
 	GLCall( glDeleteProgram( m_RendererID ) );
 }
 
+Shader::Shader( Shader&& other ) noexcept
+	: m_RendererID( std::exchange( other.m_RendererID, 0 ) ), m_FilePath( std::move( other.m_FilePath ) ),
+	m_Defines( std::move( other.m_Defines ) ), m_UniformLocationCache( std::move( other.m_UniformLocationCache ) ),
+	m_StorageBlockBindingCache( std::move( other.m_StorageBlockBindingCache ) )
+{
+	other.m_UniformLocationCache.clear();
+	other.m_StorageBlockBindingCache.clear();
+}
+
+Shader& Shader::operator=( Shader&& other ) noexcept
+{
+	if ( this != &other )
+	{
+		GLCall( glDeleteProgram( m_RendererID ) );
+		m_RendererID = std::exchange( other.m_RendererID, 0 );
+		m_FilePath = std::move( other.m_FilePath );
+		m_Defines = std::move( other.m_Defines );
+		// Locations belong to the program, the moved-from shader must not keep them.
+		m_UniformLocationCache = std::move( other.m_UniformLocationCache );
+		other.m_UniformLocationCache.clear();
+		m_StorageBlockBindingCache = std::move( other.m_StorageBlockBindingCache );
+		other.m_StorageBlockBindingCache.clear();
+	}
+	return *this;
+}
+
 void Shader::Bind() const
 {
 	GLCall( glUseProgram( m_RendererID ) );
@@ -59,6 +94,26 @@ void Shader::SetUniform1i( const std::string& name, int value )
 	GLCall( glUniform1i( GetUniformLocation( name ), value ) );
 }
 
+void Shader::SetUniform1iv( const std::string& name, int count, const int* values )
+{
+	GLCall( glUniform1iv( GetUniformLocation( name ), count, values ) );
+}
+
+void Shader::SetUniform4fv( const std::string& name, int count, const float* values )
+{
+	GLCall( glUniform4fv( GetUniformLocation( name ), count, values ) );
+}
+
+void Shader::SetUniform2f( const std::string& name, float f0, float f1 )
+{
+	GLCall( glUniform2f( GetUniformLocation( name ), f0, f1 ) );
+}
+
+void Shader::SetUniform3f( const std::string& name, float f0, float f1, float f2 )
+{
+	GLCall( glUniform3f( GetUniformLocation( name ), f0, f1, f2 ) );
+}
+
 void Shader::SetUniform4f( const std::string& name, float f0, float f1, float f2, float f3 )
 {
 	GLCall( glUniform4f( GetUniformLocation( name ), f0, f1, f2, f3 ) );
@@ -69,16 +124,66 @@ void Shader::SetUniformMat4f( const std::string& name, const glm::mat4& mat4f )
 	GLCall( glUniformMatrix4fv( GetUniformLocation( name ), 1, GL_FALSE, &mat4f[0][0] ) );
 }
 
+void Shader::SetUniformBlockBinding( const std::string& name, unsigned int binding )
+{
+	GLCall( unsigned int index = glGetUniformBlockIndex( m_RendererID, name.c_str() ) );
+	if ( index == GL_INVALID_INDEX )
+	{
+		std::cout << "No active uniform block with name " << name << " found" << std::endl;
+		return;
+	}
+	GLCall( glUniformBlockBinding( m_RendererID, index, binding ) );
+}
+
+int Shader::GetStorageBlockBinding( const std::string& name )
+{
+	auto it = m_StorageBlockBindingCache.find( name );
+	if ( it != m_StorageBlockBindingCache.end() )
+		return it->second;
+
+	int binding = -1;
+	GLCall( unsigned int index = glGetProgramResourceIndex( m_RendererID, GL_SHADER_STORAGE_BLOCK, name.c_str() ) );
+	if ( index == GL_INVALID_INDEX )
+	{
+		std::cout << "No active storage block with name " << name << " found" << std::endl;
+	}
+	else
+	{
+		const GLenum property = GL_BUFFER_BINDING;
+		GLCall( glGetProgramResourceiv( m_RendererID, GL_SHADER_STORAGE_BLOCK, index, 1, &property, 1, nullptr, &binding ) );
+	}
+
+	m_StorageBlockBindingCache[name] = binding;
+
+	return binding;
+}
+
+void Shader::SetStorageBuffer( const std::string& name, const ShaderStorageBuffer& buffer )
+{
+	const int binding = GetStorageBlockBinding( name );
+	if ( binding == -1 )
+		return;
+	buffer.BindBase( (unsigned int) binding );
+}
+
+void Shader::SetStorageBuffer( const std::string& name, unsigned int buffer )
+{
+	const int binding = GetStorageBlockBinding( name );
+	if ( binding == -1 )
+		return;
+	GLCall( glBindBufferBase( GL_SHADER_STORAGE_BUFFER, (unsigned int) binding, buffer ) );
+}
+
 struct ShaderProgramSource Shader::ParseShader( const std::string& filepath )
 {
 	enum class ShaderType
 	{
-		NONE = -1, VERTEX = 0, FRAGMENT = 1
+		NONE = -1, VERTEX = 0, FRAGMENT = 1, COMPUTE = 2
 	};
 
 	std::ifstream stream( filepath );
 	std::string line;
-	std::stringstream ss[2];
+	std::stringstream ss[3];
 	ShaderType type = ShaderType::NONE;
 
 	while ( getline( stream, line ) )
@@ -89,14 +194,32 @@ struct ShaderProgramSource Shader::ParseShader( const std::string& filepath )
 				type = ShaderType::VERTEX;
 			else if ( line.find( "fragment" ) != std::string::npos )
 				type = ShaderType::FRAGMENT;
+			else if ( line.find( "compute" ) != std::string::npos )
+				type = ShaderType::COMPUTE;
 		}
 		else
 		{
 			ss[(int) type] << line << '\n';
+			if ( line.find( "#version" ) != std::string::npos )
+			{
+				for ( const std::string& define : m_Defines )
+					ss[(int) type] << "#define " << define << '\n';
+			}
 		}
 	}
 
-	return { ss[0].str(), ss[1].str() };
+	return { ss[0].str(), ss[1].str(), ss[2].str() };
+}
+
+static const char* GetStageName( unsigned int type )
+{
+	switch ( type )
+	{
+		case GL_VERTEX_SHADER: return "vertex";
+		case GL_FRAGMENT_SHADER: return "fragment";
+		case GL_COMPUTE_SHADER: return "compute";
+	}
+	return "unknown";
 }
 
 unsigned int Shader::CompileShader( unsigned int type, const std::string& source )
@@ -109,7 +232,7 @@ unsigned int Shader::CompileShader( unsigned int type, const std::string& source
 	// Error handling.
 	int result;
 	GLCall( glGetShaderiv( id, GL_COMPILE_STATUS, &result ) );
-	std::cout << ( type == GL_VERTEX_SHADER ? "vertex" : "fragment" ) << " shader compile status: " << result << std::endl;
+	std::cout << GetStageName( type ) << " shader compile status: " << result << std::endl;
 	if ( result == GL_FALSE )
 	{
 		int length;
@@ -118,8 +241,8 @@ unsigned int Shader::CompileShader( unsigned int type, const std::string& source
 		GLCall( glGetShaderInfoLog( id, length, &length, message ) );
 		std::cout
 			<< "Failed to compile "
-			<< ( type == GL_VERTEX_SHADER ? "vertex" : "fragment" )
-			<< "shader"
+			<< GetStageName( type )
+			<< " shader"
 			<< std::endl;
 		std::cout << message << std::endl;
 		GLCall( glDeleteShader( id ) );
@@ -139,6 +262,30 @@ unsigned int Shader::CreateShader( const std::string& vertexShader, const std::s
 	GLCall( glAttachShader( program, vs ) );
 	GLCall( glAttachShader( program, fs ) );
 
+	LinkProgram( program );
+
+	GLCall( glDeleteShader( vs ) );
+	GLCall( glDeleteShader( fs ) );
+
+	return program;
+}
+
+unsigned int Shader::CreateComputeShader( const std::string& computeShader )
+{
+	GLCall( unsigned int program = glCreateProgram() );
+	GLCall( unsigned int cs = CompileShader( GL_COMPUTE_SHADER, computeShader ) );
+
+	GLCall( glAttachShader( program, cs ) );
+
+	LinkProgram( program );
+
+	GLCall( glDeleteShader( cs ) );
+
+	return program;
+}
+
+void Shader::LinkProgram( unsigned int program )
+{
 	GLCall( glLinkProgram( program ) );
 
 	GLint program_linked;
@@ -155,9 +302,4 @@ unsigned int Shader::CreateShader( const std::string& vertexShader, const std::s
 	}
 
 	GLCall( glValidateProgram( program ) );
-
-	GLCall( glDeleteShader( vs ) );
-	GLCall( glDeleteShader( fs ) );
-
-	return program;
 }
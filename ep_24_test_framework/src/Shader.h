@@ -2,13 +2,17 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "glm/glm.hpp"
 
+class ShaderStorageBuffer;
+
 struct ShaderProgramSource
 {
 	std::string VertexSource;
 	std::string FragmentSource;
+	std::string ComputeSource;
 };
 
 class Shader
@@ -16,24 +20,51 @@ class Shader
 private:
 	unsigned int m_RendererID;
 	std::string m_FilePath;
+	std::vector<std::string> m_Defines;
 	std::unordered_map<std::string, int> m_UniformLocationCache;
+	std::unordered_map<std::string, int> m_StorageBlockBindingCache;
 
 public:
-	Shader( const std::string& filepath );
+	// Every define ("NAME" or "NAME VALUE") is inserted after the #version line of each stage.
+	// A file with a "#shader compute" section makes a compute program (GL 4.3, see
+	// Renderer::IsComputeSupported), run with Renderer::Dispatch.
+	Shader( const std::string& filepath, const std::vector<std::string>& defines = {} );
 	~Shader();
 
+	// Move-only, a moved-from shader owns no program.
+	Shader( const Shader& ) = delete;
+	Shader& operator=( const Shader& ) = delete;
+	Shader( Shader&& other ) noexcept;
+	Shader& operator=( Shader&& other ) noexcept;
+
 	void Bind() const;
 	void Unbind() const;
 
 	// Set uniforms.
 	void SetUniform4f( const std::string& name, float f0, float f1, float f2, float f3 );
+	void SetUniform3f( const std::string& name, float f0, float f1, float f2 );
+	void SetUniform2f( const std::string& name, float f0, float f1 );
 	void SetUniform1f( const std::string& name, float value );
 	void SetUniform1i( const std::string& name, int value );
+	void SetUniform1iv( const std::string& name, int count, const int* values );
+	void SetUniform4fv( const std::string& name, int count, const float* values );
 	void SetUniformMat4f( const std::string& name, const glm::mat4& mat4f );
 
+	// Connects the uniform block "name" to the buffer bound at "binding" with glBindBufferBase.
+	void SetUniformBlockBinding( const std::string& name, unsigned int binding );
+	// Binds "buffer" to the binding of the storage block "name" (GL 4.3), so callers need not
+	// know the binding numbers. The binding is context state, bind before every
+	// draw or dispatch that may follow one using the same binding for another buffer.
+	void SetStorageBuffer( const std::string& name, const ShaderStorageBuffer& buffer );
+	// Same with any GL buffer, e.g. an index or indirect buffer a compute shader writes.
+	void SetStorageBuffer( const std::string& name, unsigned int buffer );
+
 private:
 	int GetUniformLocation( const std::string& name );
+	int GetStorageBlockBinding( const std::string& name );
 	struct ShaderProgramSource ParseShader( const std::string& filepath );
 	unsigned int CompileShader( unsigned int type, const std::string& source );
 	unsigned int CreateShader( const std::string& vertexShader, const std::string& fragmentShader );
+	unsigned int CreateComputeShader( const std::string& computeShader );
+	void LinkProgram( unsigned int program );
 };
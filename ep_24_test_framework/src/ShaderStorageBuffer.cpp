@@ -0,0 +1,238 @@
+#include "ShaderStorageBuffer.h"
+#include "Renderer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+ShaderStorageBuffer::ShaderStorageBuffer( const void* data, unsigned int size, BufferUsage usage, bool persistent )
+	: Buffer( GL_SHADER_STORAGE_BUFFER, persistent ? nullptr : data, persistent ? 0 : size, usage ),
+	m_Persistent( persistent && IsPersistentMappingSupported() ), m_Mapping( nullptr ), m_RegionStride( 0 ), m_Region( 0 ),
+	m_Fences{ nullptr }, m_StaleBegin{ 0 }, m_StaleEnd{ 0 }, m_Stalls( 0 )
+{
+	if ( !persistent )
+		return;
+
+	if ( m_Persistent )
+		SpecifyPersistent( size );
+	SetData( data, size );
+}
+
+ShaderStorageBuffer::~ShaderStorageBuffer()
+{
+	DeleteFences();
+}
+
+ShaderStorageBuffer::ShaderStorageBuffer( ShaderStorageBuffer&& other ) noexcept
+	: Buffer( std::move( other ) ), m_Persistent( other.m_Persistent ), m_Mapping( std::exchange( other.m_Mapping, nullptr ) ),
+	m_Contents( std::move( other.m_Contents ) ), m_RegionStride( other.m_RegionStride ), m_Region( other.m_Region ),
+	m_Stalls( other.m_Stalls )
+{
+	for ( unsigned int i = 0; i < REGION_COUNT; i++ )
+	{
+		m_Fences[i] = std::exchange( other.m_Fences[i], nullptr );
+		m_StaleBegin[i] = other.m_StaleBegin[i];
+		m_StaleEnd[i] = other.m_StaleEnd[i];
+	}
+}
+
+ShaderStorageBuffer& ShaderStorageBuffer::operator=( ShaderStorageBuffer&& other ) noexcept
+{
+	if ( this != &other )
+	{
+		// Deleting the old name also unmaps it.
+		DeleteFences();
+		Buffer::operator=( std::move( other ) );
+		m_Persistent = other.m_Persistent;
+		m_Mapping = std::exchange( other.m_Mapping, nullptr );
+		m_Contents = std::move( other.m_Contents );
+		m_RegionStride = other.m_RegionStride;
+		m_Region = other.m_Region;
+		m_Stalls = other.m_Stalls;
+		for ( unsigned int i = 0; i < REGION_COUNT; i++ )
+		{
+			m_Fences[i] = std::exchange( other.m_Fences[i], nullptr );
+			m_StaleBegin[i] = other.m_StaleBegin[i];
+			m_StaleEnd[i] = other.m_StaleEnd[i];
+		}
+	}
+	return *this;
+}
+
+bool ShaderStorageBuffer::IsPersistentMappingSupported()
+{
+	return GLEW_ARB_buffer_storage;
+}
+
+void ShaderStorageBuffer::SetData( const void* data, unsigned int size )
+{
+	if ( !m_Persistent )
+	{
+		Buffer::SetData( data, size );
+		return;
+	}
+
+	// Immutable storage can not be orphaned, only replaced when it is too small.
+	if ( size > m_Capacity )
+		SpecifyPersistent( std::max( size, m_Capacity + m_Capacity / 2 ) );
+	m_Size = size;
+	if ( data && size > 0 )
+	{
+		std::memcpy( m_Contents.data(), data, size );
+		WriteRegion( 0, size );
+	}
+}
+
+void ShaderStorageBuffer::SetSubData( unsigned int offset, const void* data, unsigned int size )
+{
+	if ( !m_Persistent )
+	{
+		Buffer::SetSubData( offset, data, size );
+		return;
+	}
+
+	ASSERT( offset + size <= m_Size );
+	std::memcpy( m_Contents.data() + offset, data, size );
+	WriteRegion( offset, size );
+}
+
+void ShaderStorageBuffer::GetSubData( unsigned int offset, void* data, unsigned int size ) const
+{
+	if ( !m_Persistent )
+	{
+		Buffer::GetSubData( offset, data, size );
+		return;
+	}
+
+	ASSERT( offset + size <= m_Size );
+	std::memcpy( data, m_Contents.data() + offset, size );
+}
+
+void ShaderStorageBuffer::WriteRegion( unsigned int offset, unsigned int size )
+{
+	std::memcpy( m_Mapping + m_Region * m_RegionStride + offset, m_Contents.data() + offset, size );
+
+	// The other regions still hold older contents, they catch up in BeginFrame.
+	for ( unsigned int i = 0; i < REGION_COUNT; i++ )
+	{
+		if ( i == m_Region )
+			continue;
+		if ( m_StaleBegin[i] == m_StaleEnd[i] )
+		{
+			m_StaleBegin[i] = offset;
+			m_StaleEnd[i] = offset + size;
+		}
+		else
+		{
+			m_StaleBegin[i] = std::min( m_StaleBegin[i], offset );
+			m_StaleEnd[i] = std::max( m_StaleEnd[i], offset + size );
+		}
+	}
+}
+
+void ShaderStorageBuffer::BeginFrame()
+{
+	if ( !m_Persistent )
+		return;
+
+	m_Region = ( m_Region + 1 ) % REGION_COUNT;
+	GLsync& fence = m_Fences[m_Region];
+	if ( fence )
+	{
+		GLCall( GLenum result = glClientWaitSync( fence, 0, 0 ) );
+		if ( result == GL_TIMEOUT_EXPIRED )
+		{
+			m_Stalls++;
+			do
+			{
+				GLCall( result = glClientWaitSync( fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000 ) );
+			} while ( result == GL_TIMEOUT_EXPIRED );
+		}
+		GLCall( glDeleteSync( fence ) );
+		fence = nullptr;
+	}
+
+	const unsigned int begin = m_StaleBegin[m_Region], end = std::min( m_StaleEnd[m_Region], m_Size );
+	if ( begin < end )
+		std::memcpy( m_Mapping + m_Region * m_RegionStride + begin, m_Contents.data() + begin, end - begin );
+	m_StaleBegin[m_Region] = m_StaleEnd[m_Region] = 0;
+}
+
+void ShaderStorageBuffer::EndFrame()
+{
+	if ( !m_Persistent )
+		return;
+
+	if ( m_Fences[m_Region] )
+	{
+		GLCall( glDeleteSync( m_Fences[m_Region] ) );
+	}
+	GLCall( m_Fences[m_Region] = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 ) );
+}
+
+void ShaderStorageBuffer::BindBase( unsigned int binding ) const
+{
+	if ( m_Persistent )
+	{
+		// A range can not be empty, an empty buffer binds its capacity.
+		BindRange( binding, 0, m_Size > 0 ? m_Size : m_Capacity );
+		return;
+	}
+
+	GLCall( glBindBufferBase( GL_SHADER_STORAGE_BUFFER, binding, m_RendererID ) );
+}
+
+void ShaderStorageBuffer::BindRange( unsigned int binding, unsigned int offset, unsigned int size ) const
+{
+	ASSERT( offset + size <= ( m_Persistent ? m_Capacity : m_Size ) );
+
+	const unsigned int regionOffset = m_Persistent ? m_Region * m_RegionStride : 0;
+	GLCall( glBindBufferRange( GL_SHADER_STORAGE_BUFFER, binding, m_RendererID, regionOffset + offset, size ) );
+}
+
+void ShaderStorageBuffer::SpecifyPersistent( unsigned int capacity )
+{
+	// Immutable storage is never re-specified, so a bigger one takes a new name. The
+	// old contents are dropped, every caller replaces them anyway. The GL keeps the old
+	// storage alive for draws in flight, so its fences are no longer needed.
+	DeleteFences();
+	GLCall( glDeleteBuffers( 1, &m_RendererID ) );
+	m_Capacity = std::max( capacity, 4u );
+	m_Size = 0;
+	m_Contents.assign( m_Capacity, 0 );
+	std::fill( std::begin( m_StaleBegin ), std::end( m_StaleBegin ), 0 );
+	std::fill( std::begin( m_StaleEnd ), std::end( m_StaleEnd ), 0 );
+
+	// Every region starts at a valid storage buffer binding offset.
+	int alignment;
+	GLCall( glGetIntegerv( GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment ) );
+	alignment = std::max( alignment, 1 );
+	m_RegionStride = ( m_Capacity + alignment - 1 ) / alignment * alignment;
+	const unsigned int size = m_RegionStride * REGION_COUNT;
+
+	const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	if ( Renderer::IsDirectStateAccessSupported() )
+	{
+		GLCall( glCreateBuffers( 1, &m_RendererID ) );
+		GLCall( glNamedBufferStorage( m_RendererID, size, nullptr, flags ) );
+		GLCall( m_Mapping = (unsigned char*) glMapNamedBufferRange( m_RendererID, 0, size, flags ) );
+		return;
+	}
+
+	GLCall( glGenBuffers( 1, &m_RendererID ) );
+	Bind();
+	GLCall( glBufferStorage( GL_SHADER_STORAGE_BUFFER, size, nullptr, flags ) );
+	GLCall( m_Mapping = (unsigned char*) glMapBufferRange( GL_SHADER_STORAGE_BUFFER, 0, size, flags ) );
+}
+
+void ShaderStorageBuffer::DeleteFences()
+{
+	for ( GLsync& fence : m_Fences )
+	{
+		if ( fence )
+		{
+			GLCall( glDeleteSync( fence ) );
+			fence = nullptr;
+		}
+	}
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <type_traits>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "Buffer.h"
+#include "Debug.h"
+
+// Storage buffer (GL 4.3, see Renderer::IsComputeSupported) for arrays of std430 structs
+// that shaders index freely: transforms, materials or animation state of far more
+// instances than uniforms or vertex attributes can carry. Bind it by block name with
+// Shader::SetStorageBuffer, and access it through StorageArray views.
+//
+// There are two ways to update it:
+// - By default it is a mutable Buffer. SetData replaces the contents, orphaning the old
+//   storage. SetSubData uploads only the changed range with glBufferSubData.
+// - A persistent buffer (ARB_buffer_storage) is mapped once, write-only and coherent,
+//   and holds the contents three times in regions fenced like StreamingRingBuffer.
+//   Updates are plain copies into the region of the current frame, with no GL call at
+//   all, so they never touch what draws in flight still read. A CPU copy of the contents
+//   brings each region up to date when its frame comes round again. Call BeginFrame()
+//   before the frame's updates and EndFrame() after its draws. Growing it creates a new
+//   GL name.
+class ShaderStorageBuffer : private Buffer
+{
+private:
+	static constexpr unsigned int REGION_COUNT = 3;
+
+	bool m_Persistent;
+	unsigned char* m_Mapping;
+	// Persistent only.
+	std::vector< unsigned char > m_Contents;
+	unsigned int m_RegionStride;
+	unsigned int m_Region;
+	GLsync m_Fences[REGION_COUNT];
+	// Bytes [begin, end) of the contents each region has not seen yet.
+	unsigned int m_StaleBegin[REGION_COUNT];
+	unsigned int m_StaleEnd[REGION_COUNT];
+	unsigned int m_Stalls;
+
+public:
+	// "persistent" is ignored without ARB_buffer_storage, check IsPersistent().
+	ShaderStorageBuffer( const void* data, unsigned int size, BufferUsage usage = BufferUsage::Dynamic, bool persistent = false );
+	~ShaderStorageBuffer();
+
+	// Move-only, a moved-from storage buffer is empty and owns no GL name.
+	ShaderStorageBuffer( ShaderStorageBuffer&& other ) noexcept;
+	ShaderStorageBuffer& operator=( ShaderStorageBuffer&& other ) noexcept;
+
+	using Buffer::Bind;
+	using Buffer::Unbind;
+	using Buffer::GetRendererID;
+	using Buffer::GetUsage;
+	using Buffer::GetSize;
+	using Buffer::GetCapacity;
+
+	// Same as Buffer::SetData, SetSubData and GetSubData. Persistent buffers read back
+	// their CPU copy, the mapping is write-only.
+	void SetData( const void* data, unsigned int size );
+	void SetSubData( unsigned int offset, const void* data, unsigned int size );
+	void GetSubData( unsigned int offset, void* data, unsigned int size ) const;
+
+	// Persistent only, nothing happens otherwise. BeginFrame waits until the next region
+	// is free and catches it up, EndFrame fences the current one.
+	void BeginFrame();
+	void EndFrame();
+
+	// Binds the contents, or "size" bytes from "offset", to the indexed storage buffer
+	// binding "binding". Persistent buffers bind the region of the current frame.
+	// "offset" must be a multiple of GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT.
+	void BindBase( unsigned int binding ) const;
+	void BindRange( unsigned int binding, unsigned int offset, unsigned int size ) const;
+
+	inline bool IsPersistent() const { return m_Persistent; }
+	// Frames that had to wait for the GPU to release a region.
+	inline unsigned int GetStallCount() const { return m_Stalls; }
+
+	static bool IsPersistentMappingSupported();
+
+private:
+	// Creates immutable, mapped storage for "capacity" bytes per region under a new GL name.
+	void SpecifyPersistent( unsigned int capacity );
+	// Copies "size" bytes of the contents from "offset" into the current region.
+	void WriteRegion( unsigned int offset, unsigned int size );
+	void DeleteFences();
+};
+
+// Array of "T" starting "offset" bytes into a storage buffer, for the shader side
+// "layout( std430 ) buffer Block { T items[]; };". The C++ struct must match the std430
+// layout: vec3 members are 16 byte aligned, and an array stride is rounded up to the
+// largest alignment in the struct. Plain floats, vec4 and mat4 are safe.
+template< typename T >
+class StorageArray
+{
+	static_assert( std::is_trivially_copyable< T >::value, "storage buffer elements are copied as bytes" );
+	static_assert( sizeof( T ) % 4 == 0, "std430 elements are made of 4 byte components" );
+
+private:
+	ShaderStorageBuffer* m_Buffer;
+	unsigned int m_Offset;
+
+public:
+	StorageArray( ShaderStorageBuffer& buffer, unsigned int offset = 0 )
+		: m_Buffer( &buffer ), m_Offset( offset )
+	{
+	}
+
+	// Elements that fit in the current size of the buffer.
+	inline unsigned int GetCount() const { return ( m_Buffer->GetSize() - m_Offset ) / (unsigned int) sizeof( T ); }
+
+	// Overwrites "count" elements from "first", the other elements are left alone.
+	void Set( unsigned int first, const T* values, unsigned int count )
+	{
+		ASSERT( first + count <= GetCount() );
+		m_Buffer->SetSubData( m_Offset + first * (unsigned int) sizeof( T ), values, count * (unsigned int) sizeof( T ) );
+	}
+	inline void Set( unsigned int index, const T& value ) { Set( index, &value, 1 ); }
+
+	void Get( unsigned int first, T* values, unsigned int count ) const
+	{
+		ASSERT( first + count <= GetCount() );
+		m_Buffer->GetSubData( m_Offset + first * (unsigned int) sizeof( T ), values, count * (unsigned int) sizeof( T ) );
+	}
+};
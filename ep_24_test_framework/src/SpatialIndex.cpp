@@ -0,0 +1,28 @@
+#include "SpatialIndex.h"
+#include "LooseQuadtree.h"
+#include "HashedGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+void SpatialIndex::QueryBatch( const Bounds2D* areas, size_t count, std::vector< uint32_t >& results, std::vector< uint32_t >& offsets ) const
+{
+	results.clear();
+	offsets.resize( count + 1 );
+	for ( size_t i = 0; i < count; i++ )
+	{
+		offsets[i] = (uint32_t) results.size();
+		Query( areas[i], results );
+	}
+	offsets[count] = (uint32_t) results.size();
+}
+
+std::unique_ptr< SpatialIndex > SpatialIndex::Create( SpatialIndexType type, const Bounds2D& world, float cellSize )
+{
+	if ( type == SpatialIndexType::HashedGrid )
+		return std::make_unique< HashedGrid >( cellSize );
+
+	const glm::vec2 size = world.Max - world.Min;
+	const float depth = std::ceil( std::log2( std::max( size.x, size.y ) / std::max( cellSize, 1e-6f ) ) );
+	return std::make_unique< LooseQuadtree >( world, (unsigned int) std::min( std::max( depth, 0.0f ), (float) LooseQuadtree::MAX_DEPTH ) );
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+// Axis aligned rectangle in 2D world units.
+struct Bounds2D
+{
+	glm::vec2 Min;
+	glm::vec2 Max;
+
+	inline bool Overlaps( const Bounds2D& other ) const
+	{
+		return Min.x <= other.Max.x && other.Min.x <= Max.x && Min.y <= other.Max.y && other.Min.y <= Max.y;
+	}
+};
+
+enum class SpatialIndexType
+{
+	LooseQuadtree, HashedGrid
+};
+
+// Index of 2D objects by their bounds, so culling, picking and neighbor queries only
+// look at objects near the area of interest instead of every object. Objects are
+// identified by the caller's ids, which should be dense: both implementations keep
+// per-id data in vectors indexed by id. Moving an object is an Update, which is cheap
+// when it stays in the same node or cells.
+class SpatialIndex
+{
+public:
+	virtual ~SpatialIndex() {}
+
+	virtual void Insert( uint32_t id, const Bounds2D& bounds ) = 0;
+	virtual void Update( uint32_t id, const Bounds2D& bounds ) = 0;
+	virtual void Remove( uint32_t id ) = 0;
+	virtual void Clear() = 0;
+
+	// Appends the id of every object whose bounds overlap "area" to "results", once each.
+	virtual void Query( const Bounds2D& area, std::vector< uint32_t >& results ) const = 0;
+	// Runs "count" queries into one flat array: the results of query i are
+	// results[offsets[i]] up to results[offsets[i + 1]]. Both vectors are replaced.
+	void QueryBatch( const Bounds2D* areas, size_t count, std::vector< uint32_t >& results, std::vector< uint32_t >& offsets ) const;
+
+	virtual size_t GetCount() const = 0;
+
+	// "world" is where most objects are, objects outside it still work but are slower
+	// to find. "cellSize" is the typical object size: the grid's cell size, and the
+	// quadtree stops splitting once its nodes are that small, or at LooseQuadtree::MAX_DEPTH.
+	static std::unique_ptr< SpatialIndex > Create( SpatialIndexType type, const Bounds2D& world, float cellSize );
+};
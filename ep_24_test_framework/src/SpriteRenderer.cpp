@@ -0,0 +1,46 @@
+#include "SpriteRenderer.h"
+#include "Renderer.h"
+#include "Texture.h"
+#include "Quantize.h"
+#include "Debug.h"
+
+SpriteRenderer::SpriteRenderer()
+	: m_Shader( "res/shaders/PulledSprite.shader" ),
+	m_Sprites( nullptr, 0, BufferUsage::Stream ),
+	m_va()
+{
+	m_Shader.Bind();
+	m_Shader.SetUniform1i( "u_Texture", 0 );
+}
+
+void SpriteRenderer::Begin()
+{
+	m_Records.clear();
+}
+
+void SpriteRenderer::Submit( const glm::vec2& position, const glm::vec2& size, const glm::vec4& texCoords, const glm::vec4& color, float layer )
+{
+	SpriteRecord record;
+	record.Position[0] = position.x;
+	record.Position[1] = position.y;
+	record.Size[0] = size.x;
+	record.Size[1] = size.y;
+	quantize::FloatToUnorm16( &texCoords.x, record.TexCoords, 4 );
+	quantize::FloatToUnorm8( &color.x, record.Color, 4 );
+	record.Layer = layer;
+	m_Records.push_back( record );
+}
+
+void SpriteRenderer::End( const Renderer& renderer, const glm::mat4& viewProjection, const Texture& texture )
+{
+	if ( m_Records.empty() )
+		return;
+
+	m_Sprites.SetData( m_Records.data(), (unsigned int) ( m_Records.size() * sizeof( SpriteRecord ) ) );
+
+	texture.Bind( 0 );
+	m_Shader.Bind();
+	m_Shader.SetStorageBuffer( "Sprites", m_Sprites );
+	m_Shader.SetUniformMat4f( "u_MVP", viewProjection );
+	renderer.DrawArrays( m_va, m_Shader, (unsigned int) m_Records.size() * 6 );
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "ShaderStorageBuffer.h"
+#include "VertexArray.h"
+#include "Shader.h"
+
+#include "glm/glm.hpp"
+
+class Renderer;
+class Texture;
+
+// What a sprite costs in GPU memory: 32 bytes, against 4 vertices and 6 indices for a
+// quad. Laid out like the std430 struct of res/shaders/PulledSprite.shader.
+struct SpriteRecord
+{
+	float Position[2]; // Lower left corner.
+	float Size[2];
+	uint16_t TexCoords[4]; // Unorm16 u0, v0, u1, v1.
+	uint8_t Color[4]; // Unorm8 RGBA, multiplies the texture.
+	float Layer; // z, sorts sprites when depth testing. With glm::ortho( ..., -1, 1 ) 1 is in front.
+};
+
+// Sprite batch without vertex or index buffers. Submitted sprites are stored as
+// SpriteRecords in a shader storage buffer (GL 4.3, see Renderer::IsComputeSupported)
+// and drawn by one glDrawArrays of 6 vertices per sprite with an empty vertex array:
+// the vertex shader finds its sprite and corner from gl_VertexID (vertex pulling).
+class SpriteRenderer
+{
+private:
+	Shader m_Shader;
+	ShaderStorageBuffer m_Sprites;
+	VertexArray m_va;
+	std::vector< SpriteRecord > m_Records;
+
+public:
+	SpriteRenderer();
+
+	SpriteRenderer( const SpriteRenderer& ) = delete;
+	SpriteRenderer& operator=( const SpriteRenderer& ) = delete;
+
+	// Forgets the sprites of the previous frame.
+	void Begin();
+	// "texCoords" is the texture rectangle as u0, v0, u1, v1.
+	void Submit( const glm::vec2& position, const glm::vec2& size, const glm::vec4& texCoords = glm::vec4( 0.0f, 0.0f, 1.0f, 1.0f ),
+				 const glm::vec4& color = glm::vec4( 1.0f ), float layer = 0.0f );
+	// Uploads the sprites and draws them with "texture" on unit 0.
+	void End( const Renderer& renderer, const glm::mat4& viewProjection, const Texture& texture );
+
+	inline unsigned int GetSpriteCount() const { return (unsigned int) m_Records.size(); }
+	// Bytes uploaded by the last End.
+	inline unsigned int GetUploadSize() const { return m_Sprites.GetSize(); }
+};
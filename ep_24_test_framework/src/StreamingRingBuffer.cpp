@@ -0,0 +1,131 @@
+#include "StreamingRingBuffer.h"
+#include "Renderer.h"
+#include "Debug.h"
+
+#include <algorithm>
+
+StreamingRingBuffer::StreamingRingBuffer( unsigned int regionSize, unsigned int regionCount )
+	: m_RendererID( 0 ), m_RegionSize( regionSize ), m_RegionCount( std::min( std::max( regionCount, 1u ), MAX_REGIONS ) ),
+	m_Persistent( IsPersistentMappingSupported() ), m_Mapping( nullptr ), m_RegionData( nullptr ), m_MappedStart( 0 ), m_Fences{ nullptr },
+	m_Region( m_RegionCount - 1 ), m_Used( 0 ), m_Stalls( 0 )
+{
+	const unsigned int size = m_RegionSize * m_RegionCount;
+	if ( m_Persistent && Renderer::IsDirectStateAccessSupported() )
+	{
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		GLCall( glCreateBuffers( 1, &m_RendererID ) );
+		GLCall( glNamedBufferStorage( m_RendererID, size, nullptr, flags ) );
+		GLCall( m_Mapping = (unsigned char*) glMapNamedBufferRange( m_RendererID, 0, size, flags ) );
+		return;
+	}
+
+	GLCall( glGenBuffers( 1, &m_RendererID ) );
+	GLCall( glBindBuffer( GL_COPY_WRITE_BUFFER, m_RendererID ) );
+	if ( m_Persistent )
+	{
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		GLCall( glBufferStorage( GL_COPY_WRITE_BUFFER, size, nullptr, flags ) );
+		GLCall( m_Mapping = (unsigned char*) glMapBufferRange( GL_COPY_WRITE_BUFFER, 0, size, flags ) );
+	}
+	else
+	{
+		GLCall( glBufferData( GL_COPY_WRITE_BUFFER, size, nullptr, GL_STREAM_DRAW ) );
+	}
+	GLCall( glBindBuffer( GL_COPY_WRITE_BUFFER, 0 ) );
+}
+
+StreamingRingBuffer::~StreamingRingBuffer()
+{
+	for ( unsigned int i = 0; i < m_RegionCount; i++ )
+	{
+		if ( m_Fences[i] )
+		{
+			GLCall( glDeleteSync( m_Fences[i] ) );
+		}
+	}
+
+	// Deleting the buffer also unmaps it.
+	GLCall( glDeleteBuffers( 1, &m_RendererID ) );
+}
+
+bool StreamingRingBuffer::IsPersistentMappingSupported()
+{
+	return GLEW_ARB_buffer_storage;
+}
+
+void StreamingRingBuffer::BeginFrame()
+{
+	m_Region = ( m_Region + 1 ) % m_RegionCount;
+	m_Used = 0;
+
+	GLsync& fence = m_Fences[m_Region];
+	if ( fence )
+	{
+		// With three regions the GPU has had two frames to finish, so this rarely waits.
+		GLCall( GLenum result = glClientWaitSync( fence, 0, 0 ) );
+		if ( result == GL_TIMEOUT_EXPIRED )
+		{
+			m_Stalls++;
+			do
+			{
+				GLCall( result = glClientWaitSync( fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000 ) );
+			} while ( result == GL_TIMEOUT_EXPIRED );
+		}
+		GLCall( glDeleteSync( fence ) );
+		fence = nullptr;
+	}
+
+	if ( m_Persistent )
+		m_RegionData = m_Mapping + m_Region * m_RegionSize;
+}
+
+void StreamingRingBuffer::Flush()
+{
+	if ( m_Persistent || m_RegionData == nullptr )
+		return;
+
+	GLCall( glBindBuffer( GL_COPY_WRITE_BUFFER, m_RendererID ) );
+	GLCall( glUnmapBuffer( GL_COPY_WRITE_BUFFER ) );
+	GLCall( glBindBuffer( GL_COPY_WRITE_BUFFER, 0 ) );
+	m_RegionData = nullptr;
+}
+
+void StreamingRingBuffer::EndFrame()
+{
+	Flush();
+	GLCall( m_Fences[m_Region] = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 ) );
+}
+
+void* StreamingRingBuffer::Allocate( unsigned int size, unsigned int alignment, unsigned int& offset )
+{
+	const unsigned int start = ( m_Used + alignment - 1 ) / alignment * alignment;
+	if ( start + size > m_RegionSize )
+	{
+		std::cout << "Streaming ring buffer region full (" << m_RegionSize << " bytes)" << std::endl;
+		return nullptr;
+	}
+
+	if ( m_RegionData == nullptr )
+	{
+		// The fence already guarantees the GPU is done with the region, so no implicit sync.
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+		GLCall( glBindBuffer( GL_COPY_WRITE_BUFFER, m_RendererID ) );
+		GLCall( m_RegionData = (unsigned char*) glMapBufferRange( GL_COPY_WRITE_BUFFER, m_Region * m_RegionSize + start, m_RegionSize - start, flags ) );
+		GLCall( glBindBuffer( GL_COPY_WRITE_BUFFER, 0 ) );
+		m_MappedStart = start;
+	}
+
+	m_Used = start + size;
+	offset = m_Region * m_RegionSize + start;
+	return m_RegionData + ( start - m_MappedStart );
+}
+
+void StreamingRingBuffer::Bind( unsigned int target ) const
+{
+	GLCall( glBindBuffer( target, m_RendererID ) );
+}
+
+void StreamingRingBuffer::Unbind( unsigned int target ) const
+{
+	GLCall( glBindBuffer( target, 0 ) );
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <GL/glew.h>
+
+// One buffer object split into "regionCount" frame sized regions written by the CPU
+// while the GPU still reads the previous ones. Each region is guarded by a fence,
+// so a region is only reused once the draws reading it have finished.
+//
+// With ARB_buffer_storage the whole buffer is mapped once, persistent and coherent,
+// so there is no map/unmap per frame. Otherwise the region is mapped unsynchronized
+// by the first Allocate() and unmapped by Flush().
+//
+// The same buffer can hold vertices, indices and uniforms, bind it to any target.
+class StreamingRingBuffer
+{
+private:
+	static constexpr unsigned int MAX_REGIONS = 4;
+
+	unsigned int m_RendererID;
+	unsigned int m_RegionSize;
+	unsigned int m_RegionCount;
+	bool m_Persistent;
+	unsigned char* m_Mapping;
+	// Start of the mapped part of the current region and its offset in the region.
+	unsigned char* m_RegionData;
+	unsigned int m_MappedStart;
+	GLsync m_Fences[MAX_REGIONS];
+	unsigned int m_Region;
+	unsigned int m_Used;
+	unsigned int m_Stalls;
+
+public:
+	StreamingRingBuffer( unsigned int regionSize, unsigned int regionCount = 3 );
+	~StreamingRingBuffer();
+
+	// Owns a mapping and in-flight fences, so neither copyable nor movable.
+	StreamingRingBuffer( const StreamingRingBuffer& ) = delete;
+	StreamingRingBuffer& operator=( const StreamingRingBuffer& ) = delete;
+
+	// Waits until the next region is free, call before the first Allocate of a frame.
+	void BeginFrame();
+	// Makes the writes so far visible to draws. Only needed before drawing without
+	// persistent mapping, where it unmaps the region; Allocate() maps it again.
+	void Flush();
+	// Fences the region after the frame's draws have been submitted.
+	void EndFrame();
+
+	// Returns where to write "size" bytes and their offset in the buffer,
+	// or nullptr when the frame's region is full.
+	void* Allocate( unsigned int size, unsigned int alignment, unsigned int& offset );
+
+	void Bind( unsigned int target ) const;
+	void Unbind( unsigned int target ) const;
+
+	inline unsigned int GetRendererID() const { return m_RendererID; }
+	inline unsigned int GetRegionSize() const { return m_RegionSize; }
+	inline unsigned int GetRegionCount() const { return m_RegionCount; }
+	inline unsigned int GetUsed() const { return m_Used; }
+	// Frames that had to wait for the GPU to release a region.
+	inline unsigned int GetStallCount() const { return m_Stalls; }
+	inline bool IsPersistent() const { return m_Persistent; }
+
+	static bool IsPersistentMappingSupported();
+};
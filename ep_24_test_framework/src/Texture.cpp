@@ -1,42 +1,510 @@
 #include "Texture.h"
 #include "Renderer.h"
+#include "CookedTexture.h"
+#include "TextureManager.h"
 #include "Debug.h"
 
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
 #include "stb_image/stb_image.h"
 
 Texture::Texture( const std::string& path )
-	: m_RendererID( 0 ), m_FilePath( path ), m_LocalBuffer( nullptr ), m_Width( 0 ), m_Height( 0 ), m_BPP( 0 )
+	: m_RendererID( 0 ), m_FilePath( path ), m_LocalBuffer( nullptr ), m_Width( 0 ), m_Height( 0 ), m_BPP( 0 ),
+	m_InternalFormat( GL_RGBA8 ), m_Format( GL_RGBA ), m_Type( GL_UNSIGNED_BYTE ), m_Levels( 1 ),
+	m_PixelBuffers{ 0 }, m_PixelBufferIndex( 0 ), m_PendingUpdate{ 0 }, m_BindlessHandle( 0 )
+{
+	Load();
+	TextureManager::Get().Register( this );
+};
+
+Texture::Texture( int width, int height, unsigned int internalFormat, const void* data, unsigned int levels )
+	: m_RendererID( 0 ), m_LocalBuffer( nullptr ), m_Width( width ), m_Height( height ), m_BPP( 0 ),
+	m_InternalFormat( internalFormat ), m_Format( 0 ), m_Type( 0 ), m_Levels( levels ),
+	m_PixelBuffers{ 0 }, m_PixelBufferIndex( 0 ), m_PendingUpdate{ 0 }, m_BindlessHandle( 0 )
+{
+	if ( !GetClientFormat( internalFormat, m_Format, m_Type, m_BPP ) && !IsCompressedFormat( internalFormat ) )
+	{
+		std::cout << "Unsupported texture format " << internalFormat << std::endl;
+		ASSERT( false );
+		return;
+	}
+
+	Create();
+	SetParameters();
+	AllocateStorage();
+	if ( data )
+		UploadRegion( 0, 0, width, height, data );
+	FinishEdit();
+
+	TextureManager::Get().Register( this );
+}
+
+Texture::~Texture()
+{
+	Release();
+}
+
+Texture::Texture( Texture&& other ) noexcept
+	: m_RendererID( 0 ), m_LocalBuffer( nullptr ), m_Width( 0 ), m_Height( 0 ), m_BPP( 0 ),
+	m_InternalFormat( GL_RGBA8 ), m_Format( GL_RGBA ), m_Type( GL_UNSIGNED_BYTE ), m_Levels( 1 ),
+	m_PixelBuffers{ 0 }, m_PixelBufferIndex( 0 ), m_PendingUpdate{ 0 }, m_BindlessHandle( 0 )
+{
+	MoveFrom( other );
+}
+
+Texture& Texture::operator=( Texture&& other ) noexcept
+{
+	if ( this != &other )
+	{
+		Release();
+		MoveFrom( other );
+	}
+	return *this;
+}
+
+void Texture::Release()
+{
+	TextureManager::Get().Unregister( this );
+
+	ReleaseBindlessHandle();
+	if ( m_PixelBuffers[0] )
+	{
+		GLCall( glDeleteBuffers( PIXEL_BUFFER_COUNT, m_PixelBuffers ) );
+		std::fill( std::begin( m_PixelBuffers ), std::end( m_PixelBuffers ), 0 );
+	}
+	GLCall( glDeleteTextures( 1, &m_RendererID ) );
+	m_RendererID = 0;
+}
+
+void Texture::MoveFrom( Texture& other )
+{
+	m_RendererID = std::exchange( other.m_RendererID, 0 );
+	m_FilePath = std::move( other.m_FilePath );
+	other.m_FilePath.clear();
+	m_Width = std::exchange( other.m_Width, 0 );
+	m_Height = std::exchange( other.m_Height, 0 );
+	m_BPP = other.m_BPP;
+	m_InternalFormat = other.m_InternalFormat;
+	m_Format = other.m_Format;
+	m_Type = other.m_Type;
+	m_Levels = other.m_Levels;
+	std::copy( std::begin( other.m_PixelBuffers ), std::end( other.m_PixelBuffers ), m_PixelBuffers );
+	std::fill( std::begin( other.m_PixelBuffers ), std::end( other.m_PixelBuffers ), 0 );
+	m_PixelBufferIndex = other.m_PixelBufferIndex;
+	std::copy( std::begin( other.m_PendingUpdate ), std::end( other.m_PendingUpdate ), m_PendingUpdate );
+	m_BindlessHandle = std::exchange( other.m_BindlessHandle, 0 );
+
+	TextureManager::Get().OnMove( &other, this );
+}
+
+void Texture::Load()
+{
+	const std::string cookedPath = CookedTexture::GetCookedPath( m_FilePath );
+	{
+		// A cooked texture next to its source is only used while the source is unchanged.
+		CookedTexture cooked( cookedPath );
+		if ( cooked.IsValid() && ( m_FilePath == cookedPath || cooked.IsUpToDate( m_FilePath ) ) && LoadFromCooked( cooked ) )
+			return;
+	}
+
+	if ( m_FilePath != cookedPath )
+		LoadFromImage( m_FilePath );
+	else
+		std::cout << "Failed to load cooked texture " << m_FilePath << std::endl;
+}
+
+void Texture::Evict()
+{
+	ReleaseBindlessHandle();
+	GLCall( glDeleteTextures( 1, &m_RendererID ) );
+	m_RendererID = 0;
+}
+
+uint64_t Texture::GetBindlessHandle()
+{
+	if ( m_BindlessHandle == 0 && GLEW_ARB_bindless_texture )
+	{
+		MakeResident();
+		GLCall( m_BindlessHandle = glGetTextureHandleARB( m_RendererID ) );
+		GLCall( glMakeTextureHandleResidentARB( m_BindlessHandle ) );
+	}
+	return m_BindlessHandle;
+}
+
+void Texture::ReleaseBindlessHandle()
+{
+	if ( m_BindlessHandle == 0 )
+		return;
+
+	// The handle itself stays valid as long as the texture, it just stops being usable in shaders.
+	GLCall( glMakeTextureHandleNonResidentARB( m_BindlessHandle ) );
+	m_BindlessHandle = 0;
+}
+
+void Texture::Restore()
+{
+	Load();
+}
+
+size_t Texture::GetMemorySize() const
+{
+	unsigned int format, type;
+	int bytesPerPixel = 0;
+	const bool compressed = IsCompressedFormat( m_InternalFormat );
+	GetClientFormat( m_InternalFormat, format, type, bytesPerPixel );
+
+	size_t size = 0;
+	for ( unsigned int i = 0; i < m_Levels; i++ )
+	{
+		const size_t width = std::max( 1, m_Width >> i );
+		const size_t height = std::max( 1, m_Height >> i );
+		// DXT5 stores every 4x4 block in 16 bytes.
+		size += compressed ? ( ( width + 3 ) / 4 ) * ( ( height + 3 ) / 4 ) * 16 : width * height * bytesPerPixel;
+	}
+	return size;
+}
+
+void Texture::LoadFromImage( const std::string& path )
 {
 	stbi_set_flip_vertically_on_load( 1 );
 	m_LocalBuffer = stbi_load( path.c_str(), &m_Width, &m_Height, &m_BPP, 4 );
+	// A missing image becomes one magenta texel, immutable storage can not be empty.
+	static const unsigned char MISSING_TEXEL[4] = { 255, 0, 255, 255 };
+	if ( !m_LocalBuffer )
+	{
+		std::cout << "Failed to load texture " << path << ": " << stbi_failure_reason() << std::endl;
+		m_Width = 1;
+		m_Height = 1;
+		m_BPP = 4;
+	}
+
+	Create();
+	SetParameters();
+	AllocateStorage();
+	UploadRegion( 0, 0, m_Width, m_Height, m_LocalBuffer ? m_LocalBuffer : MISSING_TEXEL );
+	FinishEdit();
+
+	if ( m_LocalBuffer )
+		stbi_image_free( m_LocalBuffer );
+	m_LocalBuffer = nullptr;
+}
+
+bool Texture::LoadFromCooked( const CookedTexture& cooked )
+{
+	const CookedTextureHeader& header = cooked.GetHeader();
+	if ( cooked.IsCompressed() && !GLEW_EXT_texture_compression_s3tc )
+	{
+		std::cout << "DXT5 is not supported, ignoring " << CookedTexture::GetCookedPath( m_FilePath ) << std::endl;
+		return false;
+	}
+
+	m_Width = header.Width;
+	m_Height = header.Height;
+	m_BPP = 4;
+	m_InternalFormat = header.InternalFormat;
+	m_Format = cooked.IsCompressed() ? 0 : header.Format;
+	m_Type = cooked.IsCompressed() ? 0 : header.Type;
+	m_Levels = header.Levels;
+
+	Create();
+	SetParameters();
+
+	// Levels are uploaded straight from the mapped file, no intermediate copy.
+	const bool named = Renderer::IsDirectStateAccessSupported();
+	const bool immutable = GLEW_ARB_texture_storage;
+	if ( named )
+	{
+		GLCall( glTextureStorage2D( m_RendererID, header.Levels, header.InternalFormat, m_Width, m_Height ) );
+	}
+	else if ( immutable )
+	{
+		GLCall( glTexStorage2D( GL_TEXTURE_2D, header.Levels, header.InternalFormat, m_Width, m_Height ) );
+	}
+
+	for ( unsigned int i = 0; i < header.Levels; i++ )
+	{
+		const CookedTextureLevel& level = cooked.GetLevel( i );
+		const void* data = cooked.GetLevelData( i );
+		if ( cooked.IsCompressed() && named )
+		{
+			GLCall( glCompressedTextureSubImage2D( m_RendererID, i, 0, 0, level.Width, level.Height, header.InternalFormat, level.Size, data ) );
+		}
+		else if ( named )
+		{
+			GLCall( glTextureSubImage2D( m_RendererID, i, 0, 0, level.Width, level.Height, header.Format, header.Type, data ) );
+		}
+		else if ( cooked.IsCompressed() && immutable )
+		{
+			GLCall( glCompressedTexSubImage2D( GL_TEXTURE_2D, i, 0, 0, level.Width, level.Height, header.InternalFormat, level.Size, data ) );
+		}
+		else if ( cooked.IsCompressed() )
+		{
+			GLCall( glCompressedTexImage2D( GL_TEXTURE_2D, i, header.InternalFormat, level.Width, level.Height, 0, level.Size, data ) );
+		}
+		else if ( immutable )
+		{
+			GLCall( glTexSubImage2D( GL_TEXTURE_2D, i, 0, 0, level.Width, level.Height, header.Format, header.Type, data ) );
+		}
+		else
+		{
+			GLCall( glTexImage2D( GL_TEXTURE_2D, i, header.InternalFormat, level.Width, level.Height, 0, header.Format, header.Type, data ) );
+		}
+	}
+	FinishEdit();
+
+	return true;
+}
+
+void Texture::Create()
+{
+	if ( Renderer::IsDirectStateAccessSupported() )
+	{
+		GLCall( glCreateTextures( GL_TEXTURE_2D, 1, &m_RendererID ) );
+		return;
+	}
+
+	// Bind without slot selection, FinishEdit() unbinds.
 	GLCall( glGenTextures( 1, &m_RendererID ) );
-	GLCall( glBindTexture( GL_TEXTURE_2D, m_RendererID ) ); // Bind without slot selection
+	GLCall( glBindTexture( GL_TEXTURE_2D, m_RendererID ) );
+}
+
+void Texture::BeginEdit() const
+{
+	if ( !Renderer::IsDirectStateAccessSupported() )
+	{
+		GLCall( glBindTexture( GL_TEXTURE_2D, m_RendererID ) );
+	}
+}
+
+void Texture::FinishEdit() const
+{
+	if ( !Renderer::IsDirectStateAccessSupported() )
+		Unbind();
+}
 
-	GLCall( glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR ) );
-	GLCall( glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR ) );
-	GLCall( glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE ) );
-	GLCall( glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE ) );
+void Texture::SetParameter( unsigned int name, int value ) const
+{
+	if ( Renderer::IsDirectStateAccessSupported() )
+	{
+		GLCall( glTextureParameteri( m_RendererID, name, value ) );
+	}
+	else
+	{
+		GLCall( glTexParameteri( GL_TEXTURE_2D, name, value ) );
+	}
+}
+
+void Texture::SetParameters() const
+{
+	// Integer textures are incomplete with any filtering but nearest.
+	if ( m_Format == GL_RED_INTEGER || m_Format == GL_RGBA_INTEGER )
+	{
+		SetParameter( GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+		SetParameter( GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+	}
+	else
+	{
+		SetParameter( GL_TEXTURE_MIN_FILTER, m_Levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR );
+		SetParameter( GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+	}
+	SetParameter( GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+	SetParameter( GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+	SetParameter( GL_TEXTURE_MAX_LEVEL, m_Levels - 1 );
+}
+
+void Texture::AllocateStorage()
+{
+	if ( Renderer::IsDirectStateAccessSupported() )
+	{
+		GLCall( glTextureStorage2D( m_RendererID, m_Levels, m_InternalFormat, m_Width, m_Height ) );
+		return;
+	}
+
+	// Immutable storage lets the driver skip per-level completeness checks and
+	// guarantees later updates never reallocate.
+	if ( GLEW_ARB_texture_storage )
+	{
+		GLCall( glTexStorage2D( GL_TEXTURE_2D, m_Levels, m_InternalFormat, m_Width, m_Height ) );
+		return;
+	}
+
+	for ( unsigned int i = 0; i < m_Levels; i++ )
+	{
+		const int width = std::max( 1, m_Width >> i );
+		const int height = std::max( 1, m_Height >> i );
+		if ( IsCompressedFormat( m_InternalFormat ) )
+		{
+			const int size = ( ( width + 3 ) / 4 ) * ( ( height + 3 ) / 4 ) * 16;
+			GLCall( glCompressedTexImage2D( GL_TEXTURE_2D, i, m_InternalFormat, width, height, 0, size, nullptr ) );
+		}
+		else
+		{
+			GLCall( glTexImage2D( GL_TEXTURE_2D, i, m_InternalFormat, width, height, 0, m_Format, m_Type, nullptr ) );
+		}
+	}
+}
+
+void Texture::UploadRegion( int x, int y, int width, int height, const void* data )
+{
+	const bool named = Renderer::IsDirectStateAccessSupported();
+
+	// Rows are tightly packed whatever the pixel size.
+	GLCall( glPixelStorei( GL_UNPACK_ALIGNMENT, 1 ) );
+	if ( named )
+	{
+		GLCall( glTextureSubImage2D( m_RendererID, 0, x, y, width, height, m_Format, m_Type, data ) );
+	}
+	else
+	{
+		GLCall( glTexSubImage2D( GL_TEXTURE_2D, 0, x, y, width, height, m_Format, m_Type, data ) );
+	}
+	GLCall( glPixelStorei( GL_UNPACK_ALIGNMENT, 4 ) );
+
+	if ( m_Levels > 1 && named )
+	{
+		GLCall( glGenerateTextureMipmap( m_RendererID ) );
+	}
+	else if ( m_Levels > 1 )
+	{
+		GLCall( glGenerateMipmap( GL_TEXTURE_2D ) );
+	}
+}
+
+void Texture::Update( int x, int y, int width, int height, const void* data )
+{
+	ASSERT( m_Format != 0 ); // Compressed textures cannot be updated.
+	ASSERT( x >= 0 && y >= 0 && x + width <= m_Width && y + height <= m_Height );
+
+	BeginEdit();
+	UploadRegion( x, y, width, height, data );
+	FinishEdit();
+}
 
-	GLCall( glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_LocalBuffer ) );
+void Texture::UpdateCompressed( int x, int y, int width, int height, const void* data, unsigned int size )
+{
+	ASSERT( IsCompressedFormat( m_InternalFormat ) );
+	ASSERT( x % 4 == 0 && y % 4 == 0 && x + width <= m_Width && y + height <= m_Height );
+
+	if ( Renderer::IsDirectStateAccessSupported() )
+	{
+		GLCall( glCompressedTextureSubImage2D( m_RendererID, 0, x, y, width, height, m_InternalFormat, size, data ) );
+		return;
+	}
+
+	GLCall( glBindTexture( GL_TEXTURE_2D, m_RendererID ) );
+	GLCall( glCompressedTexSubImage2D( GL_TEXTURE_2D, 0, x, y, width, height, m_InternalFormat, size, data ) );
 	Unbind();
+}
 
-	if ( m_LocalBuffer )
-		stbi_image_free( m_LocalBuffer );
-};
+void Texture::UpdateAsync( int x, int y, int width, int height, const void* data )
+{
+	void* pixels = BeginUpdateAsync( x, y, width, height );
+	if ( !pixels )
+	{
+		Update( x, y, width, height, data );
+		return;
+	}
+	std::memcpy( pixels, data, (size_t) width * height * m_BPP );
+	EndUpdateAsync();
+}
 
-Texture::~Texture()
+void* Texture::BeginUpdateAsync( int x, int y, int width, int height )
 {
-	GLCall( glDeleteTextures( 1, &m_RendererID ) );
+	ASSERT( m_Format != 0 );
+	ASSERT( x >= 0 && y >= 0 && x + width <= m_Width && y + height <= m_Height );
+
+	const bool named = Renderer::IsDirectStateAccessSupported();
+	if ( m_PixelBuffers[0] == 0 && named )
+	{
+		GLCall( glCreateBuffers( PIXEL_BUFFER_COUNT, m_PixelBuffers ) );
+	}
+	else if ( m_PixelBuffers[0] == 0 )
+	{
+		GLCall( glGenBuffers( PIXEL_BUFFER_COUNT, m_PixelBuffers ) );
+	}
+
+	// Cycle through the buffers and orphan the one we pick, so a transfer still
+	// in flight from a previous frame never blocks the mapping.
+	m_PixelBufferIndex = ( m_PixelBufferIndex + 1 ) % PIXEL_BUFFER_COUNT;
+	const unsigned int buffer = m_PixelBuffers[m_PixelBufferIndex];
+	const GLsizeiptr size = (GLsizeiptr) width * height * m_BPP;
+	void* pixels = nullptr;
+	if ( named )
+	{
+		GLCall( glNamedBufferData( buffer, size, nullptr, GL_STREAM_DRAW ) );
+		GLCall( pixels = glMapNamedBufferRange( buffer, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT ) );
+	}
+	else
+	{
+		GLCall( glBindBuffer( GL_PIXEL_UNPACK_BUFFER, buffer ) );
+		GLCall( glBufferData( GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW ) );
+		GLCall( pixels = glMapBufferRange( GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT ) );
+		GLCall( glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 ) );
+	}
+
+	m_PendingUpdate[0] = x;
+	m_PendingUpdate[1] = y;
+	m_PendingUpdate[2] = width;
+	m_PendingUpdate[3] = height;
+	return pixels;
+}
+
+void Texture::EndUpdateAsync()
+{
+	// The source of the copy is always the bound pixel unpack buffer, even with direct state access.
+	GLCall( glBindBuffer( GL_PIXEL_UNPACK_BUFFER, m_PixelBuffers[m_PixelBufferIndex] ) );
+	GLCall( glUnmapBuffer( GL_PIXEL_UNPACK_BUFFER ) );
+
+	// With a pixel unpack buffer bound the data pointer is an offset into it.
+	BeginEdit();
+	UploadRegion( m_PendingUpdate[0], m_PendingUpdate[1], m_PendingUpdate[2], m_PendingUpdate[3], nullptr );
+	FinishEdit();
+
+	GLCall( glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 ) );
+}
+
+bool Texture::IsCompressedFormat( unsigned int internalFormat )
+{
+	return internalFormat == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+}
+
+bool Texture::GetClientFormat( unsigned int internalFormat, unsigned int& format, unsigned int& type, int& bytesPerPixel )
+{
+	switch ( internalFormat )
+	{
+		case GL_RGBA8: format = GL_RGBA; type = GL_UNSIGNED_BYTE; bytesPerPixel = 4; return true;
+		case GL_SRGB8_ALPHA8: format = GL_RGBA; type = GL_UNSIGNED_BYTE; bytesPerPixel = 4; return true;
+		case GL_RGB8: format = GL_RGB; type = GL_UNSIGNED_BYTE; bytesPerPixel = 3; return true;
+		case GL_RG8: format = GL_RG; type = GL_UNSIGNED_BYTE; bytesPerPixel = 2; return true;
+		case GL_R8: format = GL_RED; type = GL_UNSIGNED_BYTE; bytesPerPixel = 1; return true;
+		case GL_RGBA16F: format = GL_RGBA; type = GL_HALF_FLOAT; bytesPerPixel = 8; return true;
+		case GL_RGBA32F: format = GL_RGBA; type = GL_FLOAT; bytesPerPixel = 16; return true;
+		case GL_R32F: format = GL_RED; type = GL_FLOAT; bytesPerPixel = 4; return true;
+		case GL_DEPTH_COMPONENT32F: format = GL_DEPTH_COMPONENT; type = GL_FLOAT; bytesPerPixel = 4; return true;
+		case GL_R32UI: format = GL_RED_INTEGER; type = GL_UNSIGNED_INT; bytesPerPixel = 4; return true;
+		case GL_RGBA8UI: format = GL_RGBA_INTEGER; type = GL_UNSIGNED_BYTE; bytesPerPixel = 4; return true;
+		case GL_RGBA16UI: format = GL_RGBA_INTEGER; type = GL_UNSIGNED_SHORT; bytesPerPixel = 8; return true;
+	}
+	return false;
 }
 
 void Texture::Bind( unsigned int slot ) const
 {
+	// Reloads the texture first if it was evicted.
+	TextureManager::Get().OnBind( this, slot );
 	GLCall( glActiveTexture( GL_TEXTURE0 + slot ) );
 	GLCall( glBindTexture( GL_TEXTURE_2D, m_RendererID ) );
 }
 
+void Texture::MakeResident() const
+{
+	TextureManager::Get().MakeResident( this );
+}
+
 void Texture::Unbind() const
 {
+	TextureManager::Get().OnUnbind( this );
 	GLCall( glBindTexture( GL_TEXTURE_2D, 0 ) );
 }
-
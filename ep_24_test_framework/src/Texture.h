@@ -1,22 +1,103 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <GL/glew.h>
+
+class CookedTexture;
 
 class Texture
 {
 private:
+	static const unsigned int PIXEL_BUFFER_COUNT = 3;
+
 	unsigned int m_RendererID;
 	std::string m_FilePath;
 	unsigned char* m_LocalBuffer;
 	int m_Width, m_Height, m_BPP;
+	unsigned int m_InternalFormat;
+	unsigned int m_Format, m_Type;
+	unsigned int m_Levels;
+
+	// Pixel unpack buffers used round-robin by the asynchronous update path.
+	unsigned int m_PixelBuffers[PIXEL_BUFFER_COUNT];
+	unsigned int m_PixelBufferIndex;
+	int m_PendingUpdate[4];
+
+	// ARB_bindless_texture handle, 0 until GetBindlessHandle() is first called.
+	uint64_t m_BindlessHandle;
 
 public:
+	// Loads the cooked sibling of "path" (see CookedTexture::GetCookedPath) when one exists.
 	Texture( const std::string& path );
+	// Allocates immutable storage for "levels" levels, optionally filling level 0 with "data".
+	Texture( int width, int height, unsigned int internalFormat = GL_RGBA8, const void* data = nullptr, unsigned int levels = 1 );
 	~Texture();
 
+	// Move-only. The texture manager follows the texture to its new address, a
+	// moved-from texture owns no GL name and is not tracked.
+	Texture( const Texture& ) = delete;
+	Texture& operator=( const Texture& ) = delete;
+	Texture( Texture&& other ) noexcept;
+	Texture& operator=( Texture&& other ) noexcept;
+
 	void Bind( unsigned int slot = 0 ) const;
 	void Unbind() const;
 
+	// Replaces a region of level 0 in place, the storage is never reallocated.
+	void Update( int x, int y, int width, int height, const void* data );
+	// Same for block compressed textures, the region must be aligned to whole blocks.
+	void UpdateCompressed( int x, int y, int width, int height, const void* data, unsigned int size );
+
+	// Same as Update but the pixels go through a pixel buffer object, so the copy
+	// to the texture happens on the GPU timeline instead of stalling the caller.
+	void UpdateAsync( int x, int y, int width, int height, const void* data );
+	// Returns a pointer where the caller writes width * height pixels, EndUpdateAsync submits them.
+	void* BeginUpdateAsync( int x, int y, int width, int height );
+	void EndUpdateAsync();
+
+	// Returns a resident bindless handle for shaders to sample without a texture unit.
+	// Parameters and storage are frozen from then on, updating the contents is still fine.
+	uint64_t GetBindlessHandle();
+	inline bool HasBindlessHandle() const { return m_BindlessHandle != 0; }
+	// Makes the handle non-resident, GetBindlessHandle() makes it resident again.
+	void ReleaseBindlessHandle();
+
+	inline unsigned int GetRendererID() const { return m_RendererID; }
 	inline int GetWidth() const { return m_Width; }
 	inline int GetHeight() const { return m_Height; }
+	inline unsigned int GetInternalFormat() const { return m_InternalFormat; }
+	inline unsigned int GetLevels() const { return m_Levels; }
+	inline const std::string& GetFilePath() const { return m_FilePath; }
+
+	// Estimated video memory used by all levels.
+	size_t GetMemorySize() const;
+	inline bool IsResident() const { return m_RendererID != 0; }
+	// Reloads an evicted texture for use through its GL name. With direct state access
+	// no binding changes, otherwise the reload edits it bound like Update does.
+	void MakeResident() const;
+	// Only file backed textures can be evicted and loaded again.
+	inline bool IsReloadable() const { return !m_FilePath.empty(); }
+
+private:
+	friend class TextureManager;
+
+	void Load();
+	void Release();
+	void MoveFrom( Texture& other );
+	void Evict();
+	void Restore();
+	void LoadFromImage( const std::string& path );
+	bool LoadFromCooked( const CookedTexture& cooked );
+	// Without direct state access these bind the texture to the active unit while it is edited.
+	void Create();
+	void BeginEdit() const;
+	void FinishEdit() const;
+	void AllocateStorage();
+	void SetParameter( unsigned int name, int value ) const;
+	void SetParameters() const;
+	void UploadRegion( int x, int y, int width, int height, const void* data );
+
+	static bool IsCompressedFormat( unsigned int internalFormat );
+	static bool GetClientFormat( unsigned int internalFormat, unsigned int& format, unsigned int& type, int& bytesPerPixel );
 };
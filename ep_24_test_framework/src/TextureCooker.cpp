@@ -0,0 +1,373 @@
+#include "TextureCooker.h"
+#include "CookedTexture.h"
+#include "TiledImage.h"
+
+#include <GL/glew.h>
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "stb_image/stb_image.h"
+
+namespace cooker
+{
+	struct Image
+	{
+		unsigned int Width;
+		unsigned int Height;
+		std::vector< unsigned char > Pixels; // RGBA8.
+	};
+
+	// 2x2 box filter, clamping at odd edges.
+	static Image Downsample( const Image& src )
+	{
+		Image dst;
+		dst.Width = std::max( 1u, src.Width / 2 );
+		dst.Height = std::max( 1u, src.Height / 2 );
+		dst.Pixels.resize( dst.Width * dst.Height * 4 );
+
+		for ( unsigned int y = 0; y < dst.Height; y++ )
+		{
+			const unsigned int y0 = std::min( y * 2, src.Height - 1 );
+			const unsigned int y1 = std::min( y * 2 + 1, src.Height - 1 );
+			for ( unsigned int x = 0; x < dst.Width; x++ )
+			{
+				const unsigned int x0 = std::min( x * 2, src.Width - 1 );
+				const unsigned int x1 = std::min( x * 2 + 1, src.Width - 1 );
+				for ( unsigned int c = 0; c < 4; c++ )
+				{
+					const unsigned int sum = src.Pixels[( y0 * src.Width + x0 ) * 4 + c]
+						+ src.Pixels[( y0 * src.Width + x1 ) * 4 + c]
+						+ src.Pixels[( y1 * src.Width + x0 ) * 4 + c]
+						+ src.Pixels[( y1 * src.Width + x1 ) * 4 + c];
+					dst.Pixels[( y * dst.Width + x ) * 4 + c] = (unsigned char) ( ( sum + 2 ) / 4 );
+				}
+			}
+		}
+		return dst;
+	}
+
+	static unsigned short PackRGB565( const unsigned char* color )
+	{
+		return (unsigned short) ( ( ( color[0] >> 3 ) << 11 ) | ( ( color[1] >> 2 ) << 5 ) | ( color[2] >> 3 ) );
+	}
+
+	static void UnpackRGB565( unsigned short packed, int* color )
+	{
+		const int r = ( packed >> 11 ) & 31, g = ( packed >> 5 ) & 63, b = packed & 31;
+		color[0] = ( r << 3 ) | ( r >> 2 );
+		color[1] = ( g << 2 ) | ( g >> 4 );
+		color[2] = ( b << 3 ) | ( b >> 2 );
+	}
+
+	// Bounding box endpoints, indices by projection onto the box diagonal.
+	static void EncodeBlockDXT5( const unsigned char* block, unsigned char* out )
+	{
+		// Alpha block: 8 interpolated values between the extremes.
+		unsigned char alphaMin = 255, alphaMax = 0;
+		for ( unsigned int i = 0; i < 16; i++ )
+		{
+			alphaMin = std::min( alphaMin, block[i * 4 + 3] );
+			alphaMax = std::max( alphaMax, block[i * 4 + 3] );
+		}
+		out[0] = alphaMax;
+		out[1] = alphaMin;
+
+		unsigned long long alphaBits = 0;
+		if ( alphaMax != alphaMin )
+		{
+			const int range = alphaMax - alphaMin;
+			for ( unsigned int i = 0; i < 16; i++ )
+			{
+				// 0 -> alphaMax, 7 -> alphaMin; codes 2..7 are the interpolated values in between.
+				const int step = ( ( alphaMax - block[i * 4 + 3] ) * 7 + range / 2 ) / range;
+				const unsigned long long code = step == 0 ? 0 : ( step == 7 ? 1 : step + 1 );
+				alphaBits |= code << ( 3 * i );
+			}
+		}
+		for ( unsigned int i = 0; i < 6; i++ )
+			out[2 + i] = (unsigned char) ( alphaBits >> ( 8 * i ) );
+
+		// Color block: 4-color mode requires color0 > color1.
+		unsigned char colorMin[3] = { 255, 255, 255 }, colorMax[3] = { 0, 0, 0 };
+		for ( unsigned int i = 0; i < 16; i++ )
+		{
+			for ( unsigned int c = 0; c < 3; c++ )
+			{
+				colorMin[c] = std::min( colorMin[c], block[i * 4 + c] );
+				colorMax[c] = std::max( colorMax[c], block[i * 4 + c] );
+			}
+		}
+		// Inset the box slightly to reduce the error introduced by the extremes.
+		for ( unsigned int c = 0; c < 3; c++ )
+		{
+			const int inset = ( colorMax[c] - colorMin[c] ) / 16;
+			colorMin[c] = (unsigned char) std::min( 255, colorMin[c] + inset );
+			colorMax[c] = (unsigned char) std::max( 0, colorMax[c] - inset );
+		}
+
+		unsigned short color0 = PackRGB565( colorMax );
+		unsigned short color1 = PackRGB565( colorMin );
+		if ( color0 < color1 )
+			std::swap( color0, color1 );
+
+		unsigned int colorBits = 0;
+		if ( color0 != color1 )
+		{
+			int end0[3], end1[3];
+			UnpackRGB565( color0, end0 );
+			UnpackRGB565( color1, end1 );
+			const int axis[3] = { end0[0] - end1[0], end0[1] - end1[1], end0[2] - end1[2] };
+			const int length = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+			for ( unsigned int i = 0; i < 16; i++ )
+			{
+				const int dot = ( block[i * 4 + 0] - end1[0] ) * axis[0]
+					+ ( block[i * 4 + 1] - end1[1] ) * axis[1]
+					+ ( block[i * 4 + 2] - end1[2] ) * axis[2];
+				// 3 -> color0, 0 -> color1.
+				const int step = std::min( 3, std::max( 0, ( dot * 3 + length / 2 ) / length ) );
+				static const unsigned int codes[4] = { 1, 3, 2, 0 };
+				colorBits |= codes[step] << ( 2 * i );
+			}
+		}
+		out[8] = (unsigned char) ( color0 & 0xFF );
+		out[9] = (unsigned char) ( color0 >> 8 );
+		out[10] = (unsigned char) ( color1 & 0xFF );
+		out[11] = (unsigned char) ( color1 >> 8 );
+		for ( unsigned int i = 0; i < 4; i++ )
+			out[12 + i] = (unsigned char) ( colorBits >> ( 8 * i ) );
+	}
+
+	static std::vector< unsigned char > CompressDXT5( const Image& image )
+	{
+		const unsigned int blocksX = ( image.Width + 3 ) / 4;
+		const unsigned int blocksY = ( image.Height + 3 ) / 4;
+		std::vector< unsigned char > data( blocksX * blocksY * 16 );
+
+		unsigned char block[64];
+		for ( unsigned int by = 0; by < blocksY; by++ )
+		{
+			for ( unsigned int bx = 0; bx < blocksX; bx++ )
+			{
+				for ( unsigned int i = 0; i < 16; i++ )
+				{
+					const unsigned int x = std::min( bx * 4 + i % 4, image.Width - 1 );
+					const unsigned int y = std::min( by * 4 + i / 4, image.Height - 1 );
+					std::copy_n( &image.Pixels[( y * image.Width + x ) * 4], 4, &block[i * 4] );
+				}
+				EncodeBlockDXT5( block, &data[( by * blocksX + bx ) * 16] );
+			}
+		}
+		return data;
+	}
+
+	bool CookTexture( const std::string& sourcePath, const std::string& cookedPath, bool compress )
+	{
+		uint64_t sourceSize, sourceTime;
+		if ( !CookedTexture::GetSourceInfo( sourcePath, sourceSize, sourceTime ) )
+		{
+			std::cout << "Failed to load " << sourcePath << std::endl;
+			return false;
+		}
+
+		int width, height, bpp;
+		stbi_set_flip_vertically_on_load( 1 );
+		unsigned char* pixels = stbi_load( sourcePath.c_str(), &width, &height, &bpp, 4 );
+		if ( !pixels )
+		{
+			std::cout << "Failed to load " << sourcePath << ": " << stbi_failure_reason() << std::endl;
+			return false;
+		}
+
+		Image image;
+		image.Width = width;
+		image.Height = height;
+		image.Pixels.assign( pixels, pixels + width * height * 4 );
+		stbi_image_free( pixels );
+
+		// Block compression needs the base level to be made of whole blocks.
+		if ( compress && ( width % 4 != 0 || height % 4 != 0 ) )
+		{
+			std::cout << sourcePath << " is not a multiple of 4, cooking it uncompressed" << std::endl;
+			compress = false;
+		}
+
+		std::vector< std::vector< unsigned char > > levelData;
+		std::vector< CookedTextureLevel > levels;
+		while ( true )
+		{
+			levelData.push_back( compress ? CompressDXT5( image ) : image.Pixels );
+			levels.push_back( { image.Width, image.Height, 0, (uint32_t) levelData.back().size() } );
+			if ( image.Width == 1 && image.Height == 1 )
+				break;
+			image = Downsample( image );
+		}
+
+		CookedTextureHeader header;
+		std::copy_n( COOKED_TEXTURE_MAGIC, 4, header.Magic );
+		header.Version = COOKED_TEXTURE_VERSION;
+		header.SourceSize = sourceSize;
+		header.SourceTime = sourceTime;
+		header.Width = width;
+		header.Height = height;
+		header.Levels = (uint32_t) levels.size();
+		header.InternalFormat = compress ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_RGBA8;
+		header.Format = GL_RGBA;
+		header.Type = GL_UNSIGNED_BYTE;
+
+		const auto align = []( uint32_t offset ) { return ( offset + COOKED_TEXTURE_ALIGNMENT - 1 ) & ~( COOKED_TEXTURE_ALIGNMENT - 1 ); };
+		uint32_t offset = align( (uint32_t) ( sizeof( header ) + levels.size() * sizeof( CookedTextureLevel ) ) );
+		for ( auto& level : levels )
+		{
+			level.Offset = offset;
+			offset = align( offset + level.Size );
+		}
+
+		std::ofstream stream( cookedPath, std::ios::binary | std::ios::trunc );
+		if ( !stream )
+		{
+			std::cout << "Failed to open " << cookedPath << " for writing" << std::endl;
+			return false;
+		}
+		stream.write( reinterpret_cast< const char* >( &header ), sizeof( header ) );
+		stream.write( reinterpret_cast< const char* >( levels.data() ), levels.size() * sizeof( CookedTextureLevel ) );
+		for ( unsigned int i = 0; i < levels.size(); i++ )
+		{
+			const std::streamoff padding = levels[i].Offset - stream.tellp();
+			for ( std::streamoff p = 0; p < padding; p++ )
+				stream.put( 0 );
+			stream.write( reinterpret_cast< const char* >( levelData[i].data() ), levelData[i].size() );
+		}
+
+		std::cout << "Cooked " << sourcePath << " -> " << cookedPath << " (" << width << "x" << height << ", "
+			<< levels.size() << " levels" << ( compress ? ", DXT5" : "" ) << ")" << std::endl;
+		return stream.good();
+	}
+
+	static const unsigned int TILE_BORDER = 2;
+
+	bool CookTiledImage( const std::string& sourcePath, const std::string& tiledPath, unsigned int tileSize )
+	{
+		const unsigned int stride = tileSize + 2 * TILE_BORDER;
+		if ( tileSize == 0 || stride % 4 != 0 )
+		{
+			std::cout << "Tile size " << tileSize << " does not give whole DXT5 blocks" << std::endl;
+			return false;
+		}
+
+		int width, height, bpp;
+		stbi_set_flip_vertically_on_load( 1 );
+		unsigned char* pixels = stbi_load( sourcePath.c_str(), &width, &height, &bpp, 4 );
+		if ( !pixels )
+		{
+			std::cout << "Failed to load " << sourcePath << ": " << stbi_failure_reason() << std::endl;
+			return false;
+		}
+
+		Image image;
+		image.Width = width;
+		image.Height = height;
+		image.Pixels.assign( pixels, pixels + (size_t) width * height * 4 );
+		stbi_image_free( pixels );
+
+		std::vector< TiledImageLevel > levels;
+		uint32_t tileCount = 0;
+		for ( unsigned int w = width, h = height; ; w = std::max( 1u, w / 2 ), h = std::max( 1u, h / 2 ) )
+		{
+			const uint32_t tilesX = ( w + tileSize - 1 ) / tileSize;
+			const uint32_t tilesY = ( h + tileSize - 1 ) / tileSize;
+			levels.push_back( { w, h, tilesX, tilesY, tileCount, 0 } );
+			tileCount += tilesX * tilesY;
+			if ( tilesX == 1 && tilesY == 1 )
+				break;
+		}
+
+		TiledImageHeader header;
+		std::copy_n( TILED_IMAGE_MAGIC, 4, header.Magic );
+		header.Version = TILED_IMAGE_VERSION;
+		header.Width = width;
+		header.Height = height;
+		header.TileSize = tileSize;
+		header.TileBorder = TILE_BORDER;
+		header.Levels = (uint32_t) levels.size();
+		header.Format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+
+		// Every tile compresses to the same size, so the table is known up front.
+		const uint32_t tileBytes = ( stride / 4 ) * ( stride / 4 ) * 16;
+		const uint64_t dataStart = sizeof( header ) + levels.size() * sizeof( TiledImageLevel ) + (uint64_t) tileCount * sizeof( TiledImageTile );
+		std::vector< TiledImageTile > tiles( tileCount );
+		for ( uint32_t i = 0; i < tileCount; i++ )
+			tiles[i] = { dataStart + (uint64_t) i * tileBytes, tileBytes, 0 };
+
+		std::ofstream stream( tiledPath, std::ios::binary | std::ios::trunc );
+		if ( !stream )
+		{
+			std::cout << "Failed to open " << tiledPath << " for writing" << std::endl;
+			return false;
+		}
+		stream.write( reinterpret_cast< const char* >( &header ), sizeof( header ) );
+		stream.write( reinterpret_cast< const char* >( levels.data() ), levels.size() * sizeof( TiledImageLevel ) );
+		stream.write( reinterpret_cast< const char* >( tiles.data() ), tiles.size() * sizeof( TiledImageTile ) );
+
+		Image tile;
+		tile.Width = stride;
+		tile.Height = stride;
+		tile.Pixels.resize( stride * stride * 4 );
+		for ( unsigned int level = 0; level < levels.size(); level++ )
+		{
+			if ( level > 0 )
+				image = Downsample( image );
+
+			for ( unsigned int ty = 0; ty < levels[level].TilesY; ty++ )
+			{
+				for ( unsigned int tx = 0; tx < levels[level].TilesX; tx++ )
+				{
+					// Pixels outside the image repeat the edge, like GL_CLAMP_TO_EDGE.
+					for ( unsigned int y = 0; y < stride; y++ )
+					{
+						const int sy = std::min( std::max( (int) ( ty * tileSize + y ) - (int) TILE_BORDER, 0 ), (int) image.Height - 1 );
+						for ( unsigned int x = 0; x < stride; x++ )
+						{
+							const int sx = std::min( std::max( (int) ( tx * tileSize + x ) - (int) TILE_BORDER, 0 ), (int) image.Width - 1 );
+							std::copy_n( &image.Pixels[( (size_t) sy * image.Width + sx ) * 4], 4, &tile.Pixels[( y * stride + x ) * 4] );
+						}
+					}
+					const std::vector< unsigned char > blocks = CompressDXT5( tile );
+					stream.write( reinterpret_cast< const char* >( blocks.data() ), blocks.size() );
+				}
+			}
+		}
+
+		std::cout << "Cooked " << sourcePath << " -> " << tiledPath << " (" << width << "x" << height << ", "
+			<< levels.size() << " levels, " << tileCount << " tiles)" << std::endl;
+		return stream.good();
+	}
+
+	unsigned int CookDirectory( const std::string& directory, bool compress )
+	{
+		namespace fs = std::filesystem;
+
+		std::error_code error;
+		unsigned int cooked = 0;
+		for ( const auto& entry : fs::directory_iterator( directory, error ) )
+		{
+			if ( !entry.is_regular_file() )
+				continue;
+
+			std::string extension = entry.path().extension().string();
+			std::transform( extension.begin(), extension.end(), extension.begin(), []( char c ) { return (char) std::tolower( c ); } );
+			if ( extension != ".png" && extension != ".jpg" && extension != ".tga" && extension != ".bmp" )
+				continue;
+
+			const std::string sourcePath = entry.path().string();
+			if ( CookTexture( sourcePath, CookedTexture::GetCookedPath( sourcePath ), compress ) )
+				cooked++;
+		}
+		if ( error )
+			std::cout << "Failed to list " << directory << ": " << error.message() << std::endl;
+		return cooked;
+	}
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string>
+
+// Offline conversion of source images into cooked textures (see CookedTexture.h).
+namespace cooker
+{
+	// Decodes, flips and mips "sourcePath", optionally compressing every level to DXT5.
+	bool CookTexture( const std::string& sourcePath, const std::string& cookedPath, bool compress );
+
+	// Cuts "sourcePath" into a DXT5 tiled image pyramid (see TiledImage.h).
+	// "tileSize" plus the border must be a multiple of 4.
+	bool CookTiledImage( const std::string& sourcePath, const std::string& tiledPath, unsigned int tileSize );
+
+	// Cooks every .png/.jpg/.tga/.bmp in "directory" next to its source. Returns the number of cooked files.
+	unsigned int CookDirectory( const std::string& directory, bool compress );
+}
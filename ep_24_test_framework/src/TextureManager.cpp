@@ -0,0 +1,178 @@
+#include "TextureManager.h"
+#include "Texture.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "imgui/imgui.h"
+
+static const size_t MEGABYTE = 1024 * 1024;
+
+TextureManager::TextureManager()
+	: m_BoundTextures{ nullptr }, m_ActiveUnit( 0 ), m_Budget( 256 * MEGABYTE ), m_ResidentSize( 0 ),
+	m_Frame( 0 ), m_Evictions( 0 ), m_Reloads( 0 )
+{
+}
+
+TextureManager& TextureManager::Get()
+{
+	static TextureManager manager;
+	return manager;
+}
+
+void TextureManager::BeginFrame()
+{
+	m_Frame++;
+	EnforceBudget();
+}
+
+void TextureManager::SetBudget( size_t bytes )
+{
+	m_Budget = bytes;
+	EnforceBudget();
+}
+
+void TextureManager::Register( Texture* texture )
+{
+	m_Entries.push_back( { texture, texture->GetMemorySize(), m_Frame } );
+	m_Lookup[texture] = std::prev( m_Entries.end() );
+	if ( texture->IsResident() )
+		m_ResidentSize += m_Entries.back().size;
+
+	EnforceBudget();
+}
+
+void TextureManager::Unregister( const Texture* texture )
+{
+	// Every unit, a texture at the same address later on must not look bound.
+	std::replace( std::begin( m_BoundTextures ), std::end( m_BoundTextures ), texture, static_cast< const Texture* >( nullptr ) );
+
+	auto it = m_Lookup.find( texture );
+	if ( it == m_Lookup.end() )
+		return;
+
+	if ( texture->IsResident() )
+		m_ResidentSize -= it->second->size;
+	m_Entries.erase( it->second );
+	m_Lookup.erase( it );
+}
+
+void TextureManager::OnMove( const Texture* from, Texture* to )
+{
+	auto it = m_Lookup.find( from );
+	if ( it == m_Lookup.end() )
+		return;
+
+	// Same entry and place in the LRU order, only the address changes.
+	const std::list< Entry >::iterator entry = it->second;
+	m_Lookup.erase( it );
+	entry->texture = to;
+	m_Lookup[to] = entry;
+	std::replace( std::begin( m_BoundTextures ), std::end( m_BoundTextures ), from, static_cast< const Texture* >( to ) );
+}
+
+void TextureManager::OnBind( const Texture* texture, unsigned int slot )
+{
+	m_ActiveUnit = slot;
+	auto it = m_Lookup.find( texture );
+	if ( it == m_Lookup.end() )
+		return;
+
+	// Move to the most recently used end.
+	Entry& entry = *it->second;
+	entry.lastUsedFrame = m_Frame;
+	m_Entries.splice( m_Entries.end(), m_Entries, it->second );
+
+	if ( !texture->IsResident() )
+		Restore( entry );
+	if ( slot < MAX_TEXTURE_UNITS )
+		m_BoundTextures[slot] = texture;
+
+	EnforceBudget();
+}
+
+void TextureManager::MakeResident( const Texture* texture )
+{
+	// The budget waits for the next frame, the caller is about to use the texture.
+	auto it = m_Lookup.find( texture );
+	if ( it != m_Lookup.end() && !texture->IsResident() )
+		Restore( *it->second );
+}
+
+void TextureManager::Restore( Entry& entry )
+{
+	entry.texture->Restore();
+	entry.size = entry.texture->GetMemorySize();
+	m_ResidentSize += entry.size;
+	m_Reloads++;
+}
+
+void TextureManager::OnUnbind( const Texture* texture )
+{
+	if ( m_ActiveUnit < MAX_TEXTURE_UNITS && m_BoundTextures[m_ActiveUnit] == texture )
+		m_BoundTextures[m_ActiveUnit] = nullptr;
+}
+
+bool TextureManager::IsBound( const Texture* texture ) const
+{
+	return std::find( std::begin( m_BoundTextures ), std::end( m_BoundTextures ), texture ) != std::end( m_BoundTextures );
+}
+
+void TextureManager::EnforceBudget()
+{
+	for ( auto it = m_Entries.begin(); it != m_Entries.end() && m_ResidentSize > m_Budget; ++it )
+	{
+		Texture* texture = it->texture;
+		// Bindless textures are used without ever being bound, so they are never known to be idle.
+		if ( it->lastUsedFrame == m_Frame || !texture->IsResident() || !texture->IsReloadable() || IsBound( texture ) || texture->HasBindlessHandle() )
+			continue;
+
+		texture->Evict();
+		m_ResidentSize -= it->size;
+		m_Evictions++;
+	}
+}
+
+void TextureManager::OnImGuiRender()
+{
+	if ( !ImGui::CollapsingHeader( "Texture residency" ) )
+		return;
+
+	int budget = (int) ( m_Budget / MEGABYTE );
+	if ( ImGui::SliderInt( "Budget (MB)", &budget, 1, 2048 ) )
+		SetBudget( (size_t) budget * MEGABYTE );
+
+	char overlay[64];
+	snprintf( overlay, sizeof( overlay ), "%.1f / %zu MB", (float) m_ResidentSize / MEGABYTE, m_Budget / MEGABYTE );
+	ImGui::ProgressBar( std::min( 1.0f, (float) m_ResidentSize / m_Budget ), ImVec2( -1, 0 ), overlay );
+	ImGui::Text( "%zu textures, %u evictions, %u reloads", m_Entries.size(), m_Evictions, m_Reloads );
+
+	ImGui::Columns( 4, "residency" );
+	ImGui::Text( "Texture" ); ImGui::NextColumn();
+	ImGui::Text( "Size" ); ImGui::NextColumn();
+	ImGui::Text( "State" ); ImGui::NextColumn();
+	ImGui::Text( "Idle frames" ); ImGui::NextColumn();
+	ImGui::Separator();
+	for ( auto it = m_Entries.rbegin(); it != m_Entries.rend(); ++it )
+	{
+		const Texture* texture = it->texture;
+		const std::string& path = texture->GetFilePath();
+		if ( path.empty() )
+			ImGui::Text( "%dx%d (memory)", texture->GetWidth(), texture->GetHeight() );
+		else
+			ImGui::Text( "%s", path.c_str() );
+		ImGui::NextColumn();
+		ImGui::Text( "%.2f MB", (float) it->size / MEGABYTE ); ImGui::NextColumn();
+		if ( !texture->IsResident() )
+			ImGui::TextColored( ImVec4( 0.6f, 0.6f, 0.6f, 1.0f ), "evicted" );
+		else if ( IsBound( texture ) )
+			ImGui::TextColored( ImVec4( 0.4f, 1.0f, 0.4f, 1.0f ), "bound" );
+		else if ( !texture->IsReloadable() )
+			ImGui::Text( "pinned" );
+		else
+			ImGui::Text( "resident" );
+		ImGui::NextColumn();
+		ImGui::Text( "%u", m_Frame - it->lastUsedFrame ); ImGui::NextColumn();
+	}
+	ImGui::Columns( 1 );
+}
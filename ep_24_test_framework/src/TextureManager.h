@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+
+class Texture;
+
+// Tracks the estimated video memory of every texture and keeps the total under a
+// budget by evicting the least recently used ones. File backed textures are the
+// only ones that can be evicted, they reload from disk on their next Bind.
+class TextureManager
+{
+private:
+	static const unsigned int MAX_TEXTURE_UNITS = 32;
+
+	struct Entry
+	{
+		Texture* texture;
+		size_t size;
+		unsigned int lastUsedFrame;
+	};
+
+	// Least recently used first.
+	std::list< Entry > m_Entries;
+	std::unordered_map< const Texture*, std::list< Entry >::iterator > m_Lookup;
+	const Texture* m_BoundTextures[MAX_TEXTURE_UNITS];
+	unsigned int m_ActiveUnit;
+
+	size_t m_Budget;
+	size_t m_ResidentSize;
+	unsigned int m_Frame;
+	unsigned int m_Evictions;
+	unsigned int m_Reloads;
+
+	TextureManager();
+
+public:
+	static TextureManager& Get();
+
+	// Marks the start of a frame, textures used during the current frame are never evicted.
+	void BeginFrame();
+
+	void SetBudget( size_t bytes );
+	inline size_t GetBudget() const { return m_Budget; }
+	inline size_t GetResidentSize() const { return m_ResidentSize; }
+
+	void OnImGuiRender();
+
+private:
+	friend class Texture;
+
+	void Register( Texture* texture );
+	void Unregister( const Texture* texture );
+	void OnMove( const Texture* from, Texture* to );
+	void OnBind( const Texture* texture, unsigned int slot );
+	void OnUnbind( const Texture* texture );
+	// Reloads "texture" if it was evicted, without binding it or counting it as used.
+	void MakeResident( const Texture* texture );
+	void Restore( Entry& entry );
+	void EnforceBudget();
+	bool IsBound( const Texture* texture ) const;
+};
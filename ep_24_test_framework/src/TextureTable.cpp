@@ -0,0 +1,198 @@
+#include "TextureTable.h"
+#include "Texture.h"
+#include "Shader.h"
+#include "Renderer.h"
+#include "Debug.h"
+
+#include <algorithm>
+#include <cmath>
+
+TextureTable::TextureTable( unsigned int capacity, int layerWidth, int layerHeight, bool preferBindless )
+	: m_Bindless( preferBindless && IsBindlessSupported() ), m_Capacity( std::max( 1u, capacity ) ), m_Count( 0 ), m_Dirty( false ),
+	m_HandleBuffer( 0 ), m_ArrayTexture( 0 ), m_LayerWidth( layerWidth ), m_LayerHeight( layerHeight ), m_Levels( 1 ),
+	m_CopyFrameBuffers{ 0 }
+{
+	if ( m_Bindless )
+	{
+		// Handles are packed two per uvec4, std140 pads every array element to 16 bytes.
+		int maxBlockSize;
+		GLCall( glGetIntegerv( GL_MAX_UNIFORM_BLOCK_SIZE, &maxBlockSize ) );
+		m_Capacity = std::min( ( m_Capacity + 1 ) & ~1u, (unsigned int) maxBlockSize / (unsigned int) sizeof( uint64_t ) );
+		m_Handles.assign( m_Capacity, 0 );
+
+		GLCall( glGenBuffers( 1, &m_HandleBuffer ) );
+		GLCall( glBindBuffer( GL_UNIFORM_BUFFER, m_HandleBuffer ) );
+		GLCall( glBufferData( GL_UNIFORM_BUFFER, m_Capacity * sizeof( uint64_t ), m_Handles.data(), GL_DYNAMIC_DRAW ) );
+		GLCall( glBindBuffer( GL_UNIFORM_BUFFER, 0 ) );
+		return;
+	}
+
+	int maxLayers;
+	GLCall( glGetIntegerv( GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers ) );
+	m_Capacity = std::min( m_Capacity, (unsigned int) maxLayers );
+	m_Levels = (unsigned int) std::floor( std::log2( (float) std::max( layerWidth, layerHeight ) ) ) + 1;
+
+	if ( Renderer::IsDirectStateAccessSupported() )
+	{
+		GLCall( glCreateTextures( GL_TEXTURE_2D_ARRAY, 1, &m_ArrayTexture ) );
+		GLCall( glTextureParameteri( m_ArrayTexture, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR ) );
+		GLCall( glTextureParameteri( m_ArrayTexture, GL_TEXTURE_MAG_FILTER, GL_LINEAR ) );
+		GLCall( glTextureParameteri( m_ArrayTexture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE ) );
+		GLCall( glTextureParameteri( m_ArrayTexture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE ) );
+		GLCall( glTextureStorage3D( m_ArrayTexture, m_Levels, GL_RGBA8, layerWidth, layerHeight, m_Capacity ) );
+		GLCall( glCreateFramebuffers( 2, m_CopyFrameBuffers ) );
+		return;
+	}
+
+	GLCall( glGenTextures( 1, &m_ArrayTexture ) );
+	GLCall( glBindTexture( GL_TEXTURE_2D_ARRAY, m_ArrayTexture ) );
+	GLCall( glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR ) );
+	GLCall( glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR ) );
+	GLCall( glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE ) );
+	GLCall( glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE ) );
+	if ( GLEW_ARB_texture_storage )
+	{
+		GLCall( glTexStorage3D( GL_TEXTURE_2D_ARRAY, m_Levels, GL_RGBA8, layerWidth, layerHeight, m_Capacity ) );
+	}
+	else
+	{
+		for ( unsigned int i = 0; i < m_Levels; i++ )
+		{
+			GLCall( glTexImage3D( GL_TEXTURE_2D_ARRAY, i, GL_RGBA8, std::max( 1, layerWidth >> i ), std::max( 1, layerHeight >> i ), m_Capacity, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr ) );
+		}
+		GLCall( glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, m_Levels - 1 ) );
+	}
+	GLCall( glBindTexture( GL_TEXTURE_2D_ARRAY, 0 ) );
+
+	GLCall( glGenFramebuffers( 2, m_CopyFrameBuffers ) );
+}
+
+TextureTable::~TextureTable()
+{
+	Clear();
+	if ( m_HandleBuffer )
+	{
+		GLCall( glDeleteBuffers( 1, &m_HandleBuffer ) );
+	}
+	if ( m_ArrayTexture )
+	{
+		GLCall( glDeleteTextures( 1, &m_ArrayTexture ) );
+	}
+	if ( m_CopyFrameBuffers[0] )
+	{
+		GLCall( glDeleteFramebuffers( 2, m_CopyFrameBuffers ) );
+	}
+}
+
+bool TextureTable::IsBindlessSupported()
+{
+	return GLEW_ARB_bindless_texture;
+}
+
+int TextureTable::Add( Texture& texture )
+{
+	if ( m_Count == m_Capacity )
+	{
+		std::cout << "Texture table is full (" << m_Capacity << " textures)" << std::endl;
+		return -1;
+	}
+
+	if ( m_Bindless )
+	{
+		m_Handles[m_Count] = texture.GetBindlessHandle();
+		m_Textures.push_back( &texture );
+	}
+	else if ( !CopyToLayer( texture, m_Count ) )
+	{
+		return -1;
+	}
+
+	m_Dirty = true;
+	return (int) m_Count++;
+}
+
+void TextureTable::Clear()
+{
+	for ( Texture* texture : m_Textures )
+		texture->ReleaseBindlessHandle();
+	m_Textures.clear();
+	std::fill( m_Handles.begin(), m_Handles.end(), 0 );
+	m_Count = 0;
+	m_Dirty = true;
+}
+
+bool TextureTable::CopyToLayer( const Texture& texture, unsigned int layer )
+{
+	if ( texture.GetInternalFormat() == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT )
+	{
+		std::cout << "Compressed texture " << texture.GetFilePath() << " can not be copied into a texture array" << std::endl;
+		return false;
+	}
+
+	texture.MakeResident();
+
+	// Same size and format is a plain copy, without framebuffers.
+	if ( texture.GetWidth() == m_LayerWidth && texture.GetHeight() == m_LayerHeight && texture.GetInternalFormat() == GL_RGBA8
+		 && ( GLEW_VERSION_4_3 || GLEW_ARB_copy_image ) )
+	{
+		GLCall( glCopyImageSubData( texture.GetRendererID(), GL_TEXTURE_2D, 0, 0, 0, 0,
+									m_ArrayTexture, GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, m_LayerWidth, m_LayerHeight, 1 ) );
+		return true;
+	}
+
+	// A blit scales and converts, so any color texture fits any layer.
+	if ( Renderer::IsDirectStateAccessSupported() )
+	{
+		GLCall( glNamedFramebufferTexture( m_CopyFrameBuffers[0], GL_COLOR_ATTACHMENT0, texture.GetRendererID(), 0 ) );
+		GLCall( glNamedFramebufferTextureLayer( m_CopyFrameBuffers[1], GL_COLOR_ATTACHMENT0, m_ArrayTexture, 0, layer ) );
+		GLCall( glBlitNamedFramebuffer( m_CopyFrameBuffers[0], m_CopyFrameBuffers[1], 0, 0, texture.GetWidth(), texture.GetHeight(),
+										0, 0, m_LayerWidth, m_LayerHeight, GL_COLOR_BUFFER_BIT, GL_LINEAR ) );
+		return true;
+	}
+
+	GLCall( glBindFramebuffer( GL_READ_FRAMEBUFFER, m_CopyFrameBuffers[0] ) );
+	GLCall( glFramebufferTexture2D( GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture.GetRendererID(), 0 ) );
+	GLCall( glBindFramebuffer( GL_DRAW_FRAMEBUFFER, m_CopyFrameBuffers[1] ) );
+	GLCall( glFramebufferTextureLayer( GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_ArrayTexture, 0, layer ) );
+	GLCall( glBlitFramebuffer( 0, 0, texture.GetWidth(), texture.GetHeight(), 0, 0, m_LayerWidth, m_LayerHeight, GL_COLOR_BUFFER_BIT, GL_LINEAR ) );
+	GLCall( glBindFramebuffer( GL_FRAMEBUFFER, 0 ) );
+	return true;
+}
+
+void TextureTable::Bind( Shader& shader, unsigned int binding, unsigned int slot )
+{
+	shader.Bind();
+	if ( m_Bindless )
+	{
+		GLCall( glBindBuffer( GL_UNIFORM_BUFFER, m_HandleBuffer ) );
+		if ( m_Dirty )
+		{
+			GLCall( glBufferSubData( GL_UNIFORM_BUFFER, 0, m_Count * sizeof( uint64_t ), m_Handles.data() ) );
+		}
+		GLCall( glBindBufferBase( GL_UNIFORM_BUFFER, binding, m_HandleBuffer ) );
+		shader.SetUniformBlockBinding( "TextureHandles", binding );
+	}
+	else
+	{
+		GLCall( glActiveTexture( GL_TEXTURE0 + slot ) );
+		GLCall( glBindTexture( GL_TEXTURE_2D_ARRAY, m_ArrayTexture ) );
+		if ( m_Dirty && Renderer::IsDirectStateAccessSupported() )
+		{
+			GLCall( glGenerateTextureMipmap( m_ArrayTexture ) );
+		}
+		else if ( m_Dirty )
+		{
+			GLCall( glGenerateMipmap( GL_TEXTURE_2D_ARRAY ) );
+		}
+		shader.SetUniform1i( "u_Textures", slot );
+	}
+	m_Dirty = false;
+}
+
+std::vector< std::string > TextureTable::GetShaderDefines() const
+{
+	std::vector< std::string > defines = { "MAX_TEXTURES " + std::to_string( m_Capacity ) };
+	if ( m_Bindless )
+		defines.push_back( "BINDLESS" );
+	return defines;
+}
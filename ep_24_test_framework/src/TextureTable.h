@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Texture;
+class Shader;
+
+// Set of textures a shader indexes per vertex or per instance, so one draw call is
+// not limited to the number of texture units.
+//
+// With ARB_bindless_texture every texture's resident handle goes into a uniform
+// buffer (block "TextureHandles"). Without it the textures are copied into the
+// layers of a 2D array texture ("u_Textures") and scaled to the layer size.
+// Shaders handle both with #ifdef BINDLESS, see res/shaders/Batch.shader and
+// GetShaderDefines().
+//
+// In bindless mode the table keeps the handles resident until it is cleared or
+// destroyed, so the textures must outlive it.
+class TextureTable
+{
+private:
+	bool m_Bindless;
+	unsigned int m_Capacity;
+	unsigned int m_Count;
+	bool m_Dirty;
+
+	// Bindless mode.
+	unsigned int m_HandleBuffer;
+	std::vector< uint64_t > m_Handles;
+	std::vector< Texture* > m_Textures;
+
+	// Array mode.
+	unsigned int m_ArrayTexture;
+	int m_LayerWidth, m_LayerHeight;
+	unsigned int m_Levels;
+	unsigned int m_CopyFrameBuffers[2];
+
+public:
+	// "layerWidth" and "layerHeight" are only used by the texture array fallback.
+	TextureTable( unsigned int capacity, int layerWidth, int layerHeight, bool preferBindless = true );
+	~TextureTable();
+
+	TextureTable( const TextureTable& ) = delete;
+	TextureTable& operator=( const TextureTable& ) = delete;
+
+	static bool IsBindlessSupported();
+
+	// Returns the index shaders use to sample "texture", or -1 when the table is full.
+	int Add( Texture& texture );
+	// Removes every texture, their bindless handles are made non-resident.
+	void Clear();
+
+	// Binds the handle buffer to "binding" or the array texture to "slot" and points "shader" at it.
+	void Bind( Shader& shader, unsigned int binding = 0, unsigned int slot = 0 );
+
+	inline bool IsBindless() const { return m_Bindless; }
+	inline unsigned int GetCount() const { return m_Count; }
+	inline unsigned int GetCapacity() const { return m_Capacity; }
+
+	// Defines a shader built for this table needs (BINDLESS, MAX_TEXTURES).
+	std::vector< std::string > GetShaderDefines() const;
+
+private:
+	bool CopyToLayer( const Texture& texture, unsigned int layer );
+};
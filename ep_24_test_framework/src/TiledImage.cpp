@@ -0,0 +1,79 @@
+#include "TiledImage.h"
+
+#include <GL/glew.h>
+#include <cstring>
+#include <iostream>
+
+TiledImage::TiledImage( const std::string& path )
+	: m_File( path ), m_Header( nullptr ), m_Levels( nullptr ), m_Tiles( nullptr )
+{
+	if ( !m_File.IsOpen() )
+	{
+		std::cout << "Failed to open tiled image " << path << std::endl;
+		return;
+	}
+
+	if ( !Validate() )
+	{
+		std::cout << "Invalid tiled image " << path << std::endl;
+		return;
+	}
+
+	m_Header = reinterpret_cast< const TiledImageHeader* >( m_File.GetData() );
+	m_Levels = reinterpret_cast< const TiledImageLevel* >( m_File.GetData() + sizeof( TiledImageHeader ) );
+	m_Tiles = reinterpret_cast< const TiledImageTile* >( m_Levels + m_Header->Levels );
+}
+
+const TiledImageTile& TiledImage::GetTile( unsigned int level, unsigned int x, unsigned int y ) const
+{
+	const TiledImageLevel& info = m_Levels[level];
+	return m_Tiles[info.FirstTile + y * info.TilesX + x];
+}
+
+const unsigned char* TiledImage::GetTileData( unsigned int level, unsigned int x, unsigned int y ) const
+{
+	return m_File.GetData() + GetTile( level, x, y ).Offset;
+}
+
+bool TiledImage::Validate() const
+{
+	const size_t size = m_File.GetSize();
+	if ( size < sizeof( TiledImageHeader ) )
+		return false;
+
+	const TiledImageHeader* header = reinterpret_cast< const TiledImageHeader* >( m_File.GetData() );
+	if ( std::memcmp( header->Magic, TILED_IMAGE_MAGIC, sizeof( TILED_IMAGE_MAGIC ) ) != 0
+		 || header->Version != TILED_IMAGE_VERSION
+		 || header->Format != GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+		 || header->Levels == 0 || header->Levels > 32
+		 || header->TileSize == 0 || ( header->TileSize + 2 * header->TileBorder ) % 4 != 0 )
+		return false;
+
+	const size_t levelsEnd = sizeof( TiledImageHeader ) + header->Levels * sizeof( TiledImageLevel );
+	if ( size < levelsEnd )
+		return false;
+
+	const TiledImageLevel* levels = reinterpret_cast< const TiledImageLevel* >( m_File.GetData() + sizeof( TiledImageHeader ) );
+	size_t tileCount = 0;
+	for ( unsigned int i = 0; i < header->Levels; i++ )
+	{
+		if ( levels[i].FirstTile != tileCount || levels[i].TilesX == 0 || levels[i].TilesY == 0 )
+			return false;
+		tileCount += (size_t) levels[i].TilesX * levels[i].TilesY;
+	}
+
+	const size_t tablesEnd = levelsEnd + tileCount * sizeof( TiledImageTile );
+	if ( size < tablesEnd )
+		return false;
+
+	// Every tile is a whole square of DXT5 blocks, TiledTexture decodes that much.
+	const size_t stride = header->TileSize + 2 * header->TileBorder;
+	const size_t tileSize = ( stride / 4 ) * ( stride / 4 ) * 16;
+	const TiledImageTile* tiles = reinterpret_cast< const TiledImageTile* >( m_File.GetData() + levelsEnd );
+	for ( size_t i = 0; i < tileCount; i++ )
+	{
+		if ( tiles[i].Size != tileSize || tiles[i].Offset < tablesEnd || tiles[i].Offset + tiles[i].Size > size )
+			return false;
+	}
+	return true;
+}
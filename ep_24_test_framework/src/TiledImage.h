@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+#include "MappedFile.h"
+
+// Layout of a tiled image pyramid (.tiles) file:
+// [TiledImageHeader][TiledImageLevel x Levels][TiledImageTile x tiles of all levels][tile data...]
+// Every level is cut into TileSize x TileSize tiles, stored with TileBorder pixels
+// copied from their neighbours on each side so tiles can be filtered in isolation.
+// Tiles are DXT5 blocks, flipped for OpenGL like cooked textures, so tile (0, 0) is
+// the bottom left one. The last level is the first one that fits in a single tile.
+struct TiledImageHeader
+{
+	char Magic[4];
+	uint32_t Version;
+	uint32_t Width;
+	uint32_t Height;
+	uint32_t TileSize;
+	uint32_t TileBorder;
+	uint32_t Levels;
+	uint32_t Format; // GL_COMPRESSED_RGBA_S3TC_DXT5_EXT.
+};
+
+struct TiledImageLevel
+{
+	uint32_t Width;
+	uint32_t Height;
+	uint32_t TilesX;
+	uint32_t TilesY;
+	uint32_t FirstTile; // Index of tile (0, 0) in the tile table.
+	uint32_t Padding; // Keeps the tile table 8 byte aligned.
+};
+
+struct TiledImageTile
+{
+	uint64_t Offset; // From the beginning of the file.
+	uint32_t Size;
+	uint32_t Padding;
+};
+
+static const char TILED_IMAGE_MAGIC[4] = { 'T', 'I', 'L', 'E' };
+static const uint32_t TILED_IMAGE_VERSION = 1;
+
+class TiledImage
+{
+private:
+	MappedFile m_File;
+	const TiledImageHeader* m_Header;
+	const TiledImageLevel* m_Levels;
+	const TiledImageTile* m_Tiles;
+
+public:
+	TiledImage( const std::string& path );
+
+	inline bool IsValid() const { return m_Header != nullptr; }
+
+	inline const TiledImageHeader& GetHeader() const { return *m_Header; }
+	inline const TiledImageLevel& GetLevel( unsigned int level ) const { return m_Levels[level]; }
+	inline unsigned int GetTileStride() const { return m_Header->TileSize + 2 * m_Header->TileBorder; }
+
+	const TiledImageTile& GetTile( unsigned int level, unsigned int x, unsigned int y ) const;
+	const unsigned char* GetTileData( unsigned int level, unsigned int x, unsigned int y ) const;
+
+private:
+	bool Validate() const;
+};
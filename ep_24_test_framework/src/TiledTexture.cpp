@@ -0,0 +1,470 @@
+#include "TiledTexture.h"
+#include "Shader.h"
+#include "Debug.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Expands one DXT5 block into 4x4 RGBA8 pixels written with "pitch" bytes per row.
+static void DecodeBlockDXT5( const unsigned char* block, unsigned char* out, unsigned int pitch )
+{
+	unsigned int alpha[8] = { block[0], block[1] };
+	if ( alpha[0] > alpha[1] )
+	{
+		for ( unsigned int i = 1; i < 7; i++ )
+			alpha[i + 1] = ( ( 7 - i ) * alpha[0] + i * alpha[1] ) / 7;
+	}
+	else
+	{
+		for ( unsigned int i = 1; i < 5; i++ )
+			alpha[i + 1] = ( ( 5 - i ) * alpha[0] + i * alpha[1] ) / 5;
+		alpha[6] = 0;
+		alpha[7] = 255;
+	}
+	unsigned long long alphaBits = 0;
+	for ( unsigned int i = 0; i < 6; i++ )
+		alphaBits |= (unsigned long long) block[2 + i] << ( 8 * i );
+
+	unsigned int colors[4][3];
+	const unsigned int color0 = block[8] | ( block[9] << 8 );
+	const unsigned int color1 = block[10] | ( block[11] << 8 );
+	for ( unsigned int i = 0; i < 2; i++ )
+	{
+		const unsigned int packed = i == 0 ? color0 : color1;
+		const unsigned int r = ( packed >> 11 ) & 31, g = ( packed >> 5 ) & 63, b = packed & 31;
+		colors[i][0] = ( r << 3 ) | ( r >> 2 );
+		colors[i][1] = ( g << 2 ) | ( g >> 4 );
+		colors[i][2] = ( b << 3 ) | ( b >> 2 );
+	}
+	for ( unsigned int c = 0; c < 3; c++ )
+	{
+		if ( color0 > color1 )
+		{
+			colors[2][c] = ( 2 * colors[0][c] + colors[1][c] ) / 3;
+			colors[3][c] = ( colors[0][c] + 2 * colors[1][c] ) / 3;
+		}
+		else
+		{
+			colors[2][c] = ( colors[0][c] + colors[1][c] ) / 2;
+			colors[3][c] = 0;
+		}
+	}
+	const unsigned int colorBits = block[12] | ( block[13] << 8 ) | ( block[14] << 16 ) | ( (unsigned int) block[15] << 24 );
+
+	for ( unsigned int i = 0; i < 16; i++ )
+	{
+		unsigned char* pixel = out + ( i / 4 ) * pitch + ( i % 4 ) * 4;
+		const unsigned int* color = colors[( colorBits >> ( 2 * i ) ) & 3];
+		pixel[0] = (unsigned char) color[0];
+		pixel[1] = (unsigned char) color[1];
+		pixel[2] = (unsigned char) color[2];
+		pixel[3] = (unsigned char) alpha[( alphaBits >> ( 3 * i ) ) & 7];
+	}
+}
+
+TiledTexture::TiledTexture( const std::string& path, unsigned int atlasSlots, int feedbackWidth, int feedbackHeight, unsigned int workerCount )
+	: m_Image( path ), m_Compressed( false ), m_SlotsPerSide( atlasSlots ), m_PageTableDirty( true ),
+	m_Frame( 0 ), m_FeedbackFrame( 0 ), m_Uploads( 0 ),
+	m_FeedbackPixelBuffers{ 0 }, m_FeedbackFences{ nullptr }, m_FeedbackIndex( 0 ), m_SavedViewport{ 0 }, m_FeedbackLodBias( 0.0f ),
+	m_Stop( false )
+{
+	if ( !m_Image.IsValid() )
+		return;
+
+	const TiledImageHeader& header = m_Image.GetHeader();
+	const unsigned int stride = m_Image.GetTileStride();
+
+	// Without S3TC support the workers decode tiles to RGBA8.
+	m_Compressed = GLEW_EXT_texture_compression_s3tc;
+
+	int maxTextureSize;
+	GLCall( glGetIntegerv( GL_MAX_TEXTURE_SIZE, &maxTextureSize ) );
+	// Page table entries store slot coordinates in 8 bits.
+	m_SlotsPerSide = std::max( 1u, std::min( { m_SlotsPerSide, (unsigned int) maxTextureSize / stride, 255u } ) );
+	const int atlasSize = m_SlotsPerSide * stride;
+	m_Atlas = std::make_unique< Texture >( atlasSize, atlasSize, m_Compressed ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_RGBA8 );
+	m_Slots.assign( m_SlotsPerSide * m_SlotsPerSide, { NO_TILE, 0, false } );
+
+	// All levels stacked vertically, level 0 at the bottom.
+	int pageTableHeight = 0;
+	for ( unsigned int level = 0; level < header.Levels; level++ )
+	{
+		m_LevelOffsets.push_back( pageTableHeight );
+		pageTableHeight += m_Image.GetLevel( level ).TilesY;
+	}
+	const int pageTableWidth = m_Image.GetLevel( 0 ).TilesX;
+	m_PageEntries.assign( (size_t) pageTableWidth * pageTableHeight * 4, 0 );
+	m_PageTable = std::make_unique< Texture >( pageTableWidth, pageTableHeight, GL_RGBA8UI );
+
+	m_FeedbackTexture = std::make_unique< Texture >( feedbackWidth, feedbackHeight, GL_RGBA16UI );
+	m_FeedbackBuffer = std::make_unique< FrameBuffer >( *m_FeedbackTexture );
+	GLCall( glGenBuffers( FEEDBACK_BUFFER_COUNT, m_FeedbackPixelBuffers ) );
+	for ( unsigned int i = 0; i < FEEDBACK_BUFFER_COUNT; i++ )
+	{
+		GLCall( glBindBuffer( GL_PIXEL_PACK_BUFFER, m_FeedbackPixelBuffers[i] ) );
+		GLCall( glBufferData( GL_PIXEL_PACK_BUFFER, (GLsizeiptr) feedbackWidth * feedbackHeight * 4 * sizeof( unsigned short ), nullptr, GL_STREAM_READ ) );
+	}
+	GLCall( glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 ) );
+
+	// The coarsest level is always resident so every lookup has something to fall back to.
+	const unsigned int top = header.Levels - 1;
+	for ( unsigned int y = 0; y < m_Image.GetLevel( top ).TilesY; y++ )
+	{
+		for ( unsigned int x = 0; x < m_Image.GetLevel( top ).TilesX; x++ )
+		{
+			const uint64_t tile = MakeTile( top, x, y );
+			UploadTile( tile, DecodeTile( tile ), true );
+		}
+	}
+	RebuildPageTable();
+
+	for ( unsigned int i = 0; i < std::max( 1u, workerCount ); i++ )
+		m_Workers.emplace_back( &TiledTexture::WorkerMain, this );
+}
+
+TiledTexture::~TiledTexture()
+{
+	{
+		std::lock_guard< std::mutex > lock( m_Mutex );
+		m_Stop = true;
+	}
+	m_Condition.notify_all();
+	for ( auto& worker : m_Workers )
+		worker.join();
+
+	for ( unsigned int i = 0; i < FEEDBACK_BUFFER_COUNT; i++ )
+	{
+		if ( m_FeedbackFences[i] )
+		{
+			GLCall( glDeleteSync( m_FeedbackFences[i] ) );
+		}
+	}
+	if ( m_FeedbackPixelBuffers[0] )
+	{
+		GLCall( glDeleteBuffers( FEEDBACK_BUFFER_COUNT, m_FeedbackPixelBuffers ) );
+	}
+}
+
+uint64_t TiledTexture::MakeTile( unsigned int level, unsigned int x, unsigned int y )
+{
+	return ( (uint64_t) level << 48 ) | ( (uint64_t) y << 24 ) | x;
+}
+
+void TiledTexture::SplitTile( uint64_t tile, unsigned int& level, unsigned int& x, unsigned int& y )
+{
+	level = (unsigned int) ( tile >> 48 );
+	y = (unsigned int) ( tile >> 24 ) & 0xFFFFFF;
+	x = (unsigned int) tile & 0xFFFFFF;
+}
+
+std::vector< unsigned char > TiledTexture::DecodeTile( uint64_t tile ) const
+{
+	unsigned int level, x, y;
+	SplitTile( tile, level, x, y );
+	const unsigned char* blocks = m_Image.GetTileData( level, x, y );
+	const unsigned int size = m_Image.GetTile( level, x, y ).Size;
+
+	// Copying faults the tile's pages in here rather than on the render thread.
+	if ( m_Compressed )
+		return std::vector< unsigned char >( blocks, blocks + size );
+
+	const unsigned int stride = m_Image.GetTileStride();
+	std::vector< unsigned char > pixels( stride * stride * 4 );
+	for ( unsigned int by = 0; by < stride / 4; by++ )
+	{
+		for ( unsigned int bx = 0; bx < stride / 4; bx++ )
+			DecodeBlockDXT5( blocks + ( by * ( stride / 4 ) + bx ) * 16, &pixels[( by * 4 * stride + bx * 4 ) * 4], stride * 4 );
+	}
+	return pixels;
+}
+
+void TiledTexture::WorkerMain()
+{
+	while ( true )
+	{
+		uint64_t tile;
+		{
+			std::unique_lock< std::mutex > lock( m_Mutex );
+			m_Condition.wait( lock, [this] { return m_Stop || !m_Queue.empty(); } );
+			if ( m_Stop )
+				return;
+			tile = m_Queue.front();
+			m_Queue.pop_front();
+		}
+
+		std::vector< unsigned char > data = DecodeTile( tile );
+
+		std::lock_guard< std::mutex > lock( m_Mutex );
+		m_Decoded.push_back( { tile, std::move( data ) } );
+	}
+}
+
+void TiledTexture::Update()
+{
+	if ( !IsValid() )
+		return;
+
+	m_Frame++;
+	ReadFeedback();
+	UploadDecodedTiles();
+	if ( m_PageTableDirty )
+		RebuildPageTable();
+}
+
+void TiledTexture::BeginFeedback()
+{
+	GLCall( glGetIntegerv( GL_VIEWPORT, m_SavedViewport ) );
+	// The feedback buffer is smaller than the viewport, which makes its derivatives larger.
+	m_FeedbackLodBias = -std::log2( (float) m_SavedViewport[2] / m_FeedbackBuffer->GetWidth() );
+
+	m_FeedbackBuffer->Bind();
+	const GLuint clear[4] = { 0, 0, 0, 0 };
+	GLCall( glClearBufferuiv( GL_COLOR, 0, clear ) );
+}
+
+void TiledTexture::EndFeedback()
+{
+	// Read back asynchronously, the result is picked up by a later Update.
+	const unsigned int index = m_FeedbackIndex;
+	m_FeedbackIndex = ( m_FeedbackIndex + 1 ) % FEEDBACK_BUFFER_COUNT;
+	if ( m_FeedbackFences[index] )
+	{
+		GLCall( glDeleteSync( m_FeedbackFences[index] ) );
+	}
+
+	GLCall( glBindBuffer( GL_PIXEL_PACK_BUFFER, m_FeedbackPixelBuffers[index] ) );
+	GLCall( glReadPixels( 0, 0, m_FeedbackBuffer->GetWidth(), m_FeedbackBuffer->GetHeight(), GL_RGBA_INTEGER, GL_UNSIGNED_SHORT, nullptr ) );
+	GLCall( m_FeedbackFences[index] = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 ) );
+	GLCall( glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 ) );
+
+	m_FeedbackBuffer->Unbind();
+	GLCall( glViewport( m_SavedViewport[0], m_SavedViewport[1], m_SavedViewport[2], m_SavedViewport[3] ) );
+}
+
+void TiledTexture::ReadFeedback()
+{
+	// Oldest readback first, skipping any the GPU has not finished yet.
+	for ( unsigned int i = 0; i < FEEDBACK_BUFFER_COUNT; i++ )
+	{
+		const unsigned int index = ( m_FeedbackIndex + i ) % FEEDBACK_BUFFER_COUNT;
+		if ( !m_FeedbackFences[index] )
+			continue;
+
+		GLCall( GLenum status = glClientWaitSync( m_FeedbackFences[index], 0, 0 ) );
+		if ( status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED )
+			continue;
+		GLCall( glDeleteSync( m_FeedbackFences[index] ) );
+		m_FeedbackFences[index] = nullptr;
+
+		const size_t count = (size_t) m_FeedbackBuffer->GetWidth() * m_FeedbackBuffer->GetHeight();
+		GLCall( glBindBuffer( GL_PIXEL_PACK_BUFFER, m_FeedbackPixelBuffers[index] ) );
+		GLCall( const void* texels = glMapBufferRange( GL_PIXEL_PACK_BUFFER, 0, count * 4 * sizeof( unsigned short ), GL_MAP_READ_BIT ) );
+		if ( texels )
+		{
+			ProcessFeedback( static_cast< const unsigned short* >( texels ), count );
+			GLCall( glUnmapBuffer( GL_PIXEL_PACK_BUFFER ) );
+		}
+		GLCall( glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 ) );
+	}
+}
+
+void TiledTexture::ProcessFeedback( const unsigned short* texels, size_t count )
+{
+	const unsigned int levels = m_Image.GetHeader().Levels;
+
+	m_Requested.clear();
+	for ( size_t i = 0; i < count; i++ )
+	{
+		const unsigned short* texel = texels + i * 4;
+		if ( texel[3] == 0 || texel[2] >= levels )
+			continue;
+
+		const TiledImageLevel& level = m_Image.GetLevel( texel[2] );
+		if ( texel[0] < level.TilesX && texel[1] < level.TilesY )
+			m_Requested.push_back( MakeTile( texel[2], texel[0], texel[1] ) );
+	}
+	std::sort( m_Requested.begin(), m_Requested.end() );
+	m_Requested.erase( std::unique( m_Requested.begin(), m_Requested.end() ), m_Requested.end() );
+	m_FeedbackFrame = m_Frame;
+
+	ScheduleRequests();
+}
+
+void TiledTexture::ScheduleRequests()
+{
+	// Ancestors serve as fallbacks while a tile streams in, so they are needed too.
+	std::vector< uint64_t > needed;
+	for ( uint64_t tile : m_Requested )
+	{
+		unsigned int level, x, y;
+		SplitTile( tile, level, x, y );
+		while ( true )
+		{
+			needed.push_back( MakeTile( level, x, y ) );
+			if ( ++level >= m_Image.GetHeader().Levels )
+				break;
+			// Levels are not always exact halves, e.g. 3 tiles above a level of 1.
+			const TiledImageLevel& parent = m_Image.GetLevel( level );
+			x = std::min( x / 2, parent.TilesX - 1 );
+			y = std::min( y / 2, parent.TilesY - 1 );
+		}
+	}
+	// Coarsest level first, its tiles cover the most screen space.
+	std::sort( needed.begin(), needed.end(), []( uint64_t a, uint64_t b ) { return a > b; } );
+	needed.erase( std::unique( needed.begin(), needed.end() ), needed.end() );
+
+	for ( uint64_t tile : needed )
+	{
+		auto resident = m_Resident.find( tile );
+		if ( resident != m_Resident.end() )
+			m_Slots[resident->second].LastUsedFrame = m_Frame;
+	}
+
+	{
+		std::lock_guard< std::mutex > lock( m_Mutex );
+		// Requests nobody has started on are dropped and queued again if still needed.
+		for ( uint64_t tile : m_Queue )
+			m_Pending.erase( tile );
+		m_Queue.clear();
+
+		for ( uint64_t tile : needed )
+		{
+			if ( m_Resident.count( tile ) == 0 && m_Pending.insert( tile ).second )
+				m_Queue.push_back( tile );
+		}
+	}
+	m_Condition.notify_all();
+}
+
+void TiledTexture::UploadDecodedTiles()
+{
+	std::vector< DecodedTile > decoded;
+	{
+		std::lock_guard< std::mutex > lock( m_Mutex );
+		const size_t count = std::min< size_t >( m_Decoded.size(), MAX_UPLOADS_PER_FRAME );
+		decoded.assign( std::make_move_iterator( m_Decoded.begin() ), std::make_move_iterator( m_Decoded.begin() + count ) );
+		m_Decoded.erase( m_Decoded.begin(), m_Decoded.begin() + count );
+	}
+
+	for ( const DecodedTile& tile : decoded )
+	{
+		m_Pending.erase( tile.Tile );
+		if ( m_Resident.count( tile.Tile ) == 0 )
+			UploadTile( tile.Tile, tile.Data, false );
+	}
+}
+
+int TiledTexture::AcquireSlot()
+{
+	int best = -1;
+	for ( unsigned int i = 0; i < m_Slots.size(); i++ )
+	{
+		const Slot& slot = m_Slots[i];
+		if ( slot.Tile == NO_TILE )
+			return i;
+		// Tiles reported by the latest feedback are in use and stay.
+		if ( slot.Pinned || slot.LastUsedFrame >= m_FeedbackFrame )
+			continue;
+		if ( best < 0 || slot.LastUsedFrame < m_Slots[best].LastUsedFrame )
+			best = i;
+	}
+
+	if ( best >= 0 )
+	{
+		m_Resident.erase( m_Slots[best].Tile );
+		m_Slots[best].Tile = NO_TILE;
+		m_PageTableDirty = true;
+	}
+	return best;
+}
+
+bool TiledTexture::UploadTile( uint64_t tile, const std::vector< unsigned char >& data, bool pinned )
+{
+	const int slot = AcquireSlot();
+	if ( slot < 0 )
+		return false;
+
+	const unsigned int stride = m_Image.GetTileStride();
+	const int x = ( slot % m_SlotsPerSide ) * stride;
+	const int y = ( slot / m_SlotsPerSide ) * stride;
+	if ( m_Compressed )
+		m_Atlas->UpdateCompressed( x, y, stride, stride, data.data(), (unsigned int) data.size() );
+	else
+		m_Atlas->Update( x, y, stride, stride, data.data() );
+
+	m_Slots[slot] = { tile, m_Frame, pinned };
+	m_Resident[tile] = slot;
+	m_PageTableDirty = true;
+	m_Uploads++;
+	return true;
+}
+
+void TiledTexture::RebuildPageTable()
+{
+	const unsigned int levels = m_Image.GetHeader().Levels;
+	const unsigned int pitch = m_Image.GetLevel( 0 ).TilesX;
+
+	// From the coarsest level down, a missing tile inherits its parent's entry.
+	for ( int level = levels - 1; level >= 0; level-- )
+	{
+		const TiledImageLevel& info = m_Image.GetLevel( level );
+		for ( unsigned int y = 0; y < info.TilesY; y++ )
+		{
+			for ( unsigned int x = 0; x < info.TilesX; x++ )
+			{
+				unsigned char* entry = &m_PageEntries[( ( m_LevelOffsets[level] + y ) * pitch + x ) * 4];
+				auto resident = m_Resident.find( MakeTile( level, x, y ) );
+				if ( resident != m_Resident.end() )
+				{
+					entry[0] = (unsigned char) ( resident->second % m_SlotsPerSide );
+					entry[1] = (unsigned char) ( resident->second / m_SlotsPerSide );
+					entry[2] = (unsigned char) level;
+					entry[3] = 1;
+				}
+				else if ( level + 1 < (int) levels )
+				{
+					const TiledImageLevel& parent = m_Image.GetLevel( level + 1 );
+					const unsigned int px = std::min( x / 2, parent.TilesX - 1 );
+					const unsigned int py = std::min( y / 2, parent.TilesY - 1 );
+					std::memcpy( entry, &m_PageEntries[( ( m_LevelOffsets[level + 1] + py ) * pitch + px ) * 4], 4 );
+				}
+				else
+				{
+					std::memset( entry, 0, 4 );
+				}
+			}
+		}
+	}
+
+	m_PageTable->Update( 0, 0, m_PageTable->GetWidth(), m_PageTable->GetHeight(), m_PageEntries.data() );
+	m_PageTableDirty = false;
+}
+
+void TiledTexture::SetFeedbackUniforms( Shader& shader ) const
+{
+	const TiledImageHeader& header = m_Image.GetHeader();
+	shader.Bind();
+	shader.SetUniform2f( "u_ImageSize", (float) header.Width, (float) header.Height );
+	shader.SetUniform1f( "u_TileSize", (float) header.TileSize );
+	shader.SetUniform1i( "u_LevelCount", header.Levels );
+	shader.SetUniform1f( "u_LodBias", m_FeedbackLodBias );
+}
+
+void TiledTexture::SetUniforms( Shader& shader, unsigned int atlasSlot, unsigned int pageTableSlot ) const
+{
+	const TiledImageHeader& header = m_Image.GetHeader();
+	m_Atlas->Bind( atlasSlot );
+	m_PageTable->Bind( pageTableSlot );
+
+	shader.Bind();
+	shader.SetUniform1i( "u_Atlas", atlasSlot );
+	shader.SetUniform1i( "u_PageTable", pageTableSlot );
+	shader.SetUniform2f( "u_ImageSize", (float) header.Width, (float) header.Height );
+	shader.SetUniform1f( "u_TileSize", (float) header.TileSize );
+	shader.SetUniform1f( "u_TileBorder", (float) header.TileBorder );
+	shader.SetUniform1f( "u_SlotStride", (float) m_Image.GetTileStride() );
+	shader.SetUniform2f( "u_AtlasSize", (float) m_Atlas->GetWidth(), (float) m_Atlas->GetHeight() );
+	shader.SetUniform1i( "u_LevelCount", header.Levels );
+	shader.SetUniform1iv( "u_LevelOffset", (int) m_LevelOffsets.size(), m_LevelOffsets.data() );
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "TiledImage.h"
+#include "Texture.h"
+#include "FrameBuffer.h"
+
+class Shader;
+
+// Virtual texture for images too large to live in a single Texture.
+// Only the tiles a feedback pass reports as visible, at the level it reports, are
+// read by worker threads and uploaded into a fixed size atlas, so memory use does
+// not depend on the image size. A page table maps every tile of every level to
+// its atlas slot, or to the closest resident ancestor while it is being streamed.
+//
+// Per frame: Update(), render the geometry between BeginFeedback()/EndFeedback()
+// with a shader set up by SetFeedbackUniforms(), then render it normally with a
+// shader set up by SetUniforms(). See res/shaders/TiledImage*.shader.
+class TiledTexture
+{
+private:
+	struct Slot
+	{
+		uint64_t Tile;
+		unsigned int LastUsedFrame;
+		bool Pinned;
+	};
+
+	struct DecodedTile
+	{
+		uint64_t Tile;
+		std::vector< unsigned char > Data;
+	};
+
+	static const uint64_t NO_TILE = ~0ull;
+	static const unsigned int FEEDBACK_BUFFER_COUNT = 2;
+	static const unsigned int MAX_UPLOADS_PER_FRAME = 16;
+
+	TiledImage m_Image;
+	bool m_Compressed;
+	unsigned int m_SlotsPerSide;
+	std::unique_ptr< Texture > m_Atlas;
+	std::unique_ptr< Texture > m_PageTable;
+	std::vector< unsigned char > m_PageEntries;
+	std::vector< int > m_LevelOffsets;
+	bool m_PageTableDirty;
+
+	std::vector< Slot > m_Slots;
+	std::unordered_map< uint64_t, unsigned int > m_Resident;
+	// Queued or being decoded, only touched by the render thread.
+	std::unordered_set< uint64_t > m_Pending;
+	std::vector< uint64_t > m_Requested;
+	unsigned int m_Frame;
+	unsigned int m_FeedbackFrame;
+	unsigned int m_Uploads;
+
+	std::unique_ptr< Texture > m_FeedbackTexture;
+	std::unique_ptr< FrameBuffer > m_FeedbackBuffer;
+	unsigned int m_FeedbackPixelBuffers[FEEDBACK_BUFFER_COUNT];
+	GLsync m_FeedbackFences[FEEDBACK_BUFFER_COUNT];
+	unsigned int m_FeedbackIndex;
+	int m_SavedViewport[4];
+	float m_FeedbackLodBias;
+
+	std::vector< std::thread > m_Workers;
+	std::mutex m_Mutex;
+	std::condition_variable m_Condition;
+	std::deque< uint64_t > m_Queue;
+	std::vector< DecodedTile > m_Decoded;
+	bool m_Stop;
+
+public:
+	// "atlasSlots" tiles per side of the atlas, the feedback buffer is usually a quarter of the viewport.
+	TiledTexture( const std::string& path, unsigned int atlasSlots, int feedbackWidth, int feedbackHeight, unsigned int workerCount = 2 );
+	~TiledTexture();
+
+	// The worker threads point back at the texture, so neither copyable nor movable.
+	TiledTexture( const TiledTexture& ) = delete;
+	TiledTexture& operator=( const TiledTexture& ) = delete;
+
+	inline bool IsValid() const { return m_Image.IsValid(); }
+	inline int GetWidth() const { return m_Image.GetHeader().Width; }
+	inline int GetHeight() const { return m_Image.GetHeader().Height; }
+
+	// Consumes finished feedback readbacks and decoded tiles.
+	void Update();
+
+	void BeginFeedback();
+	void EndFeedback();
+
+	void SetFeedbackUniforms( Shader& shader ) const;
+	void SetUniforms( Shader& shader, unsigned int atlasSlot = 0, unsigned int pageTableSlot = 1 ) const;
+
+	inline size_t GetResidentTileCount() const { return m_Resident.size(); }
+	inline size_t GetPendingTileCount() const { return m_Pending.size(); }
+	inline size_t GetRequestedTileCount() const { return m_Requested.size(); }
+	inline size_t GetSlotCount() const { return m_Slots.size(); }
+	inline unsigned int GetUploadCount() const { return m_Uploads; }
+
+private:
+	static uint64_t MakeTile( unsigned int level, unsigned int x, unsigned int y );
+	static void SplitTile( uint64_t tile, unsigned int& level, unsigned int& x, unsigned int& y );
+
+	std::vector< unsigned char > DecodeTile( uint64_t tile ) const;
+	void WorkerMain();
+
+	void ReadFeedback();
+	void ProcessFeedback( const unsigned short* texels, size_t count );
+	void ScheduleRequests();
+	void UploadDecodedTiles();
+	bool UploadTile( uint64_t tile, const std::vector< unsigned char >& data, bool pinned );
+	int AcquireSlot();
+	void RebuildPageTable();
+};
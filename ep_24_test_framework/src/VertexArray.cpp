@@ -1,10 +1,21 @@
 #include "VertexArray.h"
 #include "Renderer.h"
+#include "StreamingRingBuffer.h"
 #include "Debug.h"
 
+#include <utility>
+
 VertexArray::VertexArray()
+	: m_UsedLocations( 0 )
 {
-	GLCall( glGenVertexArrays( 1, &m_RendererID ) );
+	if ( Renderer::IsDirectStateAccessSupported() )
+	{
+		GLCall( glCreateVertexArrays( 1, &m_RendererID ) );
+	}
+	else
+	{
+		GLCall( glGenVertexArrays( 1, &m_RendererID ) );
+	}
 }
 
 VertexArray::~VertexArray()
@@ -12,19 +23,109 @@ VertexArray::~VertexArray()
 	GLCall( glDeleteVertexArrays( 1, &m_RendererID ) );
 }
 
-void VertexArray::AddBuffer( const VertexBuffer& vb, const VertexBufferLayout& layout ) const
+VertexArray::VertexArray( VertexArray&& other ) noexcept
+	: m_RendererID( std::exchange( other.m_RendererID, 0 ) ), m_UsedLocations( std::exchange( other.m_UsedLocations, 0 ) )
+{
+}
+
+VertexArray& VertexArray::operator=( VertexArray&& other ) noexcept
+{
+	if ( this != &other )
+	{
+		GLCall( glDeleteVertexArrays( 1, &m_RendererID ) );
+		m_RendererID = std::exchange( other.m_RendererID, 0 );
+		m_UsedLocations = std::exchange( other.m_UsedLocations, 0 );
+	}
+	return *this;
+}
+
+void VertexArray::AddBuffer( const VertexBuffer& vb, const VertexBufferLayout& layout, unsigned int binding, unsigned int firstLocation )
+{
+	SetLayout( vb.GetRendererID(), layout.GetElements().data(), (unsigned int) layout.GetElements().size(), layout.GetStride(), layout.GetDivisor(), binding, firstLocation );
+}
+
+void VertexArray::AddBuffer( const StreamingRingBuffer& rb, const VertexBufferLayout& layout, unsigned int binding, unsigned int firstLocation )
+{
+	SetLayout( rb.GetRendererID(), layout.GetElements().data(), (unsigned int) layout.GetElements().size(), layout.GetStride(), layout.GetDivisor(), binding, firstLocation );
+}
+
+void VertexArray::SetLayout( unsigned int buffer, const VertexBufferElement* elements, unsigned int count, unsigned int stride, unsigned int divisor, unsigned int binding, unsigned int firstLocation )
 {
+	const unsigned int locations = ( ( 1u << count ) - 1 ) << firstLocation;
+	if ( m_UsedLocations & locations )
+		std::cout << "Vertex array " << m_RendererID << ": stream at binding " << binding << " overwrites attribute locations of another stream" << std::endl;
+	m_UsedLocations |= locations;
+
+	if ( Renderer::IsDirectStateAccessSupported() )
+	{
+		SetLayoutNamed( buffer, elements, count, stride, divisor, binding, firstLocation );
+		return;
+	}
+
 	Bind();
-	vb.Bind();
-	const auto& elements = layout.GetElements();
-	unsigned int offset = 0;
-	for ( unsigned int i = 0; i < elements.size(); i++ )
-	{
-		const VertexBufferElement element = elements[i];
-		GLCall( glEnableVertexAttribArray( i ) );
-		GLCall( glVertexAttribPointer( i, element.count, element.type, element.normalized,
-									   layout.GetStride(), (void*) ( offset ) ) );
-		offset += element.count * VertexBufferElement::GetSizeOfType( element.type );
+	const bool attribBinding = GLEW_ARB_vertex_attrib_binding;
+	if ( attribBinding )
+	{
+		GLCall( glBindVertexBuffer( binding, buffer, 0, stride ) );
+		GLCall( glVertexBindingDivisor( binding, divisor ) );
+	}
+	else
+	{
+		GLCall( glBindBuffer( GL_ARRAY_BUFFER, buffer ) );
+	}
+
+	for ( unsigned int i = 0; i < count; i++ )
+	{
+		const VertexBufferElement& element = elements[i];
+		const unsigned int location = firstLocation + i;
+		GLCall( glEnableVertexAttribArray( location ) );
+		if ( attribBinding )
+		{
+			if ( element.integer )
+			{
+				GLCall( glVertexAttribIFormat( location, element.count, element.type, element.offset ) );
+			}
+			else
+			{
+				GLCall( glVertexAttribFormat( location, element.count, element.type, element.normalized, element.offset ) );
+			}
+			GLCall( glVertexAttribBinding( location, binding ) );
+		}
+		else
+		{
+			if ( element.integer )
+			{
+				GLCall( glVertexAttribIPointer( location, element.count, element.type, stride, (void*) (size_t) element.offset ) );
+			}
+			else
+			{
+				GLCall( glVertexAttribPointer( location, element.count, element.type, element.normalized,
+											   stride, (void*) (size_t) element.offset ) );
+			}
+			// Without bindings the divisor belongs to every attribute.
+			GLCall( glVertexAttribDivisor( location, divisor ) );
+		}
+	}
+}
+
+void VertexArray::SetLayoutNamed( unsigned int buffer, const VertexBufferElement* elements, unsigned int count, unsigned int stride, unsigned int divisor, unsigned int binding, unsigned int firstLocation )
+{
+	GLCall( glVertexArrayVertexBuffer( m_RendererID, binding, buffer, 0, stride ) );
+	GLCall( glVertexArrayBindingDivisor( m_RendererID, binding, divisor ) );
+	for ( unsigned int i = 0; i < count; i++ )
+	{
+		const VertexBufferElement& element = elements[i];
+		const unsigned int location = firstLocation + i;
+		GLCall( glEnableVertexArrayAttrib( m_RendererID, location ) );
+		if ( element.integer )
+		{
+			GLCall( glVertexArrayAttribIFormat( m_RendererID, location, element.count, element.type, element.offset ) );
+		}
+		else
+		{
+			GLCall( glVertexArrayAttribFormat( m_RendererID, location, element.count, element.type, element.normalized, element.offset ) );
+		}
+		GLCall( glVertexArrayAttribBinding( m_RendererID, location, binding ) );
 	}
 }
 
@@ -2,17 +2,49 @@
 
 #include "VertexBuffer.h"
 #include "VertexBufferLayout.h"
+#include "VertexLayout.h"
 
+class StreamingRingBuffer;
+
+// Vertex array object. Every AddBuffer call attaches one vertex stream: a buffer at
+// a binding whose elements go to consecutive attribute locations from "firstLocation".
+// Streams let a pass fetch only what it needs, e.g. a depth pass with a vertex array
+// holding just the position stream of a mesh whose other attributes live elsewhere.
+//
+// Bindings map to glBindVertexBuffer with ARB_vertex_attrib_binding, or to
+// glVertexArrayVertexBuffer with direct state access. Without either, each attribute
+// points at its buffer directly and the binding is only bookkeeping.
 class VertexArray
 {
 private:
 	unsigned int m_RendererID;
+	// Attribute locations in use, to catch streams overwriting each other.
+	unsigned int m_UsedLocations;
 
 public:
 	VertexArray();
 	~VertexArray();
 
-	void AddBuffer( const VertexBuffer& vb, const VertexBufferLayout& layout ) const;
+	// Move-only, a moved-from vertex array owns no GL name.
+	VertexArray( const VertexArray& ) = delete;
+	VertexArray& operator=( const VertexArray& ) = delete;
+	VertexArray( VertexArray&& other ) noexcept;
+	VertexArray& operator=( VertexArray&& other ) noexcept;
+
+	void AddBuffer( const VertexBuffer& vb, const VertexBufferLayout& layout, unsigned int binding = 0, unsigned int firstLocation = 0 );
+	// Layout declared at compile time with VERTEX_LAYOUT( Vertex, ... ).
+	template< typename Vertex >
+	void AddBuffer( const VertexBuffer& vb, unsigned int binding = 0, unsigned int firstLocation = 0 )
+	{
+		SetLayout( vb.GetRendererID(), VertexLayoutOf< Vertex >::Elements, VertexLayoutOf< Vertex >::Count, VertexLayoutOf< Vertex >::Stride, 0, binding, firstLocation );
+	}
+	// Vertices written to a ring buffer are drawn with a base vertex, see Renderer::Draw.
+	void AddBuffer( const StreamingRingBuffer& rb, const VertexBufferLayout& layout, unsigned int binding = 0, unsigned int firstLocation = 0 );
 	void Bind() const;
 	void Unbind() const;
+
+private:
+	void SetLayout( unsigned int buffer, const VertexBufferElement* elements, unsigned int count, unsigned int stride, unsigned int divisor, unsigned int binding, unsigned int firstLocation );
+	// Same through direct state access, the vertex array is never bound.
+	void SetLayoutNamed( unsigned int buffer, const VertexBufferElement* elements, unsigned int count, unsigned int stride, unsigned int divisor, unsigned int binding, unsigned int firstLocation );
 };
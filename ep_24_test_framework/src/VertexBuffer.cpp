@@ -2,24 +2,7 @@
 #include "Renderer.h"
 #include "Debug.h"
 
-VertexBuffer::VertexBuffer( const void* data, unsigned int size )
+VertexBuffer::VertexBuffer( const void* data, unsigned int size, BufferUsage usage )
+	: Buffer( GL_ARRAY_BUFFER, data, size, usage )
 {
-	GLCall( glGenBuffers( 1, &m_RendererID ) );
-	GLCall( glBindBuffer( GL_ARRAY_BUFFER, m_RendererID ) );
-	GLCall( glBufferData( GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW ) );
-}
-
-VertexBuffer::~VertexBuffer()
-{
-	GLCall( glDeleteBuffers( 1, &m_RendererID ) );
-}
-
-void VertexBuffer::Bind() const
-{
-	GLCall( glBindBuffer( GL_ARRAY_BUFFER, m_RendererID ) );
-}
-
-void VertexBuffer::Unbind() const
-{
-	GLCall( glBindBuffer( GL_ARRAY_BUFFER, 0 ) );
 }
@@ -1,14 +1,10 @@
 #pragma once
 
-class VertexBuffer
+#include "Buffer.h"
+
+class VertexBuffer : public Buffer
 {
 public:
-	VertexBuffer( const void* data, unsigned int size );
-	~VertexBuffer();
-
-	void Bind() const;
-	void Unbind() const;
-
-private:
-	unsigned int m_RendererID;
+	// "data" may be null to only allocate "size" bytes, e.g. for geometry filled every frame.
+	VertexBuffer( const void* data, unsigned int size, BufferUsage usage = BufferUsage::Static );
 };
@@ -2,65 +2,111 @@
 
 #include <vector>
 #include "Debug.h"
+#include "Quantize.h"
 
 struct VertexBufferElement
 {
 	unsigned int type;
 	unsigned int count;
 	unsigned char normalized;
+	// Byte offset in the vertex.
+	unsigned int offset;
+	// Read as int/uint in the shader, without conversion to float.
+	unsigned char integer;
 
-	static unsigned int GetSizeOfType( unsigned int type )
+	static constexpr unsigned int GetSizeOfType( unsigned int type )
 	{
 		switch ( type )
 		{
 			case GL_FLOAT: return sizeof( GLfloat );
+			case GL_HALF_FLOAT: return sizeof( GLhalf );
+			case GL_INT: return sizeof( GLint );
 			case GL_UNSIGNED_INT: return sizeof( GLuint );
+			case GL_SHORT: return sizeof( GLshort );
+			case GL_UNSIGNED_SHORT: return sizeof( GLushort );
+			case GL_BYTE: return sizeof( GLbyte );
 			case GL_UNSIGNED_BYTE: return sizeof( GLbyte );
+			// Packed, all four components share one 32 bit value.
+			case GL_INT_2_10_10_10_REV: return sizeof( GLuint );
 		}
 		ASSERT( false );
 		return 0;
 	}
+
+	constexpr unsigned int GetSize() const
+	{
+		return type == GL_INT_2_10_10_10_REV ? GetSizeOfType( type ) : count * GetSizeOfType( type );
+	}
+};
+
+// GL type and component count of a vertex component type, see VertexBufferLayout::Push.
+template< typename T >
+struct VertexComponent
+{
+	static_assert( sizeof( T ) == 0, "Unsupported vertex member type" );
 };
 
+template< unsigned int GLType, unsigned int N, bool IsNormalized, bool IsInteger = false >
+struct VertexComponentInfo
+{
+	static constexpr unsigned int Type = GLType;
+	static constexpr unsigned int Count = N;
+	static constexpr bool Normalized = IsNormalized;
+	static constexpr bool Integer = IsInteger;
+};
+
+template<> struct VertexComponent< float > : VertexComponentInfo< GL_FLOAT, 1, false > {};
+template<> struct VertexComponent< Half > : VertexComponentInfo< GL_HALF_FLOAT, 1, false > {};
+template<> struct VertexComponent< int > : VertexComponentInfo< GL_INT, 1, false, true > {};
+template<> struct VertexComponent< unsigned int > : VertexComponentInfo< GL_UNSIGNED_INT, 1, false, true > {};
+template<> struct VertexComponent< short > : VertexComponentInfo< GL_SHORT, 1, false, true > {};
+template<> struct VertexComponent< unsigned short > : VertexComponentInfo< GL_UNSIGNED_SHORT, 1, false, true > {};
+template<> struct VertexComponent< signed char > : VertexComponentInfo< GL_BYTE, 1, false, true > {};
+template<> struct VertexComponent< unsigned char > : VertexComponentInfo< GL_UNSIGNED_BYTE, 1, false, true > {};
+// Always four components (the fourth is the 2 bit w), usually normalized normals or tangents.
+template<> struct VertexComponent< PackedNormal > : VertexComponentInfo< GL_INT_2_10_10_10_REV, 4, true > {};
+
 class VertexBufferLayout
 {
 private:
 	unsigned int m_Stride;
+	unsigned int m_Divisor;
 	std::vector<VertexBufferElement> m_Elements;
 
-public:
-	template< typename T >
-	void Push( unsigned int count )
-	{
-		static_assert( false );
-	}
-
-	template<>
-	void Push< float >( unsigned int count )
-	{
-		m_Elements.push_back( { GL_FLOAT, count, GL_FALSE } );
-		m_Stride += count * VertexBufferElement::GetSizeOfType( GL_FLOAT );
-	}
-
-	template<>
-	void Push< unsigned int >( unsigned int count )
+	void PushElement( unsigned int type, unsigned int count, bool normalized, bool integer = false )
 	{
-		m_Elements.push_back( { GL_UNSIGNED_INT, count, GL_FALSE } );
-		m_Stride += count * VertexBufferElement::GetSizeOfType( GL_UNSIGNED_INT );
+		m_Elements.push_back( { type, count, (unsigned char) ( normalized ? GL_TRUE : GL_FALSE ), m_Stride, (unsigned char) ( integer ? GL_TRUE : GL_FALSE ) } );
+		m_Stride += m_Elements.back().GetSize();
 	}
 
-	template<>
-	void Push< unsigned char >( unsigned int count )
+public:
+	// Integer types are integer attributes, read exactly as int, uint, ivecN or uvecN in
+	// the shader (material ids, texture array layers, bone indices, flags). "normalized"
+	// makes them floats divided by their maximum instead, e.g. unsigned char colors or
+	// unsigned short texture coordinates. Types that are normalized by definition, like
+	// PackedNormal, always are. VERTEX_LAYOUT (see VertexLayout.h) follows the same rules.
+	// Floats and half floats ignore it. See Quantize.h for converting float data.
+	template< typename T >
+	void Push( unsigned int count, bool normalized = false )
 	{
-		m_Elements.push_back( { GL_UNSIGNED_BYTE, count, GL_FALSE } );
-		m_Stride += count * VertexBufferElement::GetSizeOfType( GL_UNSIGNED_BYTE );
+		using Component = VertexComponent< T >;
+		// Packed types always have all their components.
+		ASSERT( Component::Count == 1 || count == Component::Count );
+		const bool isFloat = Component::Type == GL_FLOAT || Component::Type == GL_HALF_FLOAT;
+		normalized = normalized || Component::Normalized;
+		PushElement( Component::Type, count, normalized && !isFloat, Component::Integer && !normalized );
 	}
 
 public:
 	VertexBufferLayout() :
-		m_Stride( 0 )
+		m_Stride( 0 ), m_Divisor( 0 )
 	{}
 
-	inline const std::vector< VertexBufferElement > GetElements() const { return m_Elements; };
+	// Instanced stream: the vertex advances once every "divisor" instances instead of
+	// once per vertex, starting at the draw's base instance. 0 is per vertex.
+	inline void SetDivisor( unsigned int divisor ) { m_Divisor = divisor; }
+
+	inline const std::vector< VertexBufferElement >& GetElements() const { return m_Elements; };
 	inline unsigned int GetStride() const { return m_Stride; };
+	inline unsigned int GetDivisor() const { return m_Divisor; };
 };
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+
+#include "VertexBufferLayout.h"
+#include "Quantize.h"
+
+#include "glm/glm.hpp"
+
+// Vertex layouts derived from vertex structs at compile time:
+//
+//     struct QuadVertex { glm::vec2 Position; glm::vec2 TexCoord; Normalized< unsigned char, 4 > Color; };
+//     VERTEX_LAYOUT( QuadVertex, Position, TexCoord, Color )
+//     ...
+//     va.AddBuffer< QuadVertex >( vb );
+//
+// Members are bound to attribute locations 0, 1, 2... in the listed order. Types,
+// counts, offsets and the stride come from the struct, and the listed members must
+// cover the whole struct so a forgotten member or padding fails to compile.
+// Integer members (int, unsigned char[4], glm::uvec2...) are integer attributes read
+// as int/uint in the shader, wrap them in Normalized to read them as floats instead,
+// the same default as VertexBufferLayout::Push.
+
+// Integer components read as floats in [0, 1] or [-1, 1] instead of their value.
+template< typename T, unsigned int N >
+struct Normalized
+{
+	T Values[N];
+};
+
+// Scalar component types are in VertexBufferLayout.h, these add arrays, glm vectors
+// and Normalized.
+template< typename T, size_t N >
+struct VertexComponent< T[N] > : VertexComponentInfo< VertexComponent< T >::Type, (unsigned int) N * VertexComponent< T >::Count, VertexComponent< T >::Normalized, VertexComponent< T >::Integer > {};
+
+template< glm::length_t L, typename T, glm::qualifier Q >
+struct VertexComponent< glm::vec< L, T, Q > > : VertexComponentInfo< VertexComponent< T >::Type, (unsigned int) L, false, VertexComponent< T >::Integer > {};
+
+template< typename T, unsigned int N >
+struct VertexComponent< Normalized< T, N > > : VertexComponentInfo< VertexComponent< T >::Type, N, true > {};
+
+template< typename T >
+constexpr VertexBufferElement MakeVertexElement( unsigned int offset )
+{
+	using Component = VertexComponent< T >;
+	constexpr VertexBufferElement element = { Component::Type, Component::Count, Component::Normalized ? GL_TRUE : GL_FALSE, 0, Component::Integer ? GL_TRUE : GL_FALSE };
+	static_assert( element.GetSize() == sizeof( T ), "Vertex member size does not match its GL type" );
+	return { element.type, element.count, element.normalized, offset, element.integer };
+}
+
+template< size_t N >
+constexpr unsigned int GetVertexElementsSize( const VertexBufferElement ( &elements )[N] )
+{
+	unsigned int size = 0;
+	for ( size_t i = 0; i < N; i++ )
+		size += elements[i].GetSize();
+	return size;
+}
+
+// Specialized by VERTEX_LAYOUT.
+template< typename Vertex >
+struct VertexLayoutOf;
+
+// MSVC passes __VA_ARGS__ on as a single argument without the extra expansion.
+#define VERTEX_LAYOUT_EXPAND( x ) x
+#define VERTEX_LAYOUT_ELEMENT( Vertex, member ) MakeVertexElement< decltype( Vertex::member ) >( (unsigned int) offsetof( Vertex, member ) )
+#define VERTEX_LAYOUT_1( Vertex, member ) VERTEX_LAYOUT_ELEMENT( Vertex, member )
+#define VERTEX_LAYOUT_2( Vertex, member, ... ) VERTEX_LAYOUT_ELEMENT( Vertex, member ), VERTEX_LAYOUT_EXPAND( VERTEX_LAYOUT_1( Vertex, __VA_ARGS__ ) )
+#define VERTEX_LAYOUT_3( Vertex, member, ... ) VERTEX_LAYOUT_ELEMENT( Vertex, member ), VERTEX_LAYOUT_EXPAND( VERTEX_LAYOUT_2( Vertex, __VA_ARGS__ ) )
+#define VERTEX_LAYOUT_4( Vertex, member, ... ) VERTEX_LAYOUT_ELEMENT( Vertex, member ), VERTEX_LAYOUT_EXPAND( VERTEX_LAYOUT_3( Vertex, __VA_ARGS__ ) )
+#define VERTEX_LAYOUT_5( Vertex, member, ... ) VERTEX_LAYOUT_ELEMENT( Vertex, member ), VERTEX_LAYOUT_EXPAND( VERTEX_LAYOUT_4( Vertex, __VA_ARGS__ ) )
+#define VERTEX_LAYOUT_6( Vertex, member, ... ) VERTEX_LAYOUT_ELEMENT( Vertex, member ), VERTEX_LAYOUT_EXPAND( VERTEX_LAYOUT_5( Vertex, __VA_ARGS__ ) )
+#define VERTEX_LAYOUT_7( Vertex, member, ... ) VERTEX_LAYOUT_ELEMENT( Vertex, member ), VERTEX_LAYOUT_EXPAND( VERTEX_LAYOUT_6( Vertex, __VA_ARGS__ ) )
+#define VERTEX_LAYOUT_8( Vertex, member, ... ) VERTEX_LAYOUT_ELEMENT( Vertex, member ), VERTEX_LAYOUT_EXPAND( VERTEX_LAYOUT_7( Vertex, __VA_ARGS__ ) )
+#define VERTEX_LAYOUT_COUNT( _1, _2, _3, _4, _5, _6, _7, _8, N, ... ) N
+#define VERTEX_LAYOUT_SELECT( Count ) VERTEX_LAYOUT_##Count
+#define VERTEX_LAYOUT_DISPATCH( Count ) VERTEX_LAYOUT_SELECT( Count )
+#define VERTEX_LAYOUT_ELEMENTS( Vertex, ... ) \
+	VERTEX_LAYOUT_EXPAND( VERTEX_LAYOUT_DISPATCH( VERTEX_LAYOUT_EXPAND( VERTEX_LAYOUT_COUNT( __VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0 ) ) )( Vertex, __VA_ARGS__ ) )
+
+// Declares the layout of "Vertex" from up to 8 of its members, at namespace scope.
+#define VERTEX_LAYOUT( Vertex, ... ) \
+	template<> \
+	struct VertexLayoutOf< Vertex > \
+	{ \
+		static constexpr VertexBufferElement Elements[] = { VERTEX_LAYOUT_ELEMENTS( Vertex, __VA_ARGS__ ) }; \
+		static constexpr unsigned int Count = (unsigned int) ( sizeof( Elements ) / sizeof( Elements[0] ) ); \
+		static constexpr unsigned int Stride = (unsigned int) sizeof( Vertex ); \
+		static_assert( GetVertexElementsSize( Elements ) == sizeof( Vertex ), "VERTEX_LAYOUT must list every member of " #Vertex " and it may not have padding" ); \
+	};
@@ -7,10 +7,29 @@
 #include "imgui/imgui.h"
 #include "imgui/imgui_impl_glfw_gl3.h"
 
+#include "TextureCooker.h"
+#include "MeshCooker.h"
+#include "CookedMesh.h"
+#include "TextureManager.h"
+#include "Resources.h"
+
 #include "tests/TestClearColor.h"
 #include "tests/TestTriangle.h"
 #include "tests/TestUniform.h"
 #include "tests/TestMultipleObjects.h"
+#include "tests/TestTextureStreaming.h"
+#include "tests/TestTiledImage.h"
+#include "tests/TestTextureBatch.h"
+#include "tests/TestDynamicGeometry.h"
+#include "tests/TestStreamingSprites.h"
+#include "tests/TestGpuHeap.h"
+#include "tests/TestCompactVertices.h"
+#include "tests/TestVertexStreams.h"
+#include "tests/TestResourceHandles.h"
+#include "tests/TestMeshLoader.h"
+#include "tests/TestMeshletCulling.h"
+#include "tests/TestInstanceCulling.h"
+#include "tests/TestSpatialIndex.h"
 
 GLFWwindow* initWindow()
 {
@@ -20,12 +39,19 @@ GLFWwindow* initWindow()
 		return nullptr;
 	}
 
-	glfwWindowHint( GLFW_CONTEXT_VERSION_MAJOR, 3 );
-	glfwWindowHint( GLFW_CONTEXT_VERSION_MINOR, 3 );
-	glfwWindowHint( GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE );
-
-	// Open a window and create its OpenGL context.
-	GLFWwindow* window = glfwCreateWindow( 1024, 768, "OpenGL Tutorial - Test framework", nullptr, nullptr );
+	// Open a window and create its OpenGL context, the newest core profile available.
+	// 4.3 brings compute shaders, anything past 3.3 is still checked at runtime.
+	static const int versions[][2] = { { 4, 6 }, { 4, 5 }, { 4, 3 }, { 3, 3 } };
+	GLFWwindow* window = nullptr;
+	for ( const auto& version : versions )
+	{
+		glfwWindowHint( GLFW_CONTEXT_VERSION_MAJOR, version[0] );
+		glfwWindowHint( GLFW_CONTEXT_VERSION_MINOR, version[1] );
+		glfwWindowHint( GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE );
+		window = glfwCreateWindow( 1024, 768, "OpenGL Tutorial - Test framework", nullptr, nullptr );
+		if ( window != nullptr )
+			break;
+	}
 	if ( window == nullptr )
 	{
 		return nullptr;
@@ -49,8 +75,41 @@ GLFWwindow* initWindow()
 	return window;
 }
 
-int main( void )
+int main( int argc, char* argv[] )
 {
+	// Offline texture cooking: --cook [--compress] [directory]
+	if ( argc > 1 && std::string( argv[1] ) == "--cook" )
+	{
+		bool compress = false;
+		std::string directory = "res/textures";
+		for ( int i = 2; i < argc; i++ )
+		{
+			if ( std::string( argv[i] ) == "--compress" )
+				compress = true;
+			else
+				directory = argv[i];
+		}
+		return cooker::CookDirectory( directory, compress ) > 0 ? 0 : -1;
+	}
+
+	// Tiled image cooking: --cook-tiles <image> [tileSize]
+	if ( argc > 2 && std::string( argv[1] ) == "--cook-tiles" )
+	{
+		const std::string source = argv[2];
+		const unsigned int tileSize = argc > 3 ? (unsigned int) std::stoul( argv[3] ) : 252;
+		const std::string tiled = source.substr( 0, source.find_last_of( '.' ) ) + ".tiles";
+		return cooker::CookTiledImage( source, tiled, tileSize ) ? 0 : -1;
+	}
+
+	// Mesh cooking: --cook-mesh <model> [--forsyth]
+	if ( argc > 2 && std::string( argv[1] ) == "--cook-mesh" )
+	{
+		const std::string source = argv[2];
+		const bool forsyth = argc > 3 && std::string( argv[3] ) == "--forsyth";
+		return cooker::CookMesh( source, CookedMesh::GetCookedPath( source ), 0,
+								 forsyth ? cooker::VertexCacheOrder::Forsyth : cooker::VertexCacheOrder::Tipsify ) ? 0 : -1;
+	}
+
 	GLFWwindow* window = initWindow();
 	if ( window == nullptr )
 	{
@@ -74,12 +133,26 @@ int main( void )
 			&& ( glfwGetKey( window, GLFW_KEY_ESCAPE ) != GLFW_PRESS ) )
 	{
 		ImGui_ImplGlfwGL3_NewFrame();
+		TextureManager::Get().BeginFrame();
 		{
 			ImGui::Text( "Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate );
 			ImGui::RadioButton( "ClearColor", &radioSelection, 0 ); ImGui::SameLine();
 			ImGui::RadioButton( "Triangle", &radioSelection, 1 ); ImGui::SameLine();
 			ImGui::RadioButton( "Uniform", &radioSelection, 2 ); ImGui::SameLine();
 			ImGui::RadioButton( "MultipleObjects", &radioSelection, 3 );
+			ImGui::RadioButton( "TextureStreaming", &radioSelection, 4 ); ImGui::SameLine();
+			ImGui::RadioButton( "TiledImage", &radioSelection, 5 ); ImGui::SameLine();
+			ImGui::RadioButton( "TextureBatch", &radioSelection, 6 ); ImGui::SameLine();
+			ImGui::RadioButton( "DynamicGeometry", &radioSelection, 7 );
+			ImGui::RadioButton( "StreamingSprites", &radioSelection, 8 ); ImGui::SameLine();
+			ImGui::RadioButton( "GpuHeap", &radioSelection, 9 ); ImGui::SameLine();
+			ImGui::RadioButton( "CompactVertices", &radioSelection, 10 );
+			ImGui::RadioButton( "VertexStreams", &radioSelection, 11 ); ImGui::SameLine();
+			ImGui::RadioButton( "ResourceHandles", &radioSelection, 12 ); ImGui::SameLine();
+			ImGui::RadioButton( "MeshLoader", &radioSelection, 13 );
+			ImGui::RadioButton( "MeshletCulling", &radioSelection, 14 ); ImGui::SameLine();
+			ImGui::RadioButton( "InstanceCulling", &radioSelection, 15 ); ImGui::SameLine();
+			ImGui::RadioButton( "SpatialIndex", &radioSelection, 16 );
 		}
 
 		if ( currentSelection != radioSelection )
@@ -90,6 +163,19 @@ int main( void )
 				case 1: test = std::make_unique< test::TestTriangle >(); break;
 				case 2: test = std::make_unique< test::TestUniform >(); break;
 				case 3: test = std::make_unique< test::TestMultipleObjects >();break;
+				case 4: test = std::make_unique< test::TestTextureStreaming >(); break;
+				case 5: test = std::make_unique< test::TestTiledImage >(); break;
+				case 6: test = std::make_unique< test::TestTextureBatch >(); break;
+				case 7: test = std::make_unique< test::TestDynamicGeometry >(); break;
+				case 8: test = std::make_unique< test::TestStreamingSprites >(); break;
+				case 9: test = std::make_unique< test::TestGpuHeap >(); break;
+				case 10: test = std::make_unique< test::TestCompactVertices >(); break;
+				case 11: test = std::make_unique< test::TestVertexStreams >(); break;
+				case 12: test = std::make_unique< test::TestResourceHandles >(); break;
+				case 13: test = std::make_unique< test::TestMeshLoader >(); break;
+				case 14: test = std::make_unique< test::TestMeshletCulling >(); break;
+				case 15: test = std::make_unique< test::TestInstanceCulling >(); break;
+				case 16: test = std::make_unique< test::TestSpatialIndex >(); break;
 			}
 			currentSelection = radioSelection;
 		}
@@ -97,6 +183,7 @@ int main( void )
 		test->OnUpdate( 0.0f );
 		test->OnRender();
 		test->OnImGuiRender();
+		TextureManager::Get().OnImGuiRender();
 
 		ImGui::Render();
 		ImGui_ImplGlfwGL3_RenderDrawData( ImGui::GetDrawData() );
@@ -106,6 +193,7 @@ int main( void )
 	}
 
 	test = nullptr;
+	Resources::Get().Clear();
 
 	ImGui_ImplGlfwGL3_Shutdown();
 	ImGui::DestroyContext();
@@ -0,0 +1,141 @@
+#include "TestCompactVertices.h"
+
+#include "../Quantize.h"
+#include "../Debug.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <cmath>
+#include <vector>
+
+// The same attributes in full floats and in compact types.
+struct FloatVertex
+{
+	float Position[3];
+	float TexCoord[2];
+	float Color[4];
+	float Normal[3];
+};
+VERTEX_LAYOUT( FloatVertex, Position, TexCoord, Color, Normal )
+
+struct CompactVertex
+{
+	Half Position[4];
+	Normalized< unsigned short, 2 > TexCoord;
+	Normalized< unsigned char, 4 > Color;
+	PackedNormal Normal;
+};
+VERTEX_LAYOUT( CompactVertex, Position, TexCoord, Color, Normal )
+
+namespace test
+{
+	static const int GRID_WIDTH = 256;
+	static const int GRID_HEIGHT = 192;
+
+	static float Height( float x, float y )
+	{
+		return 0.05f * std::sin( x * 9.0f ) * std::cos( y * 7.0f ) + 0.03f * std::sin( ( x + y ) * 23.0f );
+	}
+
+	TestCompactVertices::TestCompactVertices() :
+		m_Compact( true ),
+		m_LightAngle( 0.8f ),
+		m_VertexCount( 0 ),
+		m_va(),
+		m_compactVa(),
+		m_shader( "res/shaders/Lit.shader" ),
+		m_texture( "res/textures/phone.png" ),
+		m_renderer(),
+		m_mvp( glm::ortho( 0.0f, 1024.0f, 0.0f, 768.0f, -1.0f, 1.0f ) * glm::translate( glm::mat4( 1.0f ), glm::vec3( 512.0f, 384.0f, 0.0f ) ) * glm::scale( glm::mat4( 1.0f ), glm::vec3( 480.0f, 360.0f, 1.0f ) ) )
+	{
+		// A bumpy height field in [-1, 1], lit through its normals.
+		std::vector< FloatVertex > vertices;
+		for ( int y = 0; y <= GRID_HEIGHT; y++ )
+		{
+			for ( int x = 0; x <= GRID_WIDTH; x++ )
+			{
+				const float u = (float) x / GRID_WIDTH, v = (float) y / GRID_HEIGHT;
+				const float px = u * 2.0f - 1.0f, py = v * 2.0f - 1.0f;
+				const float e = 0.001f;
+				const glm::vec3 normal = glm::normalize( glm::vec3( Height( px - e, py ) - Height( px + e, py ), Height( px, py - e ) - Height( px, py + e ), 2.0f * e ) );
+				vertices.push_back( { { px, py, Height( px, py ) }, { u, v }, { 0.6f + 0.4f * u, 0.6f + 0.4f * v, 1.0f, 1.0f }, { normal.x, normal.y, normal.z } } );
+			}
+		}
+		m_VertexCount = (unsigned int) vertices.size();
+
+		std::vector< unsigned int > indices;
+		for ( int y = 0; y < GRID_HEIGHT; y++ )
+		{
+			for ( int x = 0; x < GRID_WIDTH; x++ )
+			{
+				const unsigned int i = y * ( GRID_WIDTH + 1 ) + x;
+				indices.insert( indices.end(), { i, i + 1, i + GRID_WIDTH + 2, i + GRID_WIDTH + 2, i + GRID_WIDTH + 1, i } );
+			}
+		}
+		m_ib = std::make_unique< IndexBuffer >( indices.data(), (unsigned int) indices.size() );
+
+		// Quantize attribute by attribute, the helpers work on contiguous arrays.
+		std::vector< float > positions, texCoords, colors, normals;
+		for ( const FloatVertex& vertex : vertices )
+		{
+			positions.insert( positions.end(), { vertex.Position[0], vertex.Position[1], vertex.Position[2], 1.0f } );
+			texCoords.insert( texCoords.end(), std::begin( vertex.TexCoord ), std::end( vertex.TexCoord ) );
+			colors.insert( colors.end(), std::begin( vertex.Color ), std::end( vertex.Color ) );
+			normals.insert( normals.end(), std::begin( vertex.Normal ), std::end( vertex.Normal ) );
+		}
+		std::vector< Half > halfPositions( positions.size() );
+		std::vector< unsigned short > unormTexCoords( texCoords.size() );
+		std::vector< unsigned char > unormColors( colors.size() );
+		std::vector< PackedNormal > packedNormals( vertices.size() );
+		quantize::FloatToHalf( positions.data(), halfPositions.data(), positions.size() );
+		quantize::FloatToUnorm16( texCoords.data(), unormTexCoords.data(), texCoords.size() );
+		quantize::FloatToUnorm8( colors.data(), unormColors.data(), colors.size() );
+		quantize::PackNormals( normals.data(), packedNormals.data(), vertices.size() );
+
+		std::vector< CompactVertex > compactVertices( vertices.size() );
+		for ( size_t i = 0; i < vertices.size(); i++ )
+		{
+			CompactVertex& vertex = compactVertices[i];
+			std::copy( &halfPositions[i * 4], &halfPositions[i * 4 + 4], vertex.Position );
+			std::copy( &unormTexCoords[i * 2], &unormTexCoords[i * 2 + 2], vertex.TexCoord.Values );
+			std::copy( &unormColors[i * 4], &unormColors[i * 4 + 4], vertex.Color.Values );
+			vertex.Normal = packedNormals[i];
+		}
+
+		// Layouts come from the structs, see VERTEX_LAYOUT above.
+		m_vb = std::make_unique< VertexBuffer >( vertices.data(), (unsigned int) ( vertices.size() * sizeof( FloatVertex ) ) );
+		m_va.AddBuffer< FloatVertex >( *m_vb );
+		m_compactVb = std::make_unique< VertexBuffer >( compactVertices.data(), (unsigned int) ( compactVertices.size() * sizeof( CompactVertex ) ) );
+		m_compactVa.AddBuffer< CompactVertex >( *m_compactVb );
+
+		m_shader.Bind();
+		m_shader.SetUniform1i( "u_Texture", 0 );
+		m_shader.SetUniformMat4f( "u_MVP", m_mvp );
+	}
+
+	TestCompactVertices::~TestCompactVertices()
+	{
+		m_va.Unbind();
+		m_shader.Unbind();
+		m_ib->Unbind();
+	}
+
+	void TestCompactVertices::OnRender()
+	{
+		m_renderer.Clear();
+
+		m_texture.Bind();
+		m_shader.Bind();
+		m_shader.SetUniform3f( "u_LightDirection", 0.6f * std::cos( m_LightAngle ), 0.6f * std::sin( m_LightAngle ), 0.8f );
+		m_renderer.Draw( m_Compact ? m_compactVa : m_va, *m_ib, m_shader );
+	}
+
+	void TestCompactVertices::OnImGuiRender()
+	{
+		const unsigned int stride = m_Compact ? VertexLayoutOf< CompactVertex >::Stride : VertexLayoutOf< FloatVertex >::Stride;
+		ImGui::Checkbox( "Compact vertex format", &m_Compact );
+		ImGui::SliderFloat( "Light angle", &m_LightAngle, 0.0f, 6.2831853f );
+		ImGui::Text( "%u vertices, %u bytes each, %.1f MB", m_VertexCount, stride, (float) m_VertexCount * stride / ( 1024 * 1024 ) );
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../VertexArray.h"
+#include "../VertexBuffer.h"
+#include "../IndexBuffer.h"
+#include "../Shader.h"
+#include "../Texture.h"
+#include "../Renderer.h"
+
+#include <memory>
+
+#include "glm/glm.hpp"
+
+namespace test
+{
+	class TestCompactVertices : public Test
+	{
+	public:
+		TestCompactVertices();
+		~TestCompactVertices();
+
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		// Data members.
+		bool m_Compact;
+		float m_LightAngle;
+		unsigned int m_VertexCount;
+
+		// OpenGL members.
+		VertexArray m_va;
+		VertexArray m_compactVa;
+		std::unique_ptr< VertexBuffer > m_vb;
+		std::unique_ptr< VertexBuffer > m_compactVb;
+		std::unique_ptr< IndexBuffer > m_ib;
+		Shader m_shader;
+		Texture m_texture;
+		Renderer m_renderer;
+
+		// MVP members.
+		glm::mat4 m_mvp;
+	};
+}
@@ -0,0 +1,84 @@
+#include "TestDynamicGeometry.h"
+
+#include "../Debug.h"
+#include "imgui/imgui.h"
+
+#include <cmath>
+
+namespace test
+{
+	TestDynamicGeometry::TestDynamicGeometry() :
+		m_ObjectColor{ 0.2f, 0.3f, 0.8f, 1.0f },
+		m_MaxSegments( 512 ),
+		m_Usage( (int) BufferUsage::Stream ),
+		m_CurrentUsage( -1 ),
+		m_Frame( 0 ),
+		m_layout(),
+		m_shader( "res/shaders/Uniform.shader" ),
+		m_renderer()
+	{
+		m_layout.Push< float >( 2 );
+	}
+
+	TestDynamicGeometry::~TestDynamicGeometry()
+	{
+		m_va->Unbind();
+		m_shader.Unbind();
+		m_vb->Unbind();
+		m_ib->Unbind();
+	}
+
+	void TestDynamicGeometry::CreateBuffers()
+	{
+		// Start empty, the first SetData grows the storage.
+		const BufferUsage usage = (BufferUsage) m_Usage;
+		m_va = std::make_unique< VertexArray >();
+		m_vb = std::make_unique< VertexBuffer >( nullptr, 0, usage );
+		m_ib = std::make_unique< IndexBuffer >( usage );
+		m_va->AddBuffer( *m_vb, m_layout );
+		m_CurrentUsage = m_Usage;
+	}
+
+	void TestDynamicGeometry::OnUpdate( float deltaTime )
+	{
+		if ( m_CurrentUsage != m_Usage )
+			CreateBuffers();
+
+		// A wobbling star whose vertex count changes every frame.
+		const float time = m_Frame++ * 0.02f;
+		const int segments = 3 + (int) ( ( 0.5f + 0.5f * std::sin( time * 0.5f ) ) * ( m_MaxSegments - 3 ) );
+		m_Positions.assign( { 0.0f, 0.0f } );
+		m_Indices.clear();
+		for ( int i = 0; i < segments; i++ )
+		{
+			const float angle = 6.2831853f * i / segments;
+			const float radius = 0.6f + 0.15f * std::sin( angle * 7.0f + time * 3.0f );
+			m_Positions.push_back( radius * std::cos( angle ) );
+			m_Positions.push_back( radius * std::sin( angle ) );
+			m_Indices.insert( m_Indices.end(), { 0u, 1u + i, 1u + ( i + 1 ) % segments } );
+		}
+
+		m_vb->SetData( m_Positions.data(), (unsigned int) ( m_Positions.size() * sizeof( float ) ) );
+		m_ib->SetData( m_Indices.data(), (unsigned int) m_Indices.size() );
+	}
+
+	void TestDynamicGeometry::OnRender()
+	{
+		m_renderer.Clear();
+
+		m_shader.Bind();
+		m_shader.SetUniform4f( "u_Color", m_ObjectColor[0], m_ObjectColor[1], m_ObjectColor[2], m_ObjectColor[3] );
+		m_renderer.Draw( *m_va, *m_ib, m_shader );
+	}
+
+	void TestDynamicGeometry::OnImGuiRender()
+	{
+		ImGui::RadioButton( "Static", &m_Usage, (int) BufferUsage::Static ); ImGui::SameLine();
+		ImGui::RadioButton( "Dynamic", &m_Usage, (int) BufferUsage::Dynamic ); ImGui::SameLine();
+		ImGui::RadioButton( "Stream", &m_Usage, (int) BufferUsage::Stream );
+		ImGui::SliderInt( "Max segments", &m_MaxSegments, 3, 65536 );
+		ImGui::ColorEdit4( "Object Color", m_ObjectColor );
+		ImGui::Text( "Vertex buffer %u: %u / %u bytes", m_vb->GetRendererID(), m_vb->GetSize(), m_vb->GetCapacity() );
+		ImGui::Text( "Index buffer %u: %u / %u indices, %u bit", m_ib->GetRendererID(), m_ib->GetCount(), m_ib->GetCapacity(), m_ib->GetIndexSize() * 8 );
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../VertexArray.h"
+#include "../VertexBuffer.h"
+#include "../IndexBuffer.h"
+#include "../Shader.h"
+#include "../Renderer.h"
+
+#include <memory>
+#include <vector>
+
+namespace test
+{
+	class TestDynamicGeometry : public Test
+	{
+	public:
+		TestDynamicGeometry();
+		~TestDynamicGeometry();
+
+		void OnUpdate( float deltaTime ) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		void CreateBuffers();
+
+		// Data members.
+		float m_ObjectColor[4];
+		std::vector< float > m_Positions;
+		std::vector< unsigned int > m_Indices;
+		int m_MaxSegments;
+		int m_Usage;
+		int m_CurrentUsage;
+		unsigned int m_Frame;
+
+		// OpenGL members.
+		std::unique_ptr< VertexArray > m_va;
+		std::unique_ptr< IndexBuffer > m_ib;
+		std::unique_ptr< VertexBuffer > m_vb;
+		VertexBufferLayout m_layout;
+		Shader m_shader;
+		Renderer m_renderer;
+	};
+}
@@ -0,0 +1,160 @@
+#include "TestGpuHeap.h"
+
+#include "../Debug.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <numeric>
+
+namespace test
+{
+	static const int COLUMNS = 20;
+	static const int ROWS = 12;
+	static const float CELL_SIZE = 50.0f;
+
+	static VertexBufferLayout CreateLayout()
+	{
+		VertexBufferLayout layout;
+		layout.Push< float >( 2 );
+		layout.Push< float >( 2 );
+		return layout;
+	}
+
+	TestGpuHeap::TestGpuHeap() :
+		m_ChurnPerFrame( 4 ),
+		m_MultiDraw( false ),
+		m_layout( CreateLayout() ),
+		// Deliberately small, the heap grows as meshes are added.
+		m_heap( m_layout, 1024, 3072 ),
+		m_shader( "res/shaders/Complex.shader" ),
+		m_texture( "res/textures/phone.png" ),
+		m_renderer(),
+		m_proj( glm::ortho( 0.0f, 1024.0f, 0.0f, 768.0f, -1.0f, 1.0f ) )
+	{
+		for ( int i = 0; i < COLUMNS * ROWS; i++ )
+			m_Cells.push_back( AddRandomMesh() );
+
+		m_texture.Bind();
+		m_shader.Bind();
+		m_shader.SetUniform1i( "u_Texture", 0 );
+
+		if ( Renderer::IsComputeSupported() )
+		{
+			std::vector< std::string > defines;
+			if ( Renderer::IsDrawParametersSupported() )
+				defines.push_back( "DRAW_PARAMETERS" );
+			m_multiDrawShader = std::make_unique< Shader >( "res/shaders/MultiDraw.shader", defines );
+			m_multiDrawShader->SetUniform1i( "u_Texture", 0 );
+			m_commandBuffer = std::make_unique< Buffer >( GL_DRAW_INDIRECT_BUFFER, nullptr, 0, BufferUsage::Stream );
+			m_drawDataBuffer = std::make_unique< ShaderStorageBuffer >( nullptr, 0, BufferUsage::Stream );
+
+			// Without draw parameters the shader reads its draw ID from an instanced attribute
+			// after the heap's vertex attributes, the commands' BaseInstance picks the value.
+			std::vector< unsigned int > drawIDs( COLUMNS * ROWS );
+			std::iota( drawIDs.begin(), drawIDs.end(), 0u );
+			m_drawIDBuffer = std::make_unique< VertexBuffer >( drawIDs.data(), (unsigned int) ( drawIDs.size() * sizeof( unsigned int ) ) );
+			VertexBufferLayout drawIDLayout;
+			drawIDLayout.Push< unsigned int >( 1 );
+			drawIDLayout.SetDivisor( 1 );
+			m_multiDrawVa = std::make_unique< VertexArray >();
+			m_multiDrawVa->AddBuffer( m_heap.GetVertexBuffer(), m_heap.GetLayout() );
+			m_multiDrawVa->AddBuffer( *m_drawIDBuffer, drawIDLayout, 1, (unsigned int) m_heap.GetLayout().GetElements().size() );
+			m_MultiDraw = true;
+		}
+	}
+
+	TestGpuHeap::~TestGpuHeap()
+	{
+		m_shader.Unbind();
+	}
+
+	unsigned int TestGpuHeap::AddRandomMesh()
+	{
+		// A disc with a random number of segments, so meshes have all kinds of sizes.
+		const int segments = 3 + rand() % 125;
+		std::vector< float > vertices = { 0.0f, 0.0f, 0.5f, 0.5f };
+		std::vector< unsigned int > indices;
+		for ( int i = 0; i < segments; i++ )
+		{
+			const float angle = 6.2831853f * i / segments;
+			const float x = std::cos( angle ), y = std::sin( angle );
+			vertices.insert( vertices.end(), { x * CELL_SIZE * 0.45f, y * CELL_SIZE * 0.45f, 0.5f + x * 0.5f, 0.5f + y * 0.5f } );
+			indices.insert( indices.end(), { 0u, 1u + i, 1u + ( i + 1 ) % segments } );
+		}
+		return m_heap.AddMesh( vertices.data(), (unsigned int) vertices.size() / 4, indices.data(), (unsigned int) indices.size() );
+	}
+
+	void TestGpuHeap::OnUpdate( float deltaTime )
+	{
+		// Replace random meshes to keep allocating and freeing blocks of different sizes.
+		for ( int i = 0; i < m_ChurnPerFrame; i++ )
+		{
+			unsigned int& cell = m_Cells[rand() % m_Cells.size()];
+			m_heap.RemoveMesh( cell );
+			cell = AddRandomMesh();
+		}
+	}
+
+	void TestGpuHeap::OnRender()
+	{
+		m_renderer.Clear();
+
+		// One vertex array for every mesh, only the base vertex and first index change.
+		m_texture.Bind();
+		if ( m_MultiDraw )
+		{
+			// Every mesh is a command, its matrix sits at the command's index in the draw data.
+			m_Commands.clear();
+			m_DrawData.clear();
+			for ( int i = 0; i < (int) m_Cells.size(); i++ )
+			{
+				const glm::vec3 center( ( i % COLUMNS + 0.5f ) * CELL_SIZE + 12.0f, ( i / COLUMNS + 0.5f ) * CELL_SIZE + 84.0f, 0.0f );
+				m_Commands.push_back( m_heap.GetDrawCommand( m_Cells[i], (unsigned int) i ) );
+				m_DrawData.push_back( m_proj * glm::translate( glm::mat4( 1.0f ), center ) );
+			}
+			m_commandBuffer->SetData( m_Commands.data(), (unsigned int) ( m_Commands.size() * sizeof( DrawElementsIndirectCommand ) ) );
+			m_drawDataBuffer->SetData( m_DrawData.data(), (unsigned int) ( m_DrawData.size() * sizeof( glm::mat4 ) ) );
+
+			m_multiDrawShader->SetStorageBuffer( "DrawData", *m_drawDataBuffer );
+			m_renderer.MultiDrawIndirect( *m_multiDrawVa, m_heap.GetIndexBuffer(), *m_multiDrawShader, *m_commandBuffer, (unsigned int) m_Commands.size() );
+			return;
+		}
+
+		for ( int i = 0; i < (int) m_Cells.size(); i++ )
+		{
+			const glm::vec3 center( ( i % COLUMNS + 0.5f ) * CELL_SIZE + 12.0f, ( i / COLUMNS + 0.5f ) * CELL_SIZE + 84.0f, 0.0f );
+			m_shader.Bind();
+			m_shader.SetUniformMat4f( "u_MVP", m_proj * glm::translate( glm::mat4( 1.0f ), center ) );
+			m_heap.Draw( m_renderer, m_Cells[i], m_shader );
+		}
+	}
+
+	void TestGpuHeap::OnImGuiRender()
+	{
+		const OffsetAllocator& vertices = m_heap.GetVertexAllocator();
+		const OffsetAllocator& indices = m_heap.GetIndexAllocator();
+
+		ImGui::SliderInt( "Meshes replaced per frame", &m_ChurnPerFrame, 0, 64 );
+		if ( m_multiDrawShader )
+		{
+			ImGui::Checkbox( "One multi-draw indirect call", &m_MultiDraw );
+			if ( m_MultiDraw )
+				ImGui::Text( "Per-draw data through %s", Renderer::IsDrawParametersSupported() ? "gl_DrawIDARB" : "an instanced attribute and the base instance" );
+		}
+		else
+		{
+			ImGui::Text( "Multi-draw indirect needs OpenGL 4.3" );
+		}
+		ImGui::Text( "%u meshes in one vertex buffer and one index buffer", m_heap.GetMeshCount() );
+		ImGui::Text( "Vertices: %u / %u used, fragmentation %.2f",
+					 vertices.GetSize() - vertices.GetFreeSize(), vertices.GetSize(), vertices.GetFragmentation() );
+		ImGui::Text( "Indices: %u / %u used, fragmentation %.2f",
+					 indices.GetSize() - indices.GetFreeSize(), indices.GetSize(), indices.GetFragmentation() );
+		ImGui::Text( "%u buffer compactions", m_heap.GetDefragCount() );
+		if ( ImGui::Button( "Defragment now" ) )
+			m_heap.Defragment();
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../GpuHeap.h"
+#include "../Shader.h"
+#include "../Texture.h"
+#include "../Renderer.h"
+#include "../Buffer.h"
+#include "../ShaderStorageBuffer.h"
+
+#include <memory>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+namespace test
+{
+	class TestGpuHeap : public Test
+	{
+	public:
+		TestGpuHeap();
+		~TestGpuHeap();
+
+		void OnUpdate( float deltaTime ) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		unsigned int AddRandomMesh();
+
+		// Data members.
+		// Mesh id per grid cell.
+		std::vector< unsigned int > m_Cells;
+		int m_ChurnPerFrame;
+		bool m_MultiDraw;
+		std::vector< DrawElementsIndirectCommand > m_Commands;
+		std::vector< glm::mat4 > m_DrawData;
+
+		// OpenGL members.
+		VertexBufferLayout m_layout;
+		GpuHeap m_heap;
+		Shader m_shader;
+		// Multi-draw path, GL 4.3.
+		std::unique_ptr< Shader > m_multiDrawShader;
+		// The heap's vertex buffer plus the draw ID stream.
+		std::unique_ptr< VertexBuffer > m_drawIDBuffer;
+		std::unique_ptr< VertexArray > m_multiDrawVa;
+		std::unique_ptr< Buffer > m_commandBuffer;
+		std::unique_ptr< ShaderStorageBuffer > m_drawDataBuffer;
+		Texture m_texture;
+		Renderer m_renderer;
+
+		// MVP members.
+		glm::mat4 m_proj;
+	};
+}
@@ -0,0 +1,176 @@
+#include "TestInstanceCulling.h"
+
+#include "../Debug.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/type_ptr.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace test
+{
+	static const int GRID_SIZE = 256;
+	static const float GRID_SPACING = 3.0f;
+	// Rows of boxes turned per frame, each a partial update of the model buffer.
+	static const int TURN_ROWS = 16;
+
+	static glm::mat4 GetModel( const glm::vec4& instance, float angle, const glm::vec3& center )
+	{
+		return glm::scale( glm::rotate( glm::translate( glm::mat4( 1.0f ), glm::vec3( instance ) ), angle, glm::vec3( 0.0f, 1.0f, 0.0f ) ), glm::vec3( instance.w ) )
+			* glm::translate( glm::mat4( 1.0f ), -center );
+	}
+
+	TestInstanceCulling::TestInstanceCulling() :
+		m_Yaw( 0.0f ),
+		m_Spin( true ),
+		m_FreezeCulling( false ),
+		m_TurnBoxes( false ),
+		m_PersistentModels( false ),
+		m_CurrentPersistent( false ),
+		m_CullingViewProjection( 1.0f ),
+		m_Center( 0.0f ),
+		m_TurnRow( 0 ),
+		m_texture( "res/textures/phone.png" ),
+		m_renderer(),
+		m_proj( glm::perspective( glm::radians( 60.0f ), 1024.0f / 768.0f, 0.1f, 1000.0f ) )
+	{
+		if ( !Renderer::IsComputeSupported() )
+			return;
+
+		m_mesh = std::make_unique< Mesh >( "res/models/box.gltf" );
+		if ( !m_mesh->IsValid() )
+			return;
+		m_va = std::make_unique< VertexArray >();
+		m_va->AddBuffer( m_mesh->GetVertexBuffer(), m_mesh->GetLayout() );
+
+		// A field of randomly turned and scaled boxes around the camera.
+		const glm::vec3 boundsMin = glm::make_vec3( m_mesh->GetBoundsMin() );
+		const glm::vec3 boundsMax = glm::make_vec3( m_mesh->GetBoundsMax() );
+		m_Center = 0.5f * ( boundsMin + boundsMax );
+		const float radius = 0.5f * glm::length( boundsMax - boundsMin );
+		std::vector< glm::vec4 > spheres;
+		for ( int z = 0; z < GRID_SIZE; z++ )
+			for ( int x = 0; x < GRID_SIZE; x++ )
+			{
+				const glm::vec3 position( ( x - 0.5f * GRID_SIZE ) * GRID_SPACING, 0.0f, ( z - 0.5f * GRID_SIZE ) * GRID_SPACING );
+				const float scale = ( 0.5f + 0.5f * ( rand() % 100 ) / 100.0f ) / radius;
+				m_Instances.push_back( glm::vec4( position, scale ) );
+				m_Angles.push_back( (float) ( rand() % 628 ) / 100.0f );
+				// Turning around y keeps the box inside its sphere, the bounds never change.
+				spheres.push_back( glm::vec4( position, radius * scale ) );
+			}
+		CreateModels();
+		m_culler = std::make_unique< InstanceCuller >( m_mesh->GetIndexBuffer().GetCount(), (unsigned int) m_Instances.size() );
+		m_culler->UpdateBounds( 0, spheres.data(), (unsigned int) spheres.size() );
+
+		m_shader = std::make_unique< Shader >( "res/shaders/Instanced.shader" );
+		m_shader->SetUniform1i( "u_Texture", 0 );
+		m_shader->SetUniform3f( "u_LightDirection", 0.48f, 0.64f, 0.6f );
+	}
+
+	TestInstanceCulling::~TestInstanceCulling()
+	{
+		if ( m_shader )
+			m_shader->Unbind();
+	}
+
+	void TestInstanceCulling::CreateModels()
+	{
+		std::vector< glm::mat4 > models;
+		models.reserve( m_Instances.size() );
+		for ( size_t i = 0; i < m_Instances.size(); i++ )
+			models.push_back( GetModel( m_Instances[i], m_Angles[i], m_Center ) );
+		m_models = std::make_unique< ShaderStorageBuffer >( models.data(), (unsigned int) ( models.size() * sizeof( glm::mat4 ) ), BufferUsage::Dynamic, m_PersistentModels );
+		m_CurrentPersistent = m_PersistentModels;
+	}
+
+	void TestInstanceCulling::OnRender()
+	{
+		m_renderer.Clear();
+		if ( !m_culler )
+			return;
+
+		if ( m_CurrentPersistent != m_PersistentModels )
+			CreateModels();
+		// Waits for the region of three frames ago, the rows turned since are copied into it.
+		m_models->BeginFrame();
+
+		if ( m_Spin )
+			m_Yaw += 0.2f * ImGui::GetIO().DeltaTime;
+		const glm::vec3 eye( 0.0f, 8.0f, 0.0f );
+		const glm::vec3 forward( std::sin( m_Yaw ), -0.25f, std::cos( m_Yaw ) );
+		const glm::mat4 viewProjection = m_proj * glm::lookAt( eye, eye + forward, glm::vec3( 0.0f, 1.0f, 0.0f ) );
+		// A frozen frustum keeps culling for the old view, the rest of the field stays empty.
+		if ( !m_FreezeCulling )
+			m_CullingViewProjection = viewProjection;
+		m_culler->Cull( m_renderer, m_CullingViewProjection );
+
+		// A few rows at a time, so only a slice of the models is uploaded every frame.
+		if ( m_TurnBoxes )
+		{
+			const int first = m_TurnRow * GRID_SIZE;
+			m_TurnedModels.resize( TURN_ROWS * GRID_SIZE );
+			for ( int i = 0; i < TURN_ROWS * GRID_SIZE; i++ )
+			{
+				m_Angles[first + i] += 0.2f;
+				m_TurnedModels[i] = GetModel( m_Instances[first + i], m_Angles[first + i], m_Center );
+			}
+			StorageArray< glm::mat4 >( *m_models ).Set( first, m_TurnedModels.data(), (unsigned int) m_TurnedModels.size() );
+			m_TurnRow = ( m_TurnRow + TURN_ROWS ) % GRID_SIZE;
+		}
+
+		GLCall( glEnable( GL_DEPTH_TEST ) );
+		GLCall( glClear( GL_DEPTH_BUFFER_BIT ) );
+
+		m_texture.Bind();
+		m_shader->Bind();
+		m_shader->SetUniformMat4f( "u_ViewProjection", viewProjection );
+		m_shader->SetUniform3f( "u_PositionScale", m_mesh->GetPositionScale()[0], m_mesh->GetPositionScale()[1], m_mesh->GetPositionScale()[2] );
+		m_shader->SetUniform3f( "u_PositionOffset", m_mesh->GetBoundsMin()[0], m_mesh->GetBoundsMin()[1], m_mesh->GetBoundsMin()[2] );
+		m_culler->BindVisible( *m_shader );
+		m_shader->SetStorageBuffer( "Models", *m_models );
+		m_renderer.DrawIndirect( *m_va, m_mesh->GetIndexBuffer(), *m_shader, m_culler->GetCommandBuffer() );
+		m_models->EndFrame();
+
+		GLCall( glDisable( GL_DEPTH_TEST ) );
+	}
+
+	void TestInstanceCulling::OnImGuiRender()
+	{
+		if ( !Renderer::IsComputeSupported() )
+		{
+			ImGui::Text( "Compute shaders need OpenGL 4.3" );
+			return;
+		}
+		if ( !m_culler )
+		{
+			ImGui::Text( "Failed to load res/models/box.gltf" );
+			return;
+		}
+
+		ImGui::Checkbox( "Spin", &m_Spin );
+		ImGui::SameLine();
+		ImGui::Checkbox( "Freeze culling", &m_FreezeCulling );
+		ImGui::SameLine();
+		ImGui::Checkbox( "Turn boxes", &m_TurnBoxes );
+		if ( ShaderStorageBuffer::IsPersistentMappingSupported() )
+		{
+			ImGui::Checkbox( "Persistent models", &m_PersistentModels );
+			if ( m_models->IsPersistent() )
+			{
+				ImGui::SameLine();
+				ImGui::Text( "%u stalls", m_models->GetStallCount() );
+			}
+		}
+		else
+		{
+			ImGui::Text( "ARB_buffer_storage not supported, models are updated with glBufferSubData" );
+		}
+		const unsigned int visible = m_culler->GetVisibleCount();
+		const unsigned int total = m_culler->GetInstanceCount();
+		ImGui::Text( "%u of %u instances drawn (%.1f%%), one indirect draw", visible, total, total ? 100.0f * visible / total : 0.0f );
+	}
+}
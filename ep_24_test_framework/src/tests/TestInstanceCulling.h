@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../Mesh.h"
+#include "../InstanceCuller.h"
+#include "../ShaderStorageBuffer.h"
+#include "../VertexArray.h"
+#include "../Shader.h"
+#include "../Texture.h"
+#include "../Renderer.h"
+
+#include <memory>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+namespace test
+{
+	class TestInstanceCulling : public Test
+	{
+	public:
+		TestInstanceCulling();
+		~TestInstanceCulling();
+
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		// Creates the model buffer, persistent or not, from the current angles.
+		void CreateModels();
+
+		// Data members.
+		float m_Yaw;
+		bool m_Spin;
+		bool m_FreezeCulling;
+		bool m_TurnBoxes;
+		bool m_PersistentModels;
+		bool m_CurrentPersistent;
+		glm::mat4 m_CullingViewProjection;
+		// xyz position, w scale of every box, and its angle around y.
+		std::vector< glm::vec4 > m_Instances;
+		std::vector< float > m_Angles;
+		glm::vec3 m_Center;
+		std::vector< glm::mat4 > m_TurnedModels;
+		int m_TurnRow;
+
+		// OpenGL members.
+		std::unique_ptr< Mesh > m_mesh;
+		std::unique_ptr< VertexArray > m_va;
+		std::unique_ptr< ShaderStorageBuffer > m_models;
+		std::unique_ptr< InstanceCuller > m_culler;
+		std::unique_ptr< Shader > m_shader;
+		Texture m_texture;
+		Renderer m_renderer;
+
+		// MVP members.
+		glm::mat4 m_proj;
+	};
+}
@@ -0,0 +1,123 @@
+#include "TestMeshLoader.h"
+
+#include "../CookedMesh.h"
+#include "../Debug.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/type_ptr.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace test
+{
+	static const char* MODELS[] = { "res/models/torus.obj", "res/models/box.gltf" };
+	static const char* ORDERS[] = { "Tipsify", "Forsyth" };
+
+	TestMeshLoader::TestMeshLoader() :
+		m_Model( 0 ),
+		m_Order( (int) cooker::VertexCacheOrder::Tipsify ),
+		m_Statistics{},
+		m_Rotation( 0.0f ),
+		m_Spin( true ),
+		m_shader( "res/shaders/Mesh.shader" ),
+		m_texture( "res/textures/phone.png" ),
+		m_renderer(),
+		m_proj( glm::perspective( glm::radians( 45.0f ), 1024.0f / 768.0f, 0.1f, 100.0f ) ),
+		m_view( glm::lookAt( glm::vec3( 0.0f, 1.5f, 4.0f ), glm::vec3( 0.0f ), glm::vec3( 0.0f, 1.0f, 0.0f ) ) )
+	{
+		m_shader.Bind();
+		m_shader.SetUniform1i( "u_Texture", 0 );
+		m_shader.SetUniform3f( "u_LightDirection", 0.48f, 0.64f, 0.6f );
+		LoadMesh( false );
+	}
+
+	TestMeshLoader::~TestMeshLoader()
+	{
+		m_shader.Unbind();
+	}
+
+	void TestMeshLoader::LoadMesh( bool recook )
+	{
+		if ( recook )
+			std::remove( CookedMesh::GetCookedPath( MODELS[m_Model] ).c_str() );
+
+		m_va = nullptr;
+		m_mesh = std::make_unique< Mesh >( MODELS[m_Model], 0, (cooker::VertexCacheOrder) m_Order );
+		if ( !m_mesh->IsValid() )
+			return;
+		m_Statistics[m_Order][0] = m_mesh->GetAcmr();
+		m_Statistics[m_Order][1] = m_mesh->GetAtvr();
+
+		m_va = std::make_unique< VertexArray >();
+		m_va->AddBuffer( m_mesh->GetVertexBuffer(), m_mesh->GetLayout() );
+	}
+
+	void TestMeshLoader::OnRender()
+	{
+		m_renderer.Clear();
+		if ( !m_va )
+			return;
+
+		if ( m_Spin )
+			m_Rotation += ImGui::GetIO().DeltaTime;
+
+		// Fit the model into a unit sphere around the origin.
+		const glm::vec3 boundsMin = glm::make_vec3( m_mesh->GetBoundsMin() );
+		const glm::vec3 boundsMax = glm::make_vec3( m_mesh->GetBoundsMax() );
+		const float scale = 2.0f / std::max( glm::length( boundsMax - boundsMin ), 0.001f );
+		const glm::mat4 model = glm::rotate( glm::mat4( 1.0f ), m_Rotation, glm::vec3( 0.3f, 1.0f, 0.0f ) )
+			* glm::scale( glm::mat4( 1.0f ), glm::vec3( scale ) )
+			* glm::translate( glm::mat4( 1.0f ), -0.5f * ( boundsMin + boundsMax ) );
+
+		GLCall( glEnable( GL_DEPTH_TEST ) );
+		GLCall( glClear( GL_DEPTH_BUFFER_BIT ) );
+
+		m_texture.Bind();
+		m_shader.Bind();
+		m_shader.SetUniformMat4f( "u_MVP", m_proj * m_view * model );
+		m_shader.SetUniformMat4f( "u_Model", model );
+		m_shader.SetUniform3f( "u_PositionScale", m_mesh->GetPositionScale()[0], m_mesh->GetPositionScale()[1], m_mesh->GetPositionScale()[2] );
+		m_shader.SetUniform3f( "u_PositionOffset", m_mesh->GetBoundsMin()[0], m_mesh->GetBoundsMin()[1], m_mesh->GetBoundsMin()[2] );
+		m_renderer.Draw( *m_va, m_mesh->GetIndexBuffer(), m_shader );
+
+		GLCall( glDisable( GL_DEPTH_TEST ) );
+	}
+
+	void TestMeshLoader::OnImGuiRender()
+	{
+		if ( ImGui::Combo( "Model", &m_Model, MODELS, IM_ARRAYSIZE( MODELS ) ) )
+		{
+			m_Statistics[0][0] = m_Statistics[1][0] = 0.0f;
+			LoadMesh( false );
+		}
+		// Switching cooks the model again, the other order's numbers stay for comparison.
+		if ( ImGui::Combo( "Vertex cache order", &m_Order, ORDERS, IM_ARRAYSIZE( ORDERS ) ) )
+			LoadMesh( false );
+		if ( ImGui::Button( "Reload" ) )
+			LoadMesh( false );
+		ImGui::SameLine();
+		if ( ImGui::Button( "Re-cook" ) )
+			LoadMesh( true );
+		ImGui::Checkbox( "Spin", &m_Spin );
+
+		if ( !m_mesh || !m_mesh->IsValid() )
+		{
+			ImGui::Text( "Failed to load %s", MODELS[m_Model] );
+			return;
+		}
+		const IndexBuffer& ib = m_mesh->GetIndexBuffer();
+		ImGui::Text( "Loaded in %.2f ms, %s", m_mesh->GetLoadTime(), m_mesh->WasLoadedFromCache() ? "cooked mesh mapped" : "source parsed and cooked" );
+		ImGui::Text( "%u vertices, %u triangles", m_mesh->GetVertexCount(), ib.GetCount() / 3 );
+		ImGui::Text( "%u bytes per vertex, %u bit indices", m_mesh->GetLayout().GetStride(), ib.GetIndexSize() * 8 );
+		ImGui::Text( "ACMR %.3f -> %.3f, ATVR %.3f -> %.3f", m_mesh->GetSourceAcmr(), m_mesh->GetAcmr(), m_mesh->GetSourceAtvr(), m_mesh->GetAtvr() );
+		for ( int i = 0; i < IM_ARRAYSIZE( ORDERS ); i++ )
+		{
+			if ( m_Statistics[i][0] > 0.0f )
+				ImGui::Text( "%s: ACMR %.3f, ATVR %.3f", ORDERS[i], m_Statistics[i][0], m_Statistics[i][1] );
+			else
+				ImGui::Text( "%s: not cooked yet", ORDERS[i] );
+		}
+	}
+}
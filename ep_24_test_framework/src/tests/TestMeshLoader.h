@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../Mesh.h"
+#include "../VertexArray.h"
+#include "../Shader.h"
+#include "../Texture.h"
+#include "../Renderer.h"
+
+#include <memory>
+
+#include "glm/glm.hpp"
+
+namespace test
+{
+	class TestMeshLoader : public Test
+	{
+	public:
+		TestMeshLoader();
+		~TestMeshLoader();
+
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		// Loads the selected model, through the cooked mesh unless "recook".
+		void LoadMesh( bool recook );
+
+		// Data members.
+		int m_Model;
+		// cooker::VertexCacheOrder, and the ACMR and ATVR each one reached on the current model.
+		int m_Order;
+		float m_Statistics[2][2];
+		float m_Rotation;
+		bool m_Spin;
+
+		// OpenGL members.
+		std::unique_ptr< Mesh > m_mesh;
+		std::unique_ptr< VertexArray > m_va;
+		Shader m_shader;
+		Texture m_texture;
+		Renderer m_renderer;
+
+		// MVP members.
+		glm::mat4 m_proj;
+		glm::mat4 m_view;
+	};
+}
@@ -0,0 +1,154 @@
+#include "TestMeshletCulling.h"
+
+#include "../Debug.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/type_ptr.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace test
+{
+	static const int GRID_SIZE = 6;
+	static const float GRID_SPACING = 2.5f;
+
+	TestMeshletCulling::TestMeshletCulling() :
+		m_WallModel( 1.0f ),
+		m_Orbit( 0.0f ),
+		m_Spin( true ),
+		m_ConeCulling( true ),
+		m_OcclusionCulling( true ),
+		m_Width( 0 ),
+		m_Height( 0 ),
+		m_shader( "res/shaders/Mesh.shader" ),
+		m_texture( "res/textures/phone.png" ),
+		m_renderer(),
+		m_proj( 1.0f )
+	{
+		m_shader.Bind();
+		m_shader.SetUniform1i( "u_Texture", 0 );
+		m_shader.SetUniform3f( "u_LightDirection", 0.48f, 0.64f, 0.6f );
+
+		if ( !Renderer::IsComputeSupported() )
+			return;
+
+		m_mesh = std::make_unique< Mesh >( "res/models/torus.obj" );
+		m_wall = std::make_unique< Mesh >( "res/models/box.gltf" );
+		if ( !m_mesh->IsValid() || !m_wall->IsValid() )
+			return;
+
+		m_va = std::make_unique< VertexArray >();
+		m_va->AddBuffer( m_mesh->GetVertexBuffer(), m_mesh->GetLayout() );
+		m_wallVa = std::make_unique< VertexArray >();
+		m_wallVa->AddBuffer( m_wall->GetVertexBuffer(), m_wall->GetLayout() );
+
+		// A grid of tori, half of it hidden behind a wall through the middle.
+		for ( int z = 0; z < GRID_SIZE; z++ )
+			for ( int x = 0; x < GRID_SIZE; x++ )
+			{
+				const glm::vec3 position( ( x - 0.5f * ( GRID_SIZE - 1 ) ) * GRID_SPACING, 0.0f, ( z - 0.5f * ( GRID_SIZE - 1 ) ) * GRID_SPACING );
+				m_Models.push_back( glm::rotate( glm::translate( glm::mat4( 1.0f ), position ), 0.7f * ( x + z ), glm::vec3( 1.0f, 0.0f, 0.0f ) ) );
+			}
+		const glm::vec3 wallMin = glm::make_vec3( m_wall->GetBoundsMin() );
+		const glm::vec3 wallMax = glm::make_vec3( m_wall->GetBoundsMax() );
+		m_WallModel = glm::scale( glm::mat4( 1.0f ), glm::vec3( GRID_SIZE * GRID_SPACING, 4.0f, 0.3f ) / glm::max( wallMax - wallMin, glm::vec3( 0.001f ) ) )
+			* glm::translate( glm::mat4( 1.0f ), -0.5f * ( wallMin + wallMax ) );
+
+		m_culler = std::make_unique< MeshletCuller >( *m_mesh, (unsigned int) m_Models.size() );
+		m_pyramid = std::make_unique< DepthPyramid >();
+
+		// Depth has to be a texture for the pyramid, so the scene goes through a framebuffer.
+		int viewport[4];
+		GLCall( glGetIntegerv( GL_VIEWPORT, viewport ) );
+		m_Width = viewport[2];
+		m_Height = viewport[3];
+		m_colorTexture = std::make_unique< Texture >( m_Width, m_Height, GL_RGBA8 );
+		m_depthTexture = std::make_unique< Texture >( m_Width, m_Height, GL_DEPTH_COMPONENT32F );
+		m_frameBuffer = std::make_unique< FrameBuffer >( *m_colorTexture, m_depthTexture.get() );
+		m_proj = glm::perspective( glm::radians( 45.0f ), (float) m_Width / (float) std::max( m_Height, 1 ), 0.1f, 100.0f );
+	}
+
+	TestMeshletCulling::~TestMeshletCulling()
+	{
+		m_shader.Unbind();
+	}
+
+	void TestMeshletCulling::OnRender()
+	{
+		m_renderer.Clear();
+		if ( !m_culler )
+			return;
+
+		if ( m_Spin )
+			m_Orbit += 0.3f * ImGui::GetIO().DeltaTime;
+		const glm::vec3 cameraPosition( 14.0f * std::sin( m_Orbit ), 3.0f, 14.0f * std::cos( m_Orbit ) );
+		const glm::mat4 viewProjection = m_proj * glm::lookAt( cameraPosition, glm::vec3( 0.0f ), glm::vec3( 0.0f, 1.0f, 0.0f ) );
+
+		m_culler->SetConeCulling( m_ConeCulling );
+		if ( m_OcclusionCulling != m_culler->IsOcclusionCulling() )
+			m_culler->SetOcclusionCulling( m_OcclusionCulling );
+		m_culler->BeginFrame( m_Models );
+
+		m_frameBuffer->Bind();
+		GLCall( glEnable( GL_DEPTH_TEST ) );
+		GLCall( glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT ) );
+
+		m_texture.Bind();
+		m_shader.Bind();
+		m_shader.SetUniformMat4f( "u_MVP", viewProjection * m_WallModel );
+		m_shader.SetUniformMat4f( "u_Model", m_WallModel );
+		m_shader.SetUniform3f( "u_PositionScale", m_wall->GetPositionScale()[0], m_wall->GetPositionScale()[1], m_wall->GetPositionScale()[2] );
+		m_shader.SetUniform3f( "u_PositionOffset", m_wall->GetBoundsMin()[0], m_wall->GetBoundsMin()[1], m_wall->GetBoundsMin()[2] );
+		m_renderer.Draw( *m_wallVa, m_wall->GetIndexBuffer(), m_shader );
+
+		const unsigned int phases = m_OcclusionCulling ? 2 : 1;
+		for ( unsigned int phase = 0; phase < phases; phase++ )
+		{
+			if ( phase == 1 )
+				m_pyramid->Build( m_renderer, *m_depthTexture );
+			m_culler->Cull( m_renderer, phase, viewProjection, cameraPosition, m_pyramid.get() );
+
+			m_texture.Bind();
+			m_shader.Bind();
+			m_shader.SetUniform3f( "u_PositionScale", m_mesh->GetPositionScale()[0], m_mesh->GetPositionScale()[1], m_mesh->GetPositionScale()[2] );
+			m_shader.SetUniform3f( "u_PositionOffset", m_mesh->GetBoundsMin()[0], m_mesh->GetBoundsMin()[1], m_mesh->GetBoundsMin()[2] );
+			for ( unsigned int i = 0; i < m_Models.size(); i++ )
+			{
+				m_shader.SetUniformMat4f( "u_MVP", viewProjection * m_Models[i] );
+				m_shader.SetUniformMat4f( "u_Model", m_Models[i] );
+				m_renderer.DrawIndirect( *m_va, m_culler->GetIndexBuffer(), m_shader, m_culler->GetCommandBuffer(), m_culler->GetCommandOffset( phase, i ) );
+			}
+		}
+
+		GLCall( glDisable( GL_DEPTH_TEST ) );
+		m_frameBuffer->Unbind();
+		m_frameBuffer->BlitToScreen( m_Width, m_Height );
+	}
+
+	void TestMeshletCulling::OnImGuiRender()
+	{
+		if ( !Renderer::IsComputeSupported() )
+		{
+			ImGui::Text( "Compute shaders need OpenGL 4.3" );
+			return;
+		}
+		if ( !m_culler )
+		{
+			ImGui::Text( "Failed to load the models" );
+			return;
+		}
+
+		ImGui::Checkbox( "Spin", &m_Spin );
+		ImGui::Checkbox( "Cone culling", &m_ConeCulling );
+		ImGui::SameLine();
+		ImGui::Checkbox( "Occlusion culling", &m_OcclusionCulling );
+
+		const unsigned int total = m_culler->GetInstanceCount() * ( m_mesh->GetIndexBuffer().GetCount() / 3 );
+		const unsigned int drawn = m_culler->GetDrawnTriangles( 0 ) + m_culler->GetDrawnTriangles( 1 );
+		ImGui::Text( "%u instances of %u meshlets", m_culler->GetInstanceCount(), m_culler->GetMeshletCount() );
+		ImGui::Text( "%u of %u triangles drawn (%.1f%%)", drawn, total, total ? 100.0f * drawn / total : 0.0f );
+		ImGui::Text( "Phase 0: %u, phase 1: %u", m_culler->GetDrawnTriangles( 0 ), m_culler->GetDrawnTriangles( 1 ) );
+	}
+}
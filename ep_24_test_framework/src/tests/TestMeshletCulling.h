@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../Mesh.h"
+#include "../MeshletCuller.h"
+#include "../DepthPyramid.h"
+#include "../FrameBuffer.h"
+#include "../VertexArray.h"
+#include "../Shader.h"
+#include "../Texture.h"
+#include "../Renderer.h"
+
+#include <memory>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+namespace test
+{
+	class TestMeshletCulling : public Test
+	{
+	public:
+		TestMeshletCulling();
+		~TestMeshletCulling();
+
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		// Data members.
+		std::vector< glm::mat4 > m_Models;
+		glm::mat4 m_WallModel;
+		float m_Orbit;
+		bool m_Spin;
+		bool m_ConeCulling;
+		bool m_OcclusionCulling;
+		int m_Width, m_Height;
+
+		// OpenGL members.
+		std::unique_ptr< Mesh > m_mesh;
+		std::unique_ptr< Mesh > m_wall;
+		std::unique_ptr< VertexArray > m_va;
+		std::unique_ptr< VertexArray > m_wallVa;
+		std::unique_ptr< MeshletCuller > m_culler;
+		std::unique_ptr< DepthPyramid > m_pyramid;
+		std::unique_ptr< Texture > m_colorTexture;
+		std::unique_ptr< Texture > m_depthTexture;
+		std::unique_ptr< FrameBuffer > m_frameBuffer;
+		Shader m_shader;
+		Texture m_texture;
+		Renderer m_renderer;
+
+		// MVP members.
+		glm::mat4 m_proj;
+	};
+}
@@ -8,6 +8,13 @@
 
 namespace test
 {
+	// A map of tiles much larger than the screen, scrolled with the view matrix.
+	static const int MAP_COLUMNS = 128;
+	static const int MAP_ROWS = 96;
+	static const float TILE_SPACING = 120.0f;
+	// Radius of the sphere around a 100x100 quad centered on its translation.
+	static const float QUAD_RADIUS = 70.72f;
+
 	TestMultipleObjects::TestMultipleObjects() :
 		m_ClearColor{ 0.8f, 0.3f, 0.2f, 1.0f },
 		m_Positions{
@@ -20,6 +27,9 @@ namespace test
 			0, 1, 2,
 			2, 3, 0
 		},
+		m_VisibleCount( 0 ),
+		m_FrustumCulling( true ),
+		m_Scroll( 0.0f ),
 		m_va(),
 		m_ib( m_Indices, 6 ),
 		m_vb( m_Positions, 4 * 4 * sizeof( float ) ),
@@ -38,6 +48,15 @@ namespace test
 
 		m_texture.Bind();
 		m_shader.SetUniform1i( "u_Texture", 0 );
+
+		m_Objects.push_back( m_translationA );
+		m_Objects.push_back( m_translationB );
+		for ( int y = 0; y < MAP_ROWS; y++ )
+			for ( int x = 0; x < MAP_COLUMNS; x++ )
+				m_Objects.push_back( glm::vec3( ( x + 0.5f ) * TILE_SPACING, ( y + 0.5f ) * TILE_SPACING - MAP_ROWS * TILE_SPACING, 0.0f ) );
+		for ( const glm::vec3& object : m_Objects )
+			m_Bounds.Add( object, QUAD_RADIUS );
+		m_Visible.resize( m_Objects.size() );
 	}
 
 	TestMultipleObjects::~TestMultipleObjects()
@@ -53,18 +72,29 @@ namespace test
 		m_renderer.Clear();
 		GLCall( glClearColor( m_ClearColor[0], m_ClearColor[1], m_ClearColor[2], m_ClearColor[3] ) );
 
+		m_view = glm::translate( glm::mat4( 1.0f ), glm::vec3( -m_Scroll, 0.0f ) );
+		m_Objects[0] = m_translationA;
+		m_Objects[1] = m_translationB;
+		m_Bounds.Set( 0, m_translationA, QUAD_RADIUS );
+		m_Bounds.Set( 1, m_translationB, QUAD_RADIUS );
+
+		// Off-screen objects never reach the renderer.
+		if ( m_FrustumCulling )
 		{
-			glm::mat4 model = glm::translate( glm::mat4( 1.0f ), m_translationA );
-			glm::mat4 mvp = m_proj * m_view * model;
-			m_shader.Bind();
-			m_shader.SetUniformMat4f( "u_MVP", mvp );
-			m_renderer.Draw( m_va, m_ib, m_shader );
+			m_VisibleCount = (unsigned int) Frustum( m_proj * m_view ).CullSpheres( m_Bounds, m_Visible.data() );
+		}
+		else
+		{
+			m_VisibleCount = (unsigned int) m_Objects.size();
+			for ( unsigned int i = 0; i < m_VisibleCount; i++ )
+				m_Visible[i] = i;
 		}
 
+		m_shader.Bind();
+		for ( unsigned int i = 0; i < m_VisibleCount; i++ )
 		{
-			glm::mat4 model = glm::translate( glm::mat4( 1.0f ), m_translationB );
+			glm::mat4 model = glm::translate( glm::mat4( 1.0f ), m_Objects[m_Visible[i]] );
 			glm::mat4 mvp = m_proj * m_view * model;
-			m_shader.Bind();
 			m_shader.SetUniformMat4f( "u_MVP", mvp );
 			m_renderer.Draw( m_va, m_ib, m_shader );
 		}
@@ -75,5 +105,8 @@ namespace test
 		ImGui::ColorEdit4( "Clear Color", m_ClearColor );
 		ImGui::SliderFloat3( "TranslationA", &m_translationA.x, 0.0f, 768.0f );
 		ImGui::SliderFloat3( "TranslationB", &m_translationB.x, 0.0f, 768.0f );
+		ImGui::SliderFloat2( "Scroll", &m_Scroll.x, -MAP_ROWS * TILE_SPACING, MAP_COLUMNS * TILE_SPACING );
+		ImGui::Checkbox( "Frustum culling", &m_FrustumCulling );
+		ImGui::Text( "%u of %u objects drawn", m_VisibleCount, (unsigned int) m_Objects.size() );
 	}
 };
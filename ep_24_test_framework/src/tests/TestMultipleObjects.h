@@ -8,6 +8,9 @@
 #include "../Shader.h"
 #include "../Texture.h"
 #include "../Renderer.h"
+#include "../Frustum.h"
+
+#include <vector>
 
 #include "glm/glm.hpp"
 #include "glm/gtc/matrix_transform.hpp"
@@ -28,6 +31,13 @@ namespace test
 		float m_ClearColor[4];
 		float m_Positions[16];
 		unsigned int m_Indices[6];
+		// Translation of every object, A and B first, then the tiles of the map.
+		std::vector< glm::vec3 > m_Objects;
+		BoundingSpheres m_Bounds;
+		std::vector< uint32_t > m_Visible;
+		unsigned int m_VisibleCount;
+		bool m_FrustumCulling;
+		glm::vec2 m_Scroll;
 
 		// OpenGL members.
 		VertexArray m_va;
@@ -0,0 +1,149 @@
+#include "TestResourceHandles.h"
+
+#include "../VertexBufferLayout.h"
+#include "../Debug.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace test
+{
+	static const int TEXTURE_COUNT = 16;
+	static const int TEXTURE_SIZE = 32;
+	static const int COLUMNS = 24;
+	static const int ROWS = 16;
+	static const float QUAD_SIZE = 36.0f;
+
+	TestResourceHandles::TestResourceHandles() :
+		m_TexturesCreated( 0 ),
+		m_StalePackets( 0 ),
+		m_renderer(),
+		m_proj( glm::ortho( 0.0f, 1024.0f, 0.0f, 768.0f, -1.0f, 1.0f ) )
+	{
+		Resources& resources = Resources::Get();
+
+		const float quad[] = {
+			0.0f,      0.0f,      0.0f, 0.0f,
+			QUAD_SIZE, 0.0f,      1.0f, 0.0f,
+			QUAD_SIZE, QUAD_SIZE, 1.0f, 1.0f,
+			0.0f,      QUAD_SIZE, 0.0f, 1.0f
+		};
+		const unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+		m_vb = resources.Create< VertexBuffer >( quad, (unsigned int) sizeof( quad ) );
+		m_ib = resources.Create< IndexBuffer >( indices, 6u );
+		m_va = resources.Create< VertexArray >();
+
+		VertexBufferLayout layout;
+		layout.Push< float >( 2 );
+		layout.Push< float >( 2 );
+		resources.Get( m_va ).AddBuffer( resources.Get( m_vb ), layout );
+
+		m_shader = resources.Create< Shader >( "res/shaders/Complex.shader" );
+		resources.Get( m_shader ).Bind();
+		resources.Get( m_shader ).SetUniform1i( "u_Texture", 0 );
+
+		for ( int i = 0; i < TEXTURE_COUNT; i++ )
+			m_textures.push_back( CreateTexture() );
+
+		for ( int row = 0; row < ROWS; row++ )
+		{
+			for ( int column = 0; column < COLUMNS; column++ )
+			{
+				const TextureHandle texture = m_textures[std::rand() % TEXTURE_COUNT];
+				m_Packets.push_back( { texture, glm::vec2( 80.0f + column * ( QUAD_SIZE + 2.0f ), 80.0f + row * ( QUAD_SIZE + 2.0f ) ) } );
+			}
+		}
+	}
+
+	TestResourceHandles::~TestResourceHandles()
+	{
+		Resources& resources = Resources::Get();
+		for ( TextureHandle texture : m_textures )
+			resources.Destroy( texture );
+		resources.Destroy( m_shader );
+		resources.Destroy( m_va );
+		resources.Destroy( m_ib );
+		resources.Destroy( m_vb );
+	}
+
+	TextureHandle TestResourceHandles::CreateTexture()
+	{
+		// Solid color with a darker border.
+		const unsigned int seed = m_TexturesCreated++;
+		const unsigned char r = (unsigned char) ( 60 + seed * 53 ), g = (unsigned char) ( 90 + seed * 97 ), b = (unsigned char) ( 120 + seed * 31 );
+		std::vector< unsigned char > pixels( TEXTURE_SIZE * TEXTURE_SIZE * 4 );
+		for ( int y = 0; y < TEXTURE_SIZE; y++ )
+		{
+			for ( int x = 0; x < TEXTURE_SIZE; x++ )
+			{
+				const bool border = x < 2 || y < 2 || x >= TEXTURE_SIZE - 2 || y >= TEXTURE_SIZE - 2;
+				unsigned char* pixel = &pixels[( y * TEXTURE_SIZE + x ) * 4];
+				pixel[0] = border ? r / 2 : r;
+				pixel[1] = border ? g / 2 : g;
+				pixel[2] = border ? b / 2 : b;
+				pixel[3] = 255;
+			}
+		}
+		return Resources::Get().Create< Texture >( TEXTURE_SIZE, TEXTURE_SIZE, GL_RGBA8, pixels.data() );
+	}
+
+	void TestResourceHandles::OnRender()
+	{
+		m_renderer.Clear();
+
+		// Sorting by handle groups the packets sharing a texture, so each texture is bound once.
+		std::sort( m_Packets.begin(), m_Packets.end(), []( const DrawPacket& a, const DrawPacket& b ) { return a.Texture < b.Texture; } );
+
+		Resources& resources = Resources::Get();
+		Shader& shader = resources.Get( m_shader );
+		TextureHandle bound;
+		m_StalePackets = 0;
+		for ( const DrawPacket& packet : m_Packets )
+		{
+			// A packet can outlive its texture, the generation tells.
+			const Texture* texture = resources.TryGet( packet.Texture );
+			if ( !texture )
+			{
+				m_StalePackets++;
+				continue;
+			}
+			if ( packet.Texture != bound )
+			{
+				texture->Bind();
+				bound = packet.Texture;
+			}
+
+			shader.Bind();
+			shader.SetUniformMat4f( "u_MVP", m_proj * glm::translate( glm::mat4( 1.0f ), glm::vec3( packet.Position, 0.0f ) ) );
+			m_renderer.Draw( m_va, m_ib, m_shader );
+		}
+	}
+
+	void TestResourceHandles::OnImGuiRender()
+	{
+		Resources& resources = Resources::Get();
+		if ( ImGui::Button( "Destroy a texture" ) && !m_textures.empty() )
+		{
+			const size_t index = std::rand() % m_textures.size();
+			resources.Destroy( m_textures[index] );
+			m_textures.erase( m_textures.begin() + index );
+		}
+		ImGui::SameLine();
+		if ( ImGui::Button( "Create a texture" ) )
+			m_textures.push_back( CreateTexture() );
+		ImGui::SameLine();
+		if ( ImGui::Button( "Reassign stale packets" ) && !m_textures.empty() )
+		{
+			for ( DrawPacket& packet : m_Packets )
+			{
+				if ( !resources.IsValid( packet.Texture ) )
+					packet.Texture = m_textures[std::rand() % m_textures.size()];
+			}
+		}
+
+		ImGui::Text( "%u live textures, %u packets, %u skipped with a stale handle", (unsigned int) resources.GetTable< Texture >().GetCount(), (unsigned int) m_Packets.size(), m_StalePackets );
+	}
+}
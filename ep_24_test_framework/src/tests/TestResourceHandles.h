@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../Resources.h"
+#include "../Renderer.h"
+
+#include <vector>
+
+#include "glm/glm.hpp"
+
+namespace test
+{
+	class TestResourceHandles : public Test
+	{
+	public:
+		TestResourceHandles();
+		~TestResourceHandles();
+
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		// Everything a draw needs, small enough to sort and copy around.
+		struct DrawPacket
+		{
+			TextureHandle Texture;
+			glm::vec2 Position;
+		};
+
+		TextureHandle CreateTexture();
+
+		// Data members.
+		std::vector< DrawPacket > m_Packets;
+		unsigned int m_TexturesCreated;
+		unsigned int m_StalePackets;
+
+		// OpenGL members.
+		VertexBufferHandle m_vb;
+		IndexBufferHandle m_ib;
+		VertexArrayHandle m_va;
+		ShaderHandle m_shader;
+		std::vector< TextureHandle > m_textures;
+		Renderer m_renderer;
+
+		// MVP members.
+		glm::mat4 m_proj;
+	};
+}
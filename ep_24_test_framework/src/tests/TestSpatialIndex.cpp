@@ -0,0 +1,198 @@
+#include "TestSpatialIndex.h"
+
+#include "../Debug.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+namespace test
+{
+	static const int SPRITES = 50000;
+	// Id of a background larger than the whole world. The hashed grid keeps it out of
+	// its cells, every query checks it directly.
+	static const uint32_t BACKGROUND = SPRITES;
+	static const float WORLD_SIZE = 8192.0f;
+	static const float SPRITE_SIZE = 16.0f;
+	static const float SCREEN_WIDTH = 1024.0f;
+	static const float SCREEN_HEIGHT = 768.0f;
+	// Most sprites on screen at once, more are left out.
+	static const int MAX_VISIBLE = 20000;
+	// Position and texture coordinates.
+	static const unsigned int VERTEX_SIZE = 4 * sizeof( float );
+
+	static std::vector< unsigned int > CreateQuadIndices( int quadCount )
+	{
+		std::vector< unsigned int > indices;
+		indices.reserve( quadCount * 6 );
+		for ( unsigned int i = 0; i < (unsigned int) quadCount; i++ )
+			indices.insert( indices.end(), { i * 4, i * 4 + 1, i * 4 + 2, i * 4 + 2, i * 4 + 3, i * 4 } );
+		return indices;
+	}
+
+	static double GetMilliseconds( std::chrono::steady_clock::time_point start )
+	{
+		return std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+	}
+
+	TestSpatialIndex::TestSpatialIndex() :
+		m_IndexType( (int) SpatialIndexType::LooseQuadtree ),
+		m_Scroll( 0.5f * WORLD_SIZE ),
+		m_Pan( true ),
+		m_Background( true ),
+		m_BackgroundInView( false ),
+		m_UpdateTime( 0.0 ),
+		m_QueryTime( 0.0 ),
+		m_SpriteCount( 0 ),
+		m_BaseVertex( 0 ),
+		m_va(),
+		m_ib( CreateQuadIndices( MAX_VISIBLE ).data(), MAX_VISIBLE * 6 ),
+		m_ring( MAX_VISIBLE * 4 * VERTEX_SIZE ),
+		m_layout(),
+		m_shader( "res/shaders/Complex.shader" ),
+		m_texture( "res/textures/phone.png" ),
+		m_renderer(),
+		m_proj( glm::ortho( 0.0f, SCREEN_WIDTH, 0.0f, SCREEN_HEIGHT, -1.0f, 1.0f ) )
+	{
+		for ( int i = 0; i < SPRITES; i++ )
+		{
+			m_SpritePositions.push_back( glm::vec2( rand() % (int) WORLD_SIZE, rand() % (int) WORLD_SIZE ) );
+			// A quarter of the sprites stand still, the others wander.
+			m_SpriteVelocities.push_back( i % 4 == 0 ? glm::vec2( 0.0f ) : glm::vec2( rand() % 200 - 100, rand() % 200 - 100 ) / 60.0f );
+		}
+		CreateIndex();
+
+		m_layout.Push< float >( 2 );
+		m_layout.Push< float >( 2 );
+		m_va.AddBuffer( m_ring, m_layout );
+
+		m_shader.Bind();
+		m_shader.SetUniform1i( "u_Texture", 0 );
+	}
+
+	TestSpatialIndex::~TestSpatialIndex()
+	{
+		m_shader.Unbind();
+	}
+
+	Bounds2D TestSpatialIndex::GetSpriteBounds( int sprite ) const
+	{
+		return { m_SpritePositions[sprite], m_SpritePositions[sprite] + SPRITE_SIZE };
+	}
+
+	Bounds2D TestSpatialIndex::GetBackgroundBounds()
+	{
+		return { glm::vec2( -WORLD_SIZE ), glm::vec2( 2.0f * WORLD_SIZE ) };
+	}
+
+	void TestSpatialIndex::CreateIndex()
+	{
+		const auto start = std::chrono::steady_clock::now();
+		m_index = SpatialIndex::Create( (SpatialIndexType) m_IndexType, { glm::vec2( 0.0f ), glm::vec2( WORLD_SIZE ) }, 2.0f * SPRITE_SIZE );
+		for ( int i = 0; i < SPRITES; i++ )
+			m_index->Insert( i, GetSpriteBounds( i ) );
+		if ( m_Background )
+			m_index->Insert( BACKGROUND, GetBackgroundBounds() );
+		m_UpdateTime = GetMilliseconds( start );
+	}
+
+	void TestSpatialIndex::OnUpdate( float deltaTime )
+	{
+		// Moving sprites update their entry, most of them stay in their node or cells.
+		const auto start = std::chrono::steady_clock::now();
+		for ( int i = 0; i < SPRITES; i++ )
+		{
+			glm::vec2& v = m_SpriteVelocities[i];
+			if ( v == glm::vec2( 0.0f ) )
+				continue;
+			glm::vec2& p = m_SpritePositions[i];
+			p += v;
+			if ( p.x < 0.0f || p.x > WORLD_SIZE - SPRITE_SIZE ) v.x = -v.x;
+			if ( p.y < 0.0f || p.y > WORLD_SIZE - SPRITE_SIZE ) v.y = -v.y;
+			m_index->Update( i, GetSpriteBounds( i ) );
+		}
+		m_UpdateTime = GetMilliseconds( start );
+
+		if ( m_Pan )
+		{
+			m_Scroll.x += 2.0f;
+			if ( m_Scroll.x > WORLD_SIZE - SCREEN_WIDTH )
+				m_Scroll.x = 0.0f;
+		}
+
+		// The view and the cursor in one batch, only the sprites they touch are visited.
+		// The cursor is left out while it is outside the window.
+		const ImVec2 mouse = ImGui::GetIO().MousePos;
+		const glm::vec2 cursor = m_Scroll + glm::vec2( mouse.x, SCREEN_HEIGHT - mouse.y );
+		const Bounds2D areas[2] = {
+			{ m_Scroll, m_Scroll + glm::vec2( SCREEN_WIDTH, SCREEN_HEIGHT ) },
+			{ cursor, cursor }
+		};
+		const auto queryStart = std::chrono::steady_clock::now();
+		m_index->QueryBatch( areas, ImGui::IsMousePosValid() ? 2 : 1, m_Results, m_ResultOffsets );
+		m_QueryTime = GetMilliseconds( queryStart );
+
+		// Submission: only the visible sprites are written, the background is just reported.
+		const unsigned int found = std::min( m_ResultOffsets[1], (uint32_t) MAX_VISIBLE );
+		m_ring.BeginFrame();
+		unsigned int offset = 0;
+		float* vertices = (float*) m_ring.Allocate( found * 4 * VERTEX_SIZE, VERTEX_SIZE, offset );
+		m_SpriteCount = 0;
+		m_BackgroundInView = false;
+		for ( unsigned int i = 0; vertices && i < found; i++ )
+		{
+			if ( m_Results[i] == BACKGROUND )
+			{
+				m_BackgroundInView = true;
+				continue;
+			}
+			const glm::vec2 p = m_SpritePositions[m_Results[i]] - m_Scroll;
+			float* v = vertices + m_SpriteCount++ * 16;
+			v[0]  = p.x;               v[1]  = p.y;               v[2]  = 0.0f; v[3]  = 0.0f;
+			v[4]  = p.x + SPRITE_SIZE; v[5]  = p.y;               v[6]  = 1.0f; v[7]  = 0.0f;
+			v[8]  = p.x + SPRITE_SIZE; v[9]  = p.y + SPRITE_SIZE; v[10] = 1.0f; v[11] = 1.0f;
+			v[12] = p.x;               v[13] = p.y + SPRITE_SIZE; v[14] = 0.0f; v[15] = 1.0f;
+		}
+		m_ring.Flush();
+		m_BaseVertex = offset / VERTEX_SIZE;
+	}
+
+	void TestSpatialIndex::OnRender()
+	{
+		m_renderer.Clear();
+
+		m_texture.Bind();
+		m_shader.Bind();
+		m_shader.SetUniformMat4f( "u_MVP", m_proj );
+		if ( m_SpriteCount > 0 )
+			m_renderer.Draw( m_va, m_ib, m_shader, m_SpriteCount * 6, 0, m_BaseVertex );
+
+		m_ring.EndFrame();
+	}
+
+	void TestSpatialIndex::OnImGuiRender()
+	{
+		bool changed = ImGui::RadioButton( "Loose quadtree", &m_IndexType, (int) SpatialIndexType::LooseQuadtree );
+		ImGui::SameLine();
+		changed |= ImGui::RadioButton( "Hashed grid", &m_IndexType, (int) SpatialIndexType::HashedGrid );
+		if ( changed )
+			CreateIndex();
+
+		ImGui::Checkbox( "Pan", &m_Pan );
+		ImGui::SameLine();
+		if ( ImGui::Checkbox( "Background", &m_Background ) )
+		{
+			if ( m_Background )
+				m_index->Insert( BACKGROUND, GetBackgroundBounds() );
+			else
+				m_index->Remove( BACKGROUND );
+		}
+		ImGui::SliderFloat2( "Scroll", &m_Scroll.x, 0.0f, WORLD_SIZE - SCREEN_WIDTH );
+		ImGui::Text( "%u of %d sprites on screen%s", m_SpriteCount, SPRITES, m_BackgroundInView ? ", background found" : "" );
+		ImGui::Text( "%u objects under the cursor", m_ResultOffsets.size() < 3 ? 0 : m_ResultOffsets[2] - m_ResultOffsets[1] );
+		ImGui::Text( "Update %.2f ms, queries %.3f ms", m_UpdateTime, m_QueryTime );
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../SpatialIndex.h"
+#include "../VertexArray.h"
+#include "../IndexBuffer.h"
+#include "../StreamingRingBuffer.h"
+#include "../Shader.h"
+#include "../Texture.h"
+#include "../Renderer.h"
+
+#include <memory>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+namespace test
+{
+	class TestSpatialIndex : public Test
+	{
+	public:
+		TestSpatialIndex();
+		~TestSpatialIndex();
+
+		void OnUpdate( float deltaTime ) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		// Builds the index of the selected type from the current positions.
+		void CreateIndex();
+		Bounds2D GetSpriteBounds( int sprite ) const;
+		static Bounds2D GetBackgroundBounds();
+
+		// Data members.
+		std::vector< glm::vec2 > m_SpritePositions;
+		std::vector< glm::vec2 > m_SpriteVelocities;
+		int m_IndexType;
+		std::unique_ptr< SpatialIndex > m_index;
+		glm::vec2 m_Scroll;
+		bool m_Pan;
+		bool m_Background;
+		bool m_BackgroundInView;
+		// Results of the view and cursor queries, see SpatialIndex::QueryBatch.
+		std::vector< uint32_t > m_Results;
+		std::vector< uint32_t > m_ResultOffsets;
+		double m_UpdateTime;
+		double m_QueryTime;
+		unsigned int m_SpriteCount;
+		int m_BaseVertex;
+
+		// OpenGL members.
+		VertexArray m_va;
+		IndexBuffer m_ib;
+		StreamingRingBuffer m_ring;
+		VertexBufferLayout m_layout;
+		Shader m_shader;
+		Texture m_texture;
+		Renderer m_renderer;
+
+		// MVP members.
+		glm::mat4 m_proj;
+	};
+}
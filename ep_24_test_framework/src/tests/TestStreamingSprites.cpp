@@ -0,0 +1,165 @@
+#include "TestStreamingSprites.h"
+
+#include "../Debug.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <cstdlib>
+
+namespace test
+{
+	static const int MAX_SPRITES = 20000;
+	static const float SPRITE_SIZE = 16.0f;
+	// Position and texture coordinates.
+	static const unsigned int VERTEX_SIZE = 4 * sizeof( float );
+
+	static std::vector< unsigned int > CreateQuadIndices( int quadCount )
+	{
+		std::vector< unsigned int > indices;
+		indices.reserve( quadCount * 6 );
+		for ( unsigned int i = 0; i < (unsigned int) quadCount; i++ )
+			indices.insert( indices.end(), { i * 4, i * 4 + 1, i * 4 + 2, i * 4 + 2, i * 4 + 3, i * 4 } );
+		return indices;
+	}
+
+	TestStreamingSprites::TestStreamingSprites() :
+		m_SpriteCount( 5000 ),
+		m_UseRingBuffer( true ),
+		m_VertexPulling( false ),
+		m_BaseVertex( 0 ),
+		m_ringVa(),
+		m_va(),
+		m_ib( CreateQuadIndices( MAX_SPRITES ).data(), MAX_SPRITES * 6 ),
+		m_vb( nullptr, MAX_SPRITES * 4 * VERTEX_SIZE, BufferUsage::Stream ),
+		m_ring( MAX_SPRITES * 4 * VERTEX_SIZE ),
+		m_layout(),
+		m_shader( "res/shaders/Complex.shader" ),
+		m_texture( "res/textures/phone.png" ),
+		m_renderer(),
+		m_proj( glm::ortho( 0.0f, 1024.0f, 0.0f, 768.0f, -1.0f, 1.0f ) )
+	{
+		for ( int i = 0; i < MAX_SPRITES; i++ )
+		{
+			m_SpritePositions.push_back( glm::vec2( rand() % 1024, rand() % 768 ) );
+			m_SpriteVelocities.push_back( glm::vec2( rand() % 200 - 100, rand() % 200 - 100 ) / 60.0f );
+		}
+		m_Vertices.resize( MAX_SPRITES * 4 * 4 );
+
+		m_layout.Push< float >( 2 );
+		m_layout.Push< float >( 2 );
+		m_va.AddBuffer( m_vb, m_layout );
+		m_ringVa.AddBuffer( m_ring, m_layout );
+
+		m_shader.Bind();
+		m_shader.SetUniform1i( "u_Texture", 0 );
+		m_shader.SetUniformMat4f( "u_MVP", m_proj );
+
+		if ( Renderer::IsComputeSupported() )
+			m_sprites = std::make_unique< SpriteRenderer >();
+	}
+
+	TestStreamingSprites::~TestStreamingSprites()
+	{
+		m_va.Unbind();
+		m_shader.Unbind();
+		m_vb.Unbind();
+		m_ib.Unbind();
+	}
+
+	void TestStreamingSprites::WriteVertices( float* vertices ) const
+	{
+		for ( int i = 0; i < m_SpriteCount; i++ )
+		{
+			const glm::vec2 p = m_SpritePositions[i];
+			float* v = vertices + i * 16;
+			v[0]  = p.x;               v[1]  = p.y;               v[2]  = 0.0f; v[3]  = 0.0f;
+			v[4]  = p.x + SPRITE_SIZE; v[5]  = p.y;               v[6]  = 1.0f; v[7]  = 0.0f;
+			v[8]  = p.x + SPRITE_SIZE; v[9]  = p.y + SPRITE_SIZE; v[10] = 1.0f; v[11] = 1.0f;
+			v[12] = p.x;               v[13] = p.y + SPRITE_SIZE; v[14] = 0.0f; v[15] = 1.0f;
+		}
+	}
+
+	void TestStreamingSprites::OnUpdate( float deltaTime )
+	{
+		for ( int i = 0; i < m_SpriteCount; i++ )
+		{
+			glm::vec2& p = m_SpritePositions[i];
+			glm::vec2& v = m_SpriteVelocities[i];
+			p += v;
+			if ( p.x < 0.0f || p.x > 1024.0f - SPRITE_SIZE ) v.x = -v.x;
+			if ( p.y < 0.0f || p.y > 768.0f - SPRITE_SIZE ) v.y = -v.y;
+		}
+
+		if ( m_VertexPulling )
+		{
+			// One record per sprite, the corners are made up in the vertex shader.
+			m_sprites->Begin();
+			for ( int i = 0; i < m_SpriteCount; i++ )
+				m_sprites->Submit( m_SpritePositions[i], glm::vec2( SPRITE_SIZE ) );
+			return;
+		}
+
+		const unsigned int size = m_SpriteCount * 4 * VERTEX_SIZE;
+		if ( m_UseRingBuffer )
+		{
+			// Written straight into memory the GPU reads, no intermediate copy.
+			m_ring.BeginFrame();
+			unsigned int offset = 0;
+			float* vertices = (float*) m_ring.Allocate( size, VERTEX_SIZE, offset );
+			if ( vertices )
+				WriteVertices( vertices );
+			m_ring.Flush();
+			m_BaseVertex = offset / VERTEX_SIZE;
+		}
+		else
+		{
+			WriteVertices( m_Vertices.data() );
+			m_vb.SetData( m_Vertices.data(), size );
+			m_BaseVertex = 0;
+		}
+	}
+
+	void TestStreamingSprites::OnRender()
+	{
+		m_renderer.Clear();
+
+		if ( m_VertexPulling )
+		{
+			m_sprites->End( m_renderer, m_proj, m_texture );
+			return;
+		}
+
+		m_texture.Bind();
+		m_renderer.Draw( m_UseRingBuffer ? m_ringVa : m_va, m_ib, m_shader, m_SpriteCount * 6, 0, m_BaseVertex );
+
+		if ( m_UseRingBuffer )
+			m_ring.EndFrame();
+	}
+
+	void TestStreamingSprites::OnImGuiRender()
+	{
+		ImGui::SliderInt( "Sprites", &m_SpriteCount, 1, MAX_SPRITES );
+		if ( m_sprites )
+			ImGui::Checkbox( "Vertex pulling", &m_VertexPulling );
+		else
+			ImGui::Text( "Vertex pulling needs OpenGL 4.3" );
+		if ( m_VertexPulling )
+		{
+			ImGui::Text( "No vertex buffer, %u bytes per sprite, %u KB per frame",
+						 (unsigned int) sizeof( SpriteRecord ), m_sprites->GetUploadSize() / 1024 );
+			return;
+		}
+
+		ImGui::Checkbox( "Streaming ring buffer", &m_UseRingBuffer );
+		if ( m_UseRingBuffer )
+		{
+			ImGui::Text( "%s mapping, %u regions of %u KB, %u stalls",
+						 m_ring.IsPersistent() ? "Persistent" : "Per frame", m_ring.GetRegionCount(), m_ring.GetRegionSize() / 1024, m_ring.GetStallCount() );
+		}
+		else
+		{
+			ImGui::Text( "Orphaned vertex buffer, %u KB per frame", m_vb.GetSize() / 1024 );
+		}
+	}
+}
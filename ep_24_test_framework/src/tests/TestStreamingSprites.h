@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../VertexArray.h"
+#include "../VertexBuffer.h"
+#include "../IndexBuffer.h"
+#include "../StreamingRingBuffer.h"
+#include "../SpriteRenderer.h"
+#include "../Shader.h"
+#include "../Texture.h"
+#include "../Renderer.h"
+
+#include <memory>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+namespace test
+{
+	class TestStreamingSprites : public Test
+	{
+	public:
+		TestStreamingSprites();
+		~TestStreamingSprites();
+
+		void OnUpdate( float deltaTime ) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		void WriteVertices( float* vertices ) const;
+
+		// Data members.
+		std::vector< glm::vec2 > m_SpritePositions;
+		std::vector< glm::vec2 > m_SpriteVelocities;
+		std::vector< float > m_Vertices;
+		int m_SpriteCount;
+		bool m_UseRingBuffer;
+		bool m_VertexPulling;
+		int m_BaseVertex;
+
+		// OpenGL members.
+		VertexArray m_ringVa;
+		VertexArray m_va;
+		IndexBuffer m_ib;
+		VertexBuffer m_vb;
+		StreamingRingBuffer m_ring;
+		// Vertex pulling path, GL 4.3.
+		std::unique_ptr< SpriteRenderer > m_sprites;
+		VertexBufferLayout m_layout;
+		Shader m_shader;
+		Texture m_texture;
+		Renderer m_renderer;
+
+		// MVP members.
+		glm::mat4 m_proj;
+	};
+}
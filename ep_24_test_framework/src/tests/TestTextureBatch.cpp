@@ -0,0 +1,118 @@
+#include "TestTextureBatch.h"
+
+#include "../Debug.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+namespace test
+{
+	// Far more textures than any driver has texture units, all drawn by one call.
+	static const unsigned int TEXTURE_COUNT = 256;
+	static const int TEXTURE_SIZE = 64;
+	static const int COLUMNS = 32;
+	static const int ROWS = 24;
+	static const float QUAD_SIZE = 32.0f;
+
+	TestTextureBatch::TestTextureBatch() :
+		m_Bindless( TextureTable::IsBindlessSupported() ),
+		m_CurrentBindless( !m_Bindless ),
+		m_TextureUnits( 0 ),
+		m_va(),
+		m_layout(),
+		m_renderer(),
+		m_proj( glm::ortho( 0.0f, 1024.0f, 0.0f, 768.0f, -1.0f, 1.0f ) )
+	{
+		GLCall( glGetIntegerv( GL_MAX_TEXTURE_IMAGE_UNITS, &m_TextureUnits ) );
+
+		// One sample image followed by generated checkerboards of different colors and sizes.
+		m_textures.reserve( TEXTURE_COUNT );
+		m_textures.emplace_back( "res/textures/phone.png" );
+		std::vector< unsigned char > pixels( TEXTURE_SIZE * TEXTURE_SIZE * 4 );
+		for ( unsigned int i = 1; i < TEXTURE_COUNT; i++ )
+		{
+			const int checker = 4 + i % 13;
+			for ( int y = 0; y < TEXTURE_SIZE; y++ )
+			{
+				for ( int x = 0; x < TEXTURE_SIZE; x++ )
+				{
+					unsigned char* pixel = &pixels[( y * TEXTURE_SIZE + x ) * 4];
+					const bool odd = ( ( x / checker + y / checker ) % 2 ) != 0;
+					pixel[0] = (unsigned char) ( odd ? i * 37 : 255 - i * 11 );
+					pixel[1] = (unsigned char) ( odd ? i * 91 : i * 53 );
+					pixel[2] = (unsigned char) ( odd ? 255 - i * 7 : i * 29 );
+					pixel[3] = 255;
+				}
+			}
+			m_textures.emplace_back( TEXTURE_SIZE, TEXTURE_SIZE, GL_RGBA8, pixels.data() );
+		}
+
+		// A grid of quads, every quad picks its texture with a per vertex index.
+		for ( int row = 0; row < ROWS; row++ )
+		{
+			for ( int column = 0; column < COLUMNS; column++ )
+			{
+				const float x = column * QUAD_SIZE, y = row * QUAD_SIZE;
+				const unsigned int index = ( row * COLUMNS + column ) % TEXTURE_COUNT;
+				const unsigned int first = (unsigned int) m_Vertices.size();
+				m_Vertices.push_back( { { x, y }, { 0.0f, 0.0f }, index } );
+				m_Vertices.push_back( { { x + QUAD_SIZE, y }, { 1.0f, 0.0f }, index } );
+				m_Vertices.push_back( { { x + QUAD_SIZE, y + QUAD_SIZE }, { 1.0f, 1.0f }, index } );
+				m_Vertices.push_back( { { x, y + QUAD_SIZE }, { 0.0f, 1.0f }, index } );
+				m_Indices.insert( m_Indices.end(), { first, first + 1, first + 2, first + 2, first + 3, first } );
+			}
+		}
+
+		m_vb = std::make_unique< VertexBuffer >( m_Vertices.data(), (unsigned int) ( m_Vertices.size() * sizeof( BatchVertex ) ) );
+		m_ib = std::make_unique< IndexBuffer >( m_Indices.data(), (unsigned int) m_Indices.size() );
+		m_layout.Push< float >( 2 );
+		m_layout.Push< float >( 2 );
+		m_layout.Push< unsigned int >( 1 );
+		m_va.AddBuffer( *m_vb, m_layout );
+	}
+
+	TestTextureBatch::~TestTextureBatch()
+	{
+		m_va.Unbind();
+		m_vb->Unbind();
+		m_ib->Unbind();
+	}
+
+	void TestTextureBatch::CreateTable()
+	{
+		m_table.reset();
+		m_table = std::make_unique< TextureTable >( TEXTURE_COUNT, TEXTURE_SIZE, TEXTURE_SIZE, m_Bindless );
+		for ( auto& texture : m_textures )
+			m_table->Add( texture );
+
+		m_shader = std::make_unique< Shader >( "res/shaders/Batch.shader", m_table->GetShaderDefines() );
+		m_shader->Bind();
+		m_shader->SetUniformMat4f( "u_MVP", m_proj );
+		m_CurrentBindless = m_Bindless;
+	}
+
+	void TestTextureBatch::OnUpdate( float deltaTime )
+	{
+		if ( m_CurrentBindless != m_Bindless )
+			CreateTable();
+	}
+
+	void TestTextureBatch::OnRender()
+	{
+		m_renderer.Clear();
+
+		m_table->Bind( *m_shader );
+		m_renderer.Draw( m_va, *m_ib, *m_shader );
+	}
+
+	void TestTextureBatch::OnImGuiRender()
+	{
+		if ( TextureTable::IsBindlessSupported() )
+			ImGui::Checkbox( "Bindless textures", &m_Bindless );
+		else
+			ImGui::Text( "ARB_bindless_texture not supported, using a texture array" );
+
+		ImGui::Text( "%u textures in one draw call, %d texture units", m_table->GetCount(), m_TextureUnits );
+		ImGui::Text( "Mode: %s", m_table->IsBindless() ? "bindless handles" : "texture array" );
+	}
+}
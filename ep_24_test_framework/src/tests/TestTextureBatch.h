@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../VertexArray.h"
+#include "../VertexBuffer.h"
+#include "../IndexBuffer.h"
+#include "../Shader.h"
+#include "../Texture.h"
+#include "../TextureTable.h"
+#include "../Renderer.h"
+
+#include <memory>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+namespace test
+{
+	class TestTextureBatch : public Test
+	{
+	public:
+		TestTextureBatch();
+		~TestTextureBatch();
+
+		void OnUpdate( float deltaTime ) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		void CreateTable();
+
+		// Data members.
+		struct BatchVertex
+		{
+			float Position[2];
+			float TexCoord[2];
+			// Integer attribute, the texture index is used as is.
+			unsigned int TexIndex;
+		};
+		std::vector< BatchVertex > m_Vertices;
+		std::vector< unsigned int > m_Indices;
+		bool m_Bindless;
+		bool m_CurrentBindless;
+		int m_TextureUnits;
+
+		// OpenGL members.
+		VertexArray m_va;
+		std::unique_ptr< IndexBuffer > m_ib;
+		std::unique_ptr< VertexBuffer > m_vb;
+		VertexBufferLayout m_layout;
+		std::vector< Texture > m_textures;
+		std::unique_ptr< TextureTable > m_table;
+		std::unique_ptr< Shader > m_shader;
+		Renderer m_renderer;
+
+		// MVP members.
+		glm::mat4 m_proj;
+	};
+}
@@ -0,0 +1,107 @@
+#include "TestTextureStreaming.h"
+
+#include "../Debug.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+namespace test
+{
+	static const int RESOLUTIONS[][2] = { { 1280, 720 }, { 1920, 1080 }, { 3840, 2160 } };
+
+	// The generated pattern repeats every PATTERN_PERIOD rows, so a frame is just
+	// a window into the precomputed rows and producing it costs nothing.
+	static const int PATTERN_PERIOD = 256;
+
+	TestTextureStreaming::TestTextureStreaming() :
+		m_Positions{
+			   0.0f,   0.0f, 0.0f, 0.0f, // 0
+			1024.0f,   0.0f, 1.0f, 0.0f, // 1
+			1024.0f, 768.0f, 1.0f, 1.0f, // 2
+			   0.0f, 768.0f, 0.0f, 1.0f  // 3
+		},
+		m_Indices{
+			0, 1, 2,
+			2, 3, 0
+		},
+		m_Resolution( 2 ),
+		m_CurrentResolution( -1 ),
+		m_Async( true ),
+		m_Frame( 0 ),
+		m_va(),
+		m_ib( m_Indices, 6 ),
+		m_vb( m_Positions, 4 * 4 * sizeof( float ) ),
+		m_layout(),
+		m_shader( "res/shaders/Complex.shader" ),
+		m_renderer(),
+		m_proj( glm::ortho( 0.0f, 1024.0f, 0.0f, 768.0f, -1.0f, 1.0f ) )
+	{
+		m_layout.Push< float >( 2 );
+		m_layout.Push< float >( 2 );
+		m_va.AddBuffer( m_vb, m_layout );
+
+		m_shader.Bind();
+		m_shader.SetUniform1i( "u_Texture", 0 );
+		m_shader.SetUniformMat4f( "u_MVP", m_proj );
+	}
+
+	TestTextureStreaming::~TestTextureStreaming()
+	{
+		m_va.Unbind();
+		m_shader.Unbind();
+		m_vb.Unbind();
+		m_ib.Unbind();
+	}
+
+	void TestTextureStreaming::CreateFrames( int width, int height )
+	{
+		m_Frames.resize( (size_t) width * ( height + PATTERN_PERIOD ) * 4 );
+		for ( int y = 0; y < height + PATTERN_PERIOD; y++ )
+		{
+			unsigned char* row = &m_Frames[(size_t) y * width * 4];
+			const int py = y % PATTERN_PERIOD;
+			for ( int x = 0; x < width; x++ )
+			{
+				row[x * 4 + 0] = (unsigned char) ( x * 255 / width );
+				row[x * 4 + 1] = (unsigned char) py;
+				row[x * 4 + 2] = ( ( x / 64 + py / 64 ) % 2 ) ? 255 : 64;
+				row[x * 4 + 3] = 255;
+			}
+		}
+	}
+
+	void TestTextureStreaming::OnUpdate( float deltaTime )
+	{
+		const int width = RESOLUTIONS[m_Resolution][0];
+		const int height = RESOLUTIONS[m_Resolution][1];
+		if ( m_CurrentResolution != m_Resolution )
+		{
+			CreateFrames( width, height );
+			m_texture = std::make_unique< Texture >( width, height, GL_RGBA8 );
+			m_CurrentResolution = m_Resolution;
+		}
+
+		// Same storage every frame, only the contents change.
+		const unsigned char* frame = &m_Frames[(size_t) ( m_Frame++ % PATTERN_PERIOD ) * width * 4];
+		if ( m_Async )
+			m_texture->UpdateAsync( 0, 0, width, height, frame );
+		else
+			m_texture->Update( 0, 0, width, height, frame );
+	}
+
+	void TestTextureStreaming::OnRender()
+	{
+		m_renderer.Clear();
+
+		m_texture->Bind();
+		m_renderer.Draw( m_va, m_ib, m_shader );
+	}
+
+	void TestTextureStreaming::OnImGuiRender()
+	{
+		ImGui::RadioButton( "720p", &m_Resolution, 0 ); ImGui::SameLine();
+		ImGui::RadioButton( "1080p", &m_Resolution, 1 ); ImGui::SameLine();
+		ImGui::RadioButton( "4K", &m_Resolution, 2 );
+		ImGui::Checkbox( "Upload through pixel buffer", &m_Async );
+	}
+}
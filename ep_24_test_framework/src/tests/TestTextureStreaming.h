@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../VertexArray.h"
+#include "../VertexBuffer.h"
+#include "../IndexBuffer.h"
+#include "../Shader.h"
+#include "../Texture.h"
+#include "../Renderer.h"
+
+#include <memory>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+namespace test
+{
+	class TestTextureStreaming : public Test
+	{
+	public:
+		TestTextureStreaming();
+		~TestTextureStreaming();
+
+		void OnUpdate( float deltaTime ) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		void CreateFrames( int width, int height );
+
+		// Data members.
+		float m_Positions[16];
+		unsigned int m_Indices[6];
+		int m_Resolution;
+		int m_CurrentResolution;
+		bool m_Async;
+		unsigned int m_Frame;
+		std::vector< unsigned char > m_Frames;
+
+		// OpenGL members.
+		VertexArray m_va;
+		IndexBuffer m_ib;
+		VertexBuffer m_vb;
+		VertexBufferLayout m_layout;
+		Shader m_shader;
+		std::unique_ptr< Texture > m_texture;
+		Renderer m_renderer;
+
+		// MVP members.
+		glm::mat4 m_proj;
+	};
+}
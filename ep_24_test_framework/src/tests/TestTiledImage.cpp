@@ -0,0 +1,108 @@
+#include "TestTiledImage.h"
+
+#include "../TextureCooker.h"
+#include "../Debug.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+namespace test
+{
+	static const char* SOURCE_PATH = "res/textures/phone.png";
+	static const char* TILED_PATH = "res/textures/phone.tiles";
+
+	// Small tiles and a small atlas so streaming is visible with the sample image.
+	static const unsigned int TILE_SIZE = 60;
+	static const unsigned int ATLAS_SLOTS = 6;
+
+	TestTiledImage::TestTiledImage() :
+		m_Indices{
+			0, 1, 2,
+			2, 3, 0
+		},
+		m_Zoom( 1.0f ),
+		m_Center( 0.0f ),
+		m_va(),
+		m_ib( m_Indices, 6 ),
+		m_layout(),
+		m_shader( "res/shaders/TiledImage.shader" ),
+		m_feedbackShader( "res/shaders/TiledImageFeedback.shader" ),
+		m_renderer(),
+		m_proj( glm::ortho( 0.0f, 1024.0f, 0.0f, 768.0f, -1.0f, 1.0f ) ),
+		m_view( 1.0f )
+	{
+		if ( !TiledImage( TILED_PATH ).IsValid() )
+			cooker::CookTiledImage( SOURCE_PATH, TILED_PATH, TILE_SIZE );
+		m_image = std::make_unique< TiledTexture >( TILED_PATH, ATLAS_SLOTS, 256, 192 );
+
+		// The quad covers the image in image pixels.
+		const float width = m_image->IsValid() ? (float) m_image->GetWidth() : 1.0f;
+		const float height = m_image->IsValid() ? (float) m_image->GetHeight() : 1.0f;
+		const float positions[16] = {
+			 0.0f,   0.0f, 0.0f, 0.0f, // 0
+			width,   0.0f, 1.0f, 0.0f, // 1
+			width, height, 1.0f, 1.0f, // 2
+			 0.0f, height, 0.0f, 1.0f  // 3
+		};
+		m_Center = glm::vec2( width, height ) * 0.5f;
+
+		m_vb = std::make_unique< VertexBuffer >( positions, 4 * 4 * sizeof( float ) );
+		m_layout.Push< float >( 2 );
+		m_layout.Push< float >( 2 );
+		m_va.AddBuffer( *m_vb, m_layout );
+	}
+
+	TestTiledImage::~TestTiledImage()
+	{
+		m_va.Unbind();
+		m_shader.Unbind();
+		m_vb->Unbind();
+		m_ib.Unbind();
+	}
+
+	void TestTiledImage::OnUpdate( float deltaTime )
+	{
+		m_view = glm::translate( glm::mat4( 1.0f ), glm::vec3( 512.0f, 384.0f, 0.0f ) );
+		m_view = glm::scale( m_view, glm::vec3( m_Zoom, m_Zoom, 1.0f ) );
+		m_view = glm::translate( m_view, glm::vec3( -m_Center, 0.0f ) );
+
+		m_image->Update();
+	}
+
+	void TestTiledImage::OnRender()
+	{
+		m_renderer.Clear();
+		if ( !m_image->IsValid() )
+			return;
+
+		const glm::mat4 mvp = m_proj * m_view;
+
+		// Feedback pass: which tiles at which level does this view need?
+		m_image->BeginFeedback();
+		m_feedbackShader.Bind();
+		m_feedbackShader.SetUniformMat4f( "u_MVP", mvp );
+		m_image->SetFeedbackUniforms( m_feedbackShader );
+		m_renderer.Draw( m_va, m_ib, m_feedbackShader );
+		m_image->EndFeedback();
+
+		m_shader.Bind();
+		m_shader.SetUniformMat4f( "u_MVP", mvp );
+		m_image->SetUniforms( m_shader );
+		m_renderer.Draw( m_va, m_ib, m_shader );
+	}
+
+	void TestTiledImage::OnImGuiRender()
+	{
+		if ( !m_image->IsValid() )
+		{
+			ImGui::Text( "Could not open %s", TILED_PATH );
+			return;
+		}
+
+		ImGui::SliderFloat( "Zoom", &m_Zoom, 0.05f, 16.0f, "%.2f", 2.0f );
+		ImGui::SliderFloat( "Center x", &m_Center.x, 0.0f, (float) m_image->GetWidth() );
+		ImGui::SliderFloat( "Center y", &m_Center.y, 0.0f, (float) m_image->GetHeight() );
+		ImGui::Text( "Resident tiles %d / %d", (int) m_image->GetResidentTileCount(), (int) m_image->GetSlotCount() );
+		ImGui::Text( "Visible tiles %d, streaming %d, uploads %u", (int) m_image->GetRequestedTileCount(), (int) m_image->GetPendingTileCount(), m_image->GetUploadCount() );
+	}
+}
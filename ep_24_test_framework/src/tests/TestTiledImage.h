@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../VertexArray.h"
+#include "../VertexBuffer.h"
+#include "../IndexBuffer.h"
+#include "../Shader.h"
+#include "../TiledTexture.h"
+#include "../Renderer.h"
+
+#include <memory>
+
+#include "glm/glm.hpp"
+
+namespace test
+{
+	class TestTiledImage : public Test
+	{
+	public:
+		TestTiledImage();
+		~TestTiledImage();
+
+		void OnUpdate( float deltaTime ) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		// Data members.
+		unsigned int m_Indices[6];
+		float m_Zoom;
+		glm::vec2 m_Center;
+
+		// OpenGL members.
+		VertexArray m_va;
+		IndexBuffer m_ib;
+		std::unique_ptr< VertexBuffer > m_vb;
+		VertexBufferLayout m_layout;
+		Shader m_shader;
+		Shader m_feedbackShader;
+		std::unique_ptr< TiledTexture > m_image;
+		Renderer m_renderer;
+
+		// MVP members.
+		glm::mat4 m_proj;
+		glm::mat4 m_view;
+	};
+}
@@ -0,0 +1,95 @@
+#include "TestVertexStreams.h"
+
+#include "../Debug.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <vector>
+
+namespace test
+{
+	static const int QUADS_X = 12;
+	static const int QUADS_Y = 8;
+	static const float QUAD_SIZE = 60.0f;
+
+	TestVertexStreams::TestVertexStreams() :
+		m_Shadows( true ),
+		m_ShadowOffset{ 8.0f, -8.0f },
+		m_VertexCount( 0 ),
+		m_va(),
+		m_shadowVa(),
+		m_shader( "res/shaders/Complex.shader" ),
+		m_shadowShader( "res/shaders/Flat.shader" ),
+		m_texture( "res/textures/phone.png" ),
+		m_renderer(),
+		m_proj( glm::ortho( 0.0f, 1024.0f, 0.0f, 768.0f, -1.0f, 1.0f ) )
+	{
+		std::vector< float > positions, texCoords;
+		std::vector< unsigned int > indices;
+		for ( int y = 0; y < QUADS_Y; y++ )
+		{
+			for ( int x = 0; x < QUADS_X; x++ )
+			{
+				const float px = 100.0f + x * ( QUAD_SIZE + 12.0f ), py = 120.0f + y * ( QUAD_SIZE + 12.0f );
+				const unsigned int first = (unsigned int) positions.size() / 2;
+				positions.insert( positions.end(), { px, py, px + QUAD_SIZE, py, px + QUAD_SIZE, py + QUAD_SIZE, px, py + QUAD_SIZE } );
+				texCoords.insert( texCoords.end(), { 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f } );
+				indices.insert( indices.end(), { first, first + 1, first + 2, first + 2, first + 3, first } );
+			}
+		}
+		m_VertexCount = (unsigned int) positions.size() / 2;
+
+		m_positions = std::make_unique< VertexBuffer >( positions.data(), (unsigned int) ( positions.size() * sizeof( float ) ) );
+		m_texCoords = std::make_unique< VertexBuffer >( texCoords.data(), (unsigned int) ( texCoords.size() * sizeof( float ) ) );
+		m_ib = std::make_unique< IndexBuffer >( indices.data(), (unsigned int) indices.size() );
+
+		VertexBufferLayout positionLayout;
+		positionLayout.Push< float >( 2 );
+		VertexBufferLayout texCoordLayout;
+		texCoordLayout.Push< float >( 2 );
+
+		// Stream 0 feeds location 0, stream 1 feeds location 1.
+		m_va.AddBuffer( *m_positions, positionLayout, 0, 0 );
+		m_va.AddBuffer( *m_texCoords, texCoordLayout, 1, 1 );
+		m_shadowVa.AddBuffer( *m_positions, positionLayout, 0, 0 );
+
+		m_shader.Bind();
+		m_shader.SetUniform1i( "u_Texture", 0 );
+		m_shadowShader.Bind();
+		m_shadowShader.SetUniform4f( "u_Color", 0.0f, 0.0f, 0.0f, 0.5f );
+	}
+
+	TestVertexStreams::~TestVertexStreams()
+	{
+		m_va.Unbind();
+		m_shader.Unbind();
+		m_ib->Unbind();
+	}
+
+	void TestVertexStreams::OnRender()
+	{
+		m_renderer.Clear();
+
+		if ( m_Shadows )
+		{
+			const glm::mat4 model = glm::translate( glm::mat4( 1.0f ), glm::vec3( m_ShadowOffset[0], m_ShadowOffset[1], 0.0f ) );
+			m_shadowShader.Bind();
+			m_shadowShader.SetUniformMat4f( "u_MVP", m_proj * model );
+			m_renderer.Draw( m_shadowVa, *m_ib, m_shadowShader );
+		}
+
+		m_texture.Bind();
+		m_shader.Bind();
+		m_shader.SetUniformMat4f( "u_MVP", m_proj );
+		m_renderer.Draw( m_va, *m_ib, m_shader );
+	}
+
+	void TestVertexStreams::OnImGuiRender()
+	{
+		ImGui::Checkbox( "Shadow pass", &m_Shadows );
+		ImGui::SliderFloat2( "Shadow offset", m_ShadowOffset, -20.0f, 20.0f );
+		ImGui::Text( "Shadow pass fetches %u bytes per vertex, color pass %u", 2 * (unsigned int) sizeof( float ), 4 * (unsigned int) sizeof( float ) );
+		ImGui::Text( "%u vertices, attribute binding %s", m_VertexCount, GLEW_ARB_vertex_attrib_binding ? "supported" : "emulated" );
+	}
+}
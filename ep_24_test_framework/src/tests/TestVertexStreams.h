@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../VertexArray.h"
+#include "../VertexBuffer.h"
+#include "../VertexBufferLayout.h"
+#include "../IndexBuffer.h"
+#include "../Shader.h"
+#include "../Texture.h"
+#include "../Renderer.h"
+
+#include <memory>
+
+#include "glm/glm.hpp"
+
+namespace test
+{
+	class TestVertexStreams : public Test
+	{
+	public:
+		TestVertexStreams();
+		~TestVertexStreams();
+
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		// Data members.
+		bool m_Shadows;
+		float m_ShadowOffset[2];
+		unsigned int m_VertexCount;
+
+		// OpenGL members.
+		// Positions and texture coordinates live in separate buffers, the shadow
+		// pass vertex array only holds the position stream.
+		VertexArray m_va;
+		VertexArray m_shadowVa;
+		std::unique_ptr< VertexBuffer > m_positions;
+		std::unique_ptr< VertexBuffer > m_texCoords;
+		std::unique_ptr< IndexBuffer > m_ib;
+		Shader m_shader;
+		Shader m_shadowShader;
+		Texture m_texture;
+		Renderer m_renderer;
+
+		// MVP members.
+		glm::mat4 m_proj;
+	};
+}